@@ -14,15 +14,29 @@ bool dz_bode_parse_range(char *str, double *from, double *to, double *d)
   return true;
 }
 
-void dz_bode_output(FILE *fp, dzTF *tf, double from, double to, double d)
+bool dz_bode_output(FILE *fp, dzTF *tf, double from, double to, double d)
 {
-  double frq;
-  dzFreqRes fr;
+  double frq, *af, *g, *p;
+  int i, n;
+  bool ret = false;
 
-  for( frq=from; frq<to; frq*=d ){
-    dzFreqResFromTF( &fr, tf, 2*zPI*frq );
-    fprintf( fp, "%f %f %f\n", frq, fr.g, fr.p );
+  for( n=0, frq=from; frq<to; frq*=d ) n++;
+  af = zAlloc( double, n );
+  g = zAlloc( double, n );
+  p = zAlloc( double, n );
+  if( !af || !g || !p ){
+    ZALLOCERROR();
+    goto TERMINATE;
   }
+  for( i=0, frq=from; i<n; i++, frq*=d ) af[i] = 2*zPI*frq;
+  if( !( ret = dzFreqResGridFromTF( tf, af, n, g, p ) ) ) goto TERMINATE;
+  for( i=0; i<n; i++ )
+    fprintf( fp, "%f %f %f\n", af[i]/(2*zPI), g[i], p[i] );
+ TERMINATE:
+  zFree( af );
+  zFree( g );
+  zFree( p );
+  return ret;
 }
 
 void dz_bode_script(FILE *fp, char *logfile, double from, double to)
@@ -100,7 +114,11 @@ int main(int argc, char *argv[])
   dz_bode_parse_range( opt[OPT_RANGE].arg, &from, &to, &d );
 
   fp = fopen( opt[OPT_OUTPUTFILE].arg, "w" );
-  dz_bode_output( fp, &tf, from, to, d );
+  if( !dz_bode_output( fp, &tf, from, to, d ) ){
+    fclose( fp );
+    dzTFDestroy( &tf );
+    return 1;
+  }
   fclose( fp );
 
   dzTFDestroy( &tf );
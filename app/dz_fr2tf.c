@@ -62,7 +62,7 @@ bool dz_fr2tf_command_arg(int argc, char *argv[])
 
 int main(int argc, char *argv[])
 {
-  dzFreqResList freq_res_list;
+  dzFreqResArray freq_res_array;
   dzTF tf;
   double fmin, fmax;
 
@@ -70,11 +70,15 @@ int main(int argc, char *argv[])
   if( !dz_fr2tf_command_arg( argc, argv ) ) return EXIT_FAILURE;
   dz_fr2tf_parse_range( opt[OPT_RANGE].arg, &fmin, &fmax );
 
-  if( dzFreqResListScanFile( &freq_res_list, opt[OPT_FRFILE].arg, fmin, fmax ) == 0 )
+  dzFreqResArrayInit( &freq_res_array );
+  if( dzFreqResArrayScanFile( &freq_res_array, opt[OPT_FRFILE].arg, fmin, fmax ) == 0 )
     return EXIT_FAILURE;
-  dzTFIdentFromFreqRes( &tf, &freq_res_list, atoi(opt[OPT_DIM_NUM].arg), atoi(opt[OPT_DIM_DEN].arg), atoi(opt[OPT_ITER].arg) );
+  if( !dzTFIdentFromFreqResArray( &tf, &freq_res_array, atoi(opt[OPT_DIM_NUM].arg), atoi(opt[OPT_DIM_DEN].arg), atoi(opt[OPT_ITER].arg) ) ){
+    dzFreqResArrayDestroy( &freq_res_array );
+    return EXIT_FAILURE;
+  }
   dzTFWriteZTK( &tf, opt[OPT_TFFILE].arg );
   dzTFDestroy( &tf );
-  dzFreqResListDestroy( &freq_res_list );
+  dzFreqResArrayDestroy( &freq_res_array );
   return EXIT_SUCCESS;
 }
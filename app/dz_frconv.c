@@ -59,42 +59,45 @@ bool dz_frconv_command_arg(int argc, char *argv[])
   return true;
 }
 
-void dz_frconv_operate(dzFreqResList *inlist, dzFreqResList *outlist, dzTF *tf)
+bool dz_frconv_operate(dzFreqResArray *arr, dzTF *tf)
 {
   if( strcmp( opt[OPT_OPERATE].arg, "open" ) == 0 ){
-    dzFreqResList2Open( inlist, outlist );
+    dzFreqResArray2Open( arr );
   } else
   if( strcmp( opt[OPT_OPERATE].arg, "close" ) == 0 ){
-    dzFreqResList2Closed( inlist, outlist );
+    dzFreqResArray2Closed( arr );
   } else
   if( strcmp( opt[OPT_OPERATE].arg, "connect" ) == 0 ){
     if( !opt[OPT_TF].flag ){
       ZRUNERROR( "transfer function not specified." );
-    } else{
-      dzFreqResListConnectTF( inlist, tf, outlist );
+      return false;
     }
+    if( !dzFreqResArrayConnectTF( arr, tf ) ) return false;
   }
+  return true;
 }
 
 int main(int argc, char *argv[])
 {
-  dzFreqResList fr_in_list, fr_out_list;
+  dzFreqResArray fr_array;
   dzTF tf;
   double fmin, fmax;
+  int ret = EXIT_FAILURE;
 
   if( argc < 2 ) dz_frconv_usage( argv[0] );
   if( !dz_frconv_command_arg( argc, argv ) ) return EXIT_FAILURE;
   dz_frconv_parse_range( opt[OPT_RANGE].arg, &fmin, &fmax );
 
-  if( dzFreqResListScanFile( &fr_in_list, opt[OPT_INFILE].arg, fmin, fmax ) == 0 )
+  dzFreqResArrayInit( &fr_array );
+  if( dzFreqResArrayScanFile( &fr_array, opt[OPT_INFILE].arg, fmin, fmax ) == 0 )
     return EXIT_FAILURE;
-  if( opt[OPT_TF].flag && !dzTFReadZTK( &tf, opt[OPT_TF].arg ) ) return EXIT_FAILURE;
-  if( opt[OPT_OPERATE].flag )
-    dz_frconv_operate( &fr_in_list, &fr_out_list, &tf );
+  if( opt[OPT_TF].flag && !dzTFReadZTK( &tf, opt[OPT_TF].arg ) ) goto TERMINATE;
+  if( opt[OPT_OPERATE].flag && !dz_frconv_operate( &fr_array, &tf ) ) goto TERMINATE2;
+  if( dzFreqResArrayPrintFile( &fr_array, opt[OPT_OUTFILE].arg, fmin, fmax ) == 0 ) goto TERMINATE2;
+  ret = EXIT_SUCCESS;
+ TERMINATE2:
   if( opt[OPT_TF].flag ) dzTFDestroy( &tf );
-  if( dzFreqResListPrintFile( &fr_out_list, opt[OPT_OUTFILE].arg, fmin, fmax ) == 0 )
-    return EXIT_FAILURE;
-  dzFreqResListDestroy( &fr_in_list );
-  dzFreqResListDestroy( &fr_out_list );
-  return EXIT_SUCCESS;
+ TERMINATE:
+  dzFreqResArrayDestroy( &fr_array );
+  return ret;
 }
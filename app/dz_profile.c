@@ -0,0 +1,196 @@
+#include <dzco/dz_sys.h>
+
+enum{
+  OPT_SYSFILE=0, OPT_BINFILE,
+  OPT_DT, OPT_TICK, OPT_BUDGET, OPT_SORT,
+  OPT_DOTFILE, OPT_TRACEFILE,
+  OPT_HELP,
+  OPT_INVALID
+};
+zOption opt[] = {
+  { "s", "sys", "<.ztk file>", "system definition file", NULL, false },
+  { "b", "bin", "<binary file>", "binary image of systems made by dz_sys2bin", NULL, false },
+  { "dt", "dt", "<value>", "discretized time step", (char *)"0.001", false },
+  { "n", "tick", "<value>", "number of ticks", (char *)"10000", false },
+  { "budget", "budget", "<value>", "time budget of a tick in microseconds", (char *)"0", false },
+  { "sort", "sort", "<mean|p99|max>", "key to rank systems", (char *)"mean", false },
+  { "dot", "dot", "<DOT file>", "output a graph annotated with costs in DOT format", NULL, false },
+  { "trace", "trace", "<JSON file>", "output a trace of the latest ticks in Chrome trace event format", NULL, false },
+  { "h", "help", NULL, "show this message", NULL, false },
+  { NULL, NULL, NULL, NULL, NULL, false },
+};
+
+#define DZ_PROFILE_TRACE_NUM 100
+
+void dz_profile_usage(const char *arg)
+{
+  eprintf( "Usage: %s [option] <.ztk file>\n", arg );
+  eprintf( "<options>\n" );
+  zOptionHelp( opt );
+  eprintf( "Times are shown in nanoseconds.\n" );
+  exit( 0 );
+}
+
+bool dz_profile_commandarg(int argc, char *argv[])
+{
+  zStrAddrList arglist;
+
+  if( !zOptionRead( opt, argv, &arglist ) ) return false;
+  if( opt[OPT_HELP].flag ) dz_profile_usage( "dz_profile" );
+  if( !zListIsEmpty(&arglist) ){
+    opt[OPT_SYSFILE].flag = true;
+    opt[OPT_SYSFILE].arg  = zListTail(&arglist)->data;
+  }
+  zStrAddrListDestroy( &arglist );
+  if( !opt[OPT_SYSFILE].flag && !opt[OPT_BINFILE].flag ){
+    ZRUNERROR( "system not specified" );
+    return false;
+  }
+  return true;
+}
+
+/* estimated memory used by a system: the system itself, ports and
+ * the encoded size of its property. */
+size_t dz_profile_memsize(dzSys *sys)
+{
+  dzSysBin bin;
+  size_t size;
+
+  size = sizeof(dzSys) + sizeof(dzSysPort)*dzSysInputNum(sys) + sizeof(double)*dzSysOutputNum(sys);
+  dzSysBinInit( &bin );
+  if( dzSysEncode( sys, &bin ) ) size += bin.size;
+  dzSysBinDestroy( &bin );
+  return size;
+}
+
+/* ranking of systems */
+static dzSysProf *dz_profile_prof;
+
+double dz_profile_key(int i)
+{
+  dzSysHist *hist;
+
+  hist = dzSysProfBlock(dz_profile_prof,i);
+  if( strcmp( opt[OPT_SORT].arg, "p99" ) == 0 ) return dzSysHistPercentile( hist, 99 );
+  if( strcmp( opt[OPT_SORT].arg, "max" ) == 0 ) return dzSysHistMax(hist);
+  return dzSysHistMean(hist);
+}
+
+int dz_profile_cmp(const void *i1, const void *i2)
+{
+  double k1, k2;
+
+  k1 = dz_profile_key( *(int *)i1 );
+  k2 = dz_profile_key( *(int *)i2 );
+  return k1 < k2 ? 1 : ( k1 > k2 ? -1 : 0 );
+}
+
+bool dz_profile_rank(FILE *fp, dzSysArray *arr, dzSysProf *prof)
+{
+  dzSysHist *hist;
+  dzSys *sys;
+  int *rank, i;
+  double total;
+
+  if( !( rank = zAlloc( int, zArraySize(arr) ) ) ){
+    ZALLOCERROR();
+    return false;
+  }
+  for( i=0; i<zArraySize(arr); i++ ) rank[i] = i;
+  dz_profile_prof = prof;
+  qsort( rank, zArraySize(arr), sizeof(int), dz_profile_cmp );
+  hist = dzSysProfTick(prof);
+  total = hist->sum;
+  fprintf( fp, "ticks: %lu, %.0f ticks/s\n", dzSysHistCount(hist), total > 0 ? dzSysHistCount(hist) / total * 1.0e9 : 0 );
+  fprintf( fp, "tick latency: mean=%.0f p99=%.0f max=%.0f\n", dzSysHistMean(hist), dzSysHistPercentile(hist,99), dzSysHistMax(hist) );
+  if( dzSysProfBudget(prof) > 0 )
+    fprintf( fp, "budget: %.0f, overrun=%lu\n", dzSysProfBudget(prof), dzSysProfOverrunNum(prof) );
+  fprintf( fp, "%5s %-20s %-18s %10s %10s %10s %7s %8s %8s\n", "rank", "name", "type", "mean", "p99", "max", "share", "blame", "memory" );
+  for( i=0; i<zArraySize(arr); i++ ){
+    sys = zArrayElemNC(arr,rank[i]);
+    hist = dzSysProfBlock(prof,rank[i]);
+    fprintf( fp, "%5d %-20s %-18s %10.0f %10.0f %10.0f %6.2f%% %8lu %8lu\n", i+1,
+      zNamePtr(sys) ? zName(sys) : "-", sys->com->typestr,
+      dzSysHistMean(hist), dzSysHistPercentile(hist,99), dzSysHistMax(hist),
+      total > 0 ? hist->sum / total * 100 : 0, dzSysProfBlame(prof,rank[i]),
+      (unsigned long)dz_profile_memsize( sys ) );
+  }
+  zFree( rank );
+  return true;
+}
+
+/* graph annotated with costs, where hotter systems are filled with
+ * deeper red. */
+void dz_profile_dot(FILE *fp, dzSysArray *arr, dzSysProf *prof)
+{
+  dzSys *sys;
+  dzSysPort *sp;
+  double mean, maxmean = 0;
+  int i, j;
+
+  for( i=0; i<zArraySize(arr); i++ )
+    if( ( mean = dzSysHistMean(dzSysProfBlock(prof,i)) ) > maxmean ) maxmean = mean;
+  fprintf( fp, "digraph dzsys {\n" );
+  fprintf( fp, "  node [shape=box, style=filled];\n" );
+  for( i=0; i<zArraySize(arr); i++ ){
+    sys = zArrayElemNC(arr,i);
+    mean = dzSysHistMean(dzSysProfBlock(prof,i));
+    fprintf( fp, "  s%d [label=\"%s\\n%s\\nmean %.0f ns\\np99 %.0f ns\", fillcolor=\"0.000 %.3f 1.000\"];\n", i,
+      zNamePtr(sys) ? zName(sys) : "-", sys->com->typestr,
+      mean, dzSysHistPercentile(dzSysProfBlock(prof,i),99), maxmean > 0 ? mean / maxmean : 0 );
+  }
+  for( i=0; i<zArraySize(arr); i++ ){
+    sys = zArrayElemNC(arr,i);
+    for( j=0; j<dzSysInputNum(sys); j++ )
+      if( ( sp = dzSysInputElem(sys,j) )->sp && sp->sp >= zArrayElemNC(arr,0) && sp->sp - zArrayElemNC(arr,0) < zArraySize(arr) )
+        fprintf( fp, "  s%d -> s%d [label=\"%d:%d\"];\n", (int)( sp->sp - zArrayElemNC(arr,0) ), i, sp->port, j );
+  }
+  fprintf( fp, "}\n" );
+}
+
+int main(int argc, char *argv[])
+{
+  dzSysArray arr;
+  dzSysPlan plan;
+  dzSysProf prof;
+  double dt;
+  int i, n;
+  FILE *fp;
+  int ret = 1;
+
+  if( argc < 2 ) dz_profile_usage( argv[0] );
+  if( !dz_profile_commandarg( argc, argv+1 ) ) return 1;
+  if( opt[OPT_BINFILE].flag ){
+    if( !dzSysArrayReadBin( &arr, opt[OPT_BINFILE].arg ) ) return 1;
+  } else{
+    if( !dzSysArrayReadZTK( &arr, opt[OPT_SYSFILE].arg ) ) return 1;
+  }
+  if( zIsTiny( ( dt = atof( opt[OPT_DT].arg ) ) ) ){
+    ZRUNERROR( "too small discrete time step %g", dt );
+    goto TERMINATE;
+  }
+  n = atoi( opt[OPT_TICK].arg );
+  if( !dzSysPlanCreate( &plan, &arr ) ) goto TERMINATE;
+  if( !dzSysProfCreate( &prof, &arr, opt[OPT_TRACEFILE].flag ? DZ_PROFILE_TRACE_NUM : 0 ) ) goto TERMINATE2;
+  dzSysProfSetBudget( &prof, atof( opt[OPT_BUDGET].arg ) * 1.0e3 );
+  for( i=0; i<n; i++ )
+    dzSysProfPlanUpdate( &prof, &plan, dt );
+  if( !dz_profile_rank( stdout, &arr, &prof ) ) goto TERMINATE3;
+  if( opt[OPT_DOTFILE].flag ){
+    if( !( fp = fopen( opt[OPT_DOTFILE].arg, "w" ) ) ){
+      ZOPENERROR( opt[OPT_DOTFILE].arg );
+      goto TERMINATE3;
+    }
+    dz_profile_dot( fp, &arr, &prof );
+    fclose( fp );
+  }
+  if( opt[OPT_TRACEFILE].flag && !dzSysProfWriteTrace( &prof, opt[OPT_TRACEFILE].arg ) ) goto TERMINATE3;
+  ret = 0;
+ TERMINATE3:
+  dzSysProfDestroy( &prof );
+ TERMINATE2:
+  dzSysPlanDestroy( &plan );
+ TERMINATE:
+  dzSysArrayDestroy( &arr );
+  return ret;
+}
@@ -4,6 +4,7 @@ enum{
   OPT_SYSFILE=0, OPT_OUTPUTFILE, OPT_SCRIPTFILE,
   OPT_DT, OPT_T,
   OPT_OUTSYS,
+  OPT_ENSNUM, OPT_PERTURB, OPT_THREADNUM,
   OPT_HELP,
   OPT_INVALID
 };
@@ -14,6 +15,9 @@ zOption opt[] = {
   { "dt", "dt", "<value>", "discretized time step", (char *)"0.001", false },
   { "t",  "t", "<value>", "total simulation time", (char *)"1.0", false },
   { "os", "outsys", "<name>", "the name of output system", NULL, false },
+  { "ens", "ensemble", "<value>", "number of instances of Monte Carlo simulation", (char *)"0", false },
+  { "perturb", "perturb", "<name:index:ratio,...>", "perturbation of parameters of instances", NULL, false },
+  { "thread", "thread", "<value>", "number of threads for Monte Carlo simulation (0 for all processors)", (char *)"0", false },
   { "h", "help", NULL, "show this message", NULL, false },
   { NULL, NULL, NULL, NULL, NULL, false },
 };
@@ -24,6 +28,10 @@ void dz_sim_usage(const char *arg)
   eprintf( "<options>\n" );
   zOptionHelp( opt );
   eprintf( "In order to plot the result, execute gnuplot and load the script file.\n" );
+  eprintf( "With -ens option, the final values, the peak values and ISE of outputs of\n" );
+  eprintf( "perturbed instances are output instead of the trajectory. A perturbation\n" );
+  eprintf( "name:index:ratio multiplies the index-th parameter of the system by a\n" );
+  eprintf( "random factor in [1-ratio,1+ratio].\n" );
   exit( 0 );
 }
 
@@ -47,6 +55,7 @@ bool dz_sim_commandarg(int argc, char *argv[])
 
 bool dz_sim_output(FILE *fp, dzSysArray *arr)
 {
+  dzSysPlan plan;
   double dt, t, term;
   dzSys *sys_out;
   int i;
@@ -59,16 +68,89 @@ bool dz_sim_output(FILE *fp, dzSysArray *arr)
   if( !opt[OPT_OUTSYS].arg ||
       !( sys_out = dzSysArrayNameFind( arr, opt[OPT_OUTSYS].arg ) ) )
     sys_out = zArrayHead( arr );
+  if( !dzSysPlanCreate( &plan, arr ) ) return false;
   for( t=0; t<=term; t+=dt ){
-    dzSysArrayUpdate( arr, dt );
+    dzSysPlanUpdate( &plan, dt );
     fprintf( fp, "%g", t );
     for( i=0; i<dzSysOutputNum(sys_out); i++ )
       fprintf( fp, " %g", dzSysOutputVal(sys_out,i) );
     fprintf( fp, "\n" );
   }
+  dzSysPlanDestroy( &plan );
   return true;
 }
 
+/* perturbation of a parameter */
+typedef struct{
+  char name[256];
+  int index;
+  double ratio;
+} dz_sim_perturb_t;
+
+int dz_sim_perturb_num;
+dz_sim_perturb_t *dz_sim_perturb_list;
+
+bool dz_sim_perturb_parse(char *str)
+{
+  char *cp;
+  int i;
+
+  for( dz_sim_perturb_num=1, cp=str; *cp; cp++ )
+    if( *cp == ',' ) dz_sim_perturb_num++;
+  if( !( dz_sim_perturb_list = zAlloc( dz_sim_perturb_t, dz_sim_perturb_num ) ) ){
+    ZALLOCERROR();
+    return false;
+  }
+  for( cp=str, i=0; i<dz_sim_perturb_num; i++ ){
+    if( sscanf( cp, "%255[^:]:%d:%lf", dz_sim_perturb_list[i].name, &dz_sim_perturb_list[i].index, &dz_sim_perturb_list[i].ratio ) != 3 ){
+      ZRUNERROR( "invalid perturbation %s", cp );
+      return false;
+    }
+    if( ( cp = strchr( cp, ',' ) ) ) cp++;
+  }
+  return true;
+}
+
+bool dz_sim_perturb(dzSysArray *arr, int k, void *util)
+{
+  dzSys *sys;
+  int i;
+
+  for( i=0; i<dz_sim_perturb_num; i++ ){
+    if( !( sys = dzSysArrayNameFind( arr, dz_sim_perturb_list[i].name ) ) ){
+      ZRUNERROR( DZ_WARN_SYS_NAME_UNFOUND, dz_sim_perturb_list[i].name );
+      return false;
+    }
+    if( !dzSysPerturbPrp( sys, dz_sim_perturb_list[i].index, dz_sim_perturb_list[i].ratio ) ) return false;
+  }
+  return true;
+}
+
+bool dz_sim_ensemble(FILE *fp, dzSysArray *arr)
+{
+  dzSysEns ens;
+  double dt;
+  dzSys *sys_out;
+  bool ret = false;
+
+  if( zIsTiny( ( dt = atof( opt[OPT_DT].arg ) ) ) ){
+    ZRUNERROR( "too small discrete time step %g", dt );
+    return false;
+  }
+  if( !opt[OPT_OUTSYS].arg ||
+      !( sys_out = dzSysArrayNameFind( arr, opt[OPT_OUTSYS].arg ) ) )
+    sys_out = zArrayHead( arr );
+  if( opt[OPT_PERTURB].flag && !dz_sim_perturb_parse( opt[OPT_PERTURB].arg ) ) goto TERMINATE;
+  zRandInit();
+  if( !dzSysEnsCreate( &ens, arr, atoi( opt[OPT_ENSNUM].arg ), dz_sim_perturb, NULL ) ) goto TERMINATE;
+  if( ( ret = dzSysEnsRun( &ens, sys_out - zArrayElemNC(arr,0), dt, (int)( atof( opt[OPT_T].arg ) / dt ) + 1, atoi( opt[OPT_THREADNUM].arg ) ) ) )
+    dzSysEnsFPrint( fp, &ens );
+  dzSysEnsDestroy( &ens );
+ TERMINATE:
+  zFree( dz_sim_perturb_list );
+  return ret;
+}
+
 void dz_sim_script(FILE *fp, char *logfile, double t)
 {
   fprintf( fp, "clear\n" );
@@ -81,12 +163,19 @@ int main(int argc, char *argv[])
 {
   dzSysArray arr;
   FILE *fp;
+  int ret;
 
   if( argc < 2 ) dz_sim_usage( argv[0] );
   if( !dz_sim_commandarg( argc, argv+1 ) ) return 1;
   if( !dzSysArrayReadZTK( &arr, opt[OPT_SYSFILE].arg ) ) return 1;
 
   fp = fopen( opt[OPT_OUTPUTFILE].arg, "w" );
+  if( atoi( opt[OPT_ENSNUM].arg ) > 0 ){
+    ret = dz_sim_ensemble( fp, &arr ) ? 0 : 1;
+    fclose( fp );
+    dzSysArrayDestroy( &arr );
+    return ret;
+  }
   dz_sim_output( fp, &arr );
   fclose( fp );
 
@@ -0,0 +1,67 @@
+#include <dzco/dz_sys.h>
+
+enum{
+  OPT_INPUTFILE=0, OPT_OUTPUTFILE,
+  OPT_REVERSE,
+  OPT_HELP,
+  OPT_INVALID
+};
+zOption opt[] = {
+  { "i", "in", "<input file>", "system definition file", NULL, false },
+  { "o", "out", "<output file>", "output file", (char *)"sys.bin", false },
+  { "r", "reverse", NULL, "convert a binary image to a ZTK file", NULL, false },
+  { "h", "help", NULL, "show this message", NULL, false },
+  { NULL, NULL, NULL, NULL, NULL, false },
+};
+
+void dz_sys2bin_usage(const char *arg)
+{
+  eprintf( "Usage: %s [option] <input file> [output file]\n", arg );
+  eprintf( "<options>\n" );
+  zOptionHelp( opt );
+  eprintf( "A ZTK file of systems is converted to a binary image, which is loaded\n" );
+  eprintf( "without parsing by dzSysArrayReadBin().\n" );
+  exit( 0 );
+}
+
+bool dz_sys2bin_commandarg(int argc, char *argv[])
+{
+  zStrAddrList arglist;
+  zStrAddrListCell *file;
+
+  if( !zOptionRead( opt, argv, &arglist ) ) return false;
+  if( opt[OPT_HELP].flag ) dz_sys2bin_usage( "dz_sys2bin" );
+  zListForEach( &arglist, file ){
+    if( !opt[OPT_INPUTFILE].flag ){
+      opt[OPT_INPUTFILE].flag = true;
+      opt[OPT_INPUTFILE].arg  = file->data;
+    } else{
+      opt[OPT_OUTPUTFILE].flag = true;
+      opt[OPT_OUTPUTFILE].arg  = file->data;
+    }
+  }
+  zStrAddrListDestroy( &arglist );
+  if( !opt[OPT_INPUTFILE].flag ){
+    ZRUNERROR( "input file not specified" );
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  dzSysArray arr;
+  bool ret;
+
+  if( argc < 2 ) dz_sys2bin_usage( argv[0] );
+  if( !dz_sys2bin_commandarg( argc, argv+1 ) ) return 1;
+  if( opt[OPT_REVERSE].flag ){
+    if( !dzSysArrayReadBin( &arr, opt[OPT_INPUTFILE].arg ) ) return 1;
+    ret = dzSysArrayWriteZTK( &arr, opt[OPT_OUTPUTFILE].arg );
+  } else{
+    if( !dzSysArrayReadZTK( &arr, opt[OPT_INPUTFILE].arg ) ) return 1;
+    ret = dzSysArrayWriteBin( &arr, opt[OPT_OUTPUTFILE].arg, false );
+  }
+  dzSysArrayDestroy( &arr );
+  return ret ? 0 : 1;
+}
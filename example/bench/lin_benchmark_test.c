@@ -0,0 +1,190 @@
+/* scaling benchmark of linear system design for random stabilizable
+ * pairs (A,b) of dimensions from 2 up to a given size.
+ * usage: lin_benchmark_test [maximum dimension] [CSV file]
+ */
+#define _POSIX_C_SOURCE 199309L /* for clock_gettime() */
+
+#include <dzco/dz_lin.h>
+#include <time.h>
+
+#define BENCH_TIME 0.1 /* minimum measuring time [s] */
+#define EULER_MAX  50  /* Euler's method is too slow for larger systems */
+#define LYAP_MAX   50  /* the Lyapunov equation has O(n^2) unknowns, which
+                        * is too large for larger systems */
+
+int dim[] = { 2, 5, 10, 20, 50, 100, 200, 500, 0 };
+
+/* random pair (A,b), which is controllable almost surely */
+bool gen_sample(dzLin *lin, zMat *q, zVec *qv, zMat *p, zVec *pole, zVec *f, int n)
+{
+  int i, j;
+
+  if( !dzLinAlloc( lin, n ) ) return false;
+  *q = zMatAllocSqr( n );
+  *qv = zVecAlloc( n );
+  *p = zMatAllocSqr( n );
+  *pole = zVecAlloc( n );
+  *f = zVecAlloc( n );
+  if( !*q || !*qv || !*p || !*pole || !*f ) return false;
+  for( i=0; i<n; i++ ){
+    for( j=0; j<n; j++ )
+      zMatSetElemNC( lin->a, i, j, zRandF(-1,1)/sqrt(n) );
+    zVecSetElemNC( lin->b, i, zRandF(-1,1) );
+    zVecSetElemNC( lin->c, i, zRandF(-1,1) );
+    zMatSetElemNC( *q, i, i, 1 );
+    zVecSetElemNC( *qv, i, 1 );
+    zVecSetElemNC( *pole, i, -1-(double)i/n );
+  }
+  return true;
+}
+
+/* n-th order transfer function 1/(s+1)^n */
+bool gen_tf(dzTF *tf, int n)
+{
+  double c = 1;
+  int i;
+
+  if( !dzTFAlloc( tf, 0, n ) ) return false;
+  dzTFSetNumElem( tf, 0, 1 );
+  for( i=0; i<=n; i++ ){
+    dzTFSetDenElem( tf, i, c );
+    c = c * ( n - i ) / ( i + 1 );
+  }
+  return true;
+}
+
+/* current wall-clock time in seconds */
+double now(void)
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec + ts.tv_nsec * 1.0e-9;
+}
+
+double elapsed(double start){ return now() - start; }
+
+/* solvers of the Riccati equation to be compared */
+typedef zMat (* riccati_t)(zMat,dzLin*,zMat,int);
+
+zMat riccati_euler(zMat p, dzLin *lin, zMat q, int iter){
+  return dzLinRiccatiSolveEuler( p, lin, q, 1.0, zTOL, iter );
+}
+zMat riccati_kleinman(zMat p, dzLin *lin, zMat q, int iter){
+  return dzLinRiccatiSolveKleinman( p, NULL, lin, q, 1.0, zTOL, iter );
+}
+
+/* the number of iterations is found as the smallest limit of
+ * iterations with which the solution is identical to that without
+ * a limit. -1 is returned if the solution is not reproduced within
+ * the default limit of iterations. */
+int riccati_iter(riccati_t solver, zMat p, dzLin *lin, zMat q, zMat pp)
+{
+  int lo = 0, hi = 1, mid;
+  size_t size;
+
+  size = sizeof(double) * zMatRowSizeNC(p) * zMatColSizeNC(p);
+  zEchoOff();
+  for( ; ; hi=zMin(2*hi,Z_MAX_ITER_NUM) ){
+    solver( pp, lin, q, hi );
+    if( memcmp( zMatBufNC(pp), zMatBufNC(p), size ) == 0 ) break;
+    if( hi >= Z_MAX_ITER_NUM ){
+      zEchoOn();
+      return -1;
+    }
+    lo = hi;
+  }
+  while( hi - lo > 1 ){
+    mid = ( lo + hi ) / 2;
+    solver( pp, lin, q, mid );
+    if( memcmp( zMatBufNC(pp), zMatBufNC(p), size ) == 0 ) hi = mid; else lo = mid;
+  }
+  zEchoOn();
+  return hi;
+}
+
+void output(FILE *fp, const char *routine, int n, int iter, double res, double t, bool result)
+{
+  char buf[BUFSIZ];
+
+  if( iter < 0 )
+    sprintf( buf, "not reproducible" );
+  else
+    sprintf( buf, "%d", iter );
+  printf( "%-26s n=%4d iter=%6s residual=%10.3e time=%12.3f us %s\n", routine, n, buf, res, t*1.0e6, result ? "" : "(failed)" );
+  fprintf( fp, "%s,%d,%s,%.6e,%.3f,%s\n", routine, n, buf, res, t*1.0e6, result ? "ok" : "failed" );
+}
+
+void bench_riccati(FILE *fp, const char *routine, riccati_t solver, dzLin *lin, zMat q, zMat p)
+{
+  zMat pp;
+  int n = 0, iter = -1;
+  double c, t, res;
+
+  c = now();
+  do{
+    solver( p, lin, q, 0 );
+    n++;
+  } while( ( t = elapsed( c ) ) < BENCH_TIME );
+  res = dzLinRiccatiError( p, lin, q, 1.0, NULL );
+  if( ( pp = zMatAllocSqr( dzLinDim(lin) ) ) ){
+    iter = riccati_iter( solver, p, lin, q, pp );
+    zMatFree( pp );
+  }
+  output( fp, routine, dzLinDim(lin), iter, res, t/n, zIsTol( res, zTOL*dzLinDim(lin) ) );
+}
+
+/* measure routines which have no iteration */
+#define BENCH(fp,routine,n,expr) do{\
+  int __n = 0;\
+  double __c, __t;\
+  bool __result;\
+  __c = now();\
+  do{\
+    __result = (expr) ? true : false;\
+    __n++;\
+  } while( ( __t = elapsed( __c ) ) < BENCH_TIME );\
+  output( fp, routine, n, 0, 0, __t/__n, __result );\
+} while(0)
+
+int main(int argc, char *argv[])
+{
+  dzLin lin, canon;
+  dzTF tf;
+  zMat q, p;
+  zVec qv, pole, f;
+  FILE *fp;
+  int i, n, nmax;
+
+  zRandInit();
+  nmax = argc > 1 ? atoi( argv[1] ) : 500;
+  if( !( fp = fopen( argc > 2 ? argv[2] : "lin_bench.csv", "w" ) ) ){
+    ZOPENERROR( argc > 2 ? argv[2] : "lin_bench.csv" );
+    return 1;
+  }
+  fprintf( fp, "routine,n,iterations,residual,time_us,status\n" );
+  for( i=0; ( n = dim[i] ) > 0 && n <= nmax; i++ ){
+    if( !gen_sample( &lin, &q, &qv, &p, &pole, &f, n ) ){
+      ZALLOCERROR();
+      return 1;
+    }
+    if( n <= EULER_MAX )
+      bench_riccati( fp, "dzLinRiccatiSolveEuler", riccati_euler, &lin, q, p );
+    if( n <= LYAP_MAX ){
+      bench_riccati( fp, "dzLinRiccatiSolveKleinman", riccati_kleinman, &lin, q, p );
+      BENCH( fp, "dzLinLQR", n, dzLinLQR( &lin, qv, 1.0, f ) );
+    }
+    BENCH( fp, "dzLinPoleAssign", n, dzLinPoleAssign( &lin, pole, f ) );
+    BENCH( fp, "dzLinCreateObs", n, dzLinCreateObs( &lin, pole, f ) );
+    BENCH( fp, "dzLinIsCtrl", n, dzLinIsCtrl( &lin ) );
+    if( gen_tf( &tf, n ) ){
+      BENCH( fp, "dzTF2LinCtrlCanon", n, dzTF2LinCtrlCanon( &tf, &canon ) && ( dzLinDestroy( &canon ), true ) );
+      dzTFDestroy( &tf );
+    }
+    dzLinDestroy( &lin );
+    zMatFreeAtOnce( 2, q, p );
+    zVecFreeAtOnce( 3, qv, pole, f );
+  }
+  fclose( fp );
+  return 0;
+}
@@ -0,0 +1,207 @@
+/* benchmark of built-in system classes and arrays of systems.
+ * results are output to CSV and JSON files to be compared between versions.
+ * usage: sys_benchmark_test [CSV file] [JSON file]
+ */
+#include <dzco/dz_sys.h>
+#include <time.h>
+
+#define DT         0.001
+#define BENCH_TIME 0.2  /* minimum measuring time [s] */
+#define BENCH_LOOP 1000 /* number of updates per lap */
+
+double u[8]; /* inputs shared by systems */
+
+dzSys *create_adder(dzSys *sys, int n){ return dzSysAdderCreate( sys, n ); }
+dzSys *create_subtr(dzSys *sys, int n){ return dzSysSubtrCreate( sys, n ); }
+dzSys *create_limit(dzSys *sys, int n){ return dzSysLimitCreate( sys, -0.5, 0.5 ); }
+dzSys *create_p(dzSys *sys, int n){ return dzSysPCreate( sys, 2 ); }
+dzSys *create_i(dzSys *sys, int n){ return dzSysICreate( sys, 2, 0.9 ); }
+dzSys *create_d(dzSys *sys, int n){ return dzSysDCreate( sys, 2, 0.01 ); }
+dzSys *create_pid(dzSys *sys, int n){ return dzSysPIDCreate( sys, 10, 2, 0.5, 0.01, 0.9 ); }
+dzSys *create_qpd(dzSys *sys, int n){ return dzSysQPDCreate( sys, 10, 0.5, 0.01 ); }
+dzSys *create_fol(dzSys *sys, int n){ return dzSysFOLCreate( sys, 0.1, 1 ); }
+dzSys *create_sol(dzSys *sys, int n){ return dzSysSOLCreate( sys, 0.1, 0.01, 0.5, 1 ); }
+dzSys *create_pc(dzSys *sys, int n){ return dzSysPCCreate( sys, 0.1, 0.02, 1 ); }
+dzSys *create_adapt(dzSys *sys, int n){ return dzSysAdaptCreate( sys, 0.1, 0 ); }
+dzSys *create_maf(dzSys *sys, int n){ return dzSysMAFCreate( sys, 0.9 ); }
+dzSys *create_bw(dzSys *sys, int n){ return dzSysBWCreate( sys, 10, n ); }
+dzSys *create_bwmulti(dzSys *sys, int n){ return dzSysBWMultiCreate( sys, 10, 4, n ); }
+dzSys *create_step(dzSys *sys, int n){ return dzSysStepCreate( sys, 1, 0, HUGE_VAL ); }
+dzSys *create_ramp(dzSys *sys, int n){ return dzSysRampCreate( sys, 1, 0, 1 ); }
+dzSys *create_sine(dzSys *sys, int n){ return dzSysSineCreate( sys, 1, 0, 0.1 ); }
+dzSys *create_whitenoise(dzSys *sys, int n){ return dzSysWhitenoiseCreate( sys, 1, 0, HUGE_VAL ); }
+dzSys *create_batch(dzSys *sys, int n){ return dzSysBatchCreate( sys, DZ_SYS_BATCH_FOL, n ); }
+
+/* n-th order system 1/(s+1)^n */
+dzSys *create_tf(dzSys *sys, int n)
+{
+  dzTF *tf;
+  double c = 1;
+  int i;
+
+  if( !( tf = zAlloc( dzTF, 1 ) ) || !dzTFAlloc( tf, 0, n ) ) return NULL;
+  dzTFSetNumElem( tf, 0, 1 );
+  for( i=0; i<=n; i++ ){
+    dzTFSetDenElem( tf, i, c );
+    c = c * ( n - i ) / ( i + 1 );
+  }
+  return dzSysTFCreate( sys, tf );
+}
+
+/* chain of n first-order lags in the controllable form */
+dzSys *create_lin(dzSys *sys, int n)
+{
+  dzLin *lin;
+  int i;
+
+  if( !( lin = zAlloc( dzLin, 1 ) ) || !dzLinAlloc( lin, n ) ) return NULL;
+  for( i=0; i<n; i++ ){
+    zMatSetElemNC( lin->a, i, i, -1 );
+    if( i < n-1 ) zMatSetElemNC( lin->a, i, i+1, 1 );
+  }
+  zVecSetElemNC( lin->b, n-1, 1 );
+  zVecSetElemNC( lin->c, 0, 1 );
+  return dzSysLinCreate( sys, lin );
+}
+
+dzSys *create_linmimo(dzSys *sys, int n)
+{
+  dzLinMIMO *lin;
+  int i;
+
+  if( !( lin = zAlloc( dzLinMIMO, 1 ) ) || !dzLinMIMOAlloc( lin, n, 2, 2 ) ) return NULL;
+  for( i=0; i<n; i++ ){
+    zMatSetElemNC( lin->a, i, i, -1 );
+    if( i < n-1 ) zMatSetElemNC( lin->a, i, i+1, 1 );
+  }
+  zMatSetElemNC( lin->b, n-1, 0, 1 );
+  zMatSetElemNC( lin->b, 0, 1, 1 );
+  zMatSetElemNC( lin->c, 0, 0, 1 );
+  zMatSetElemNC( lin->c, 1, n-1, 1 );
+  return dzSysLinMIMOCreate( sys, lin );
+}
+
+struct{
+  dzSys *(* create)(dzSys*,int);
+  int param; /* order, dimension or number of channels */
+} bench[] = {
+  { create_adder, 2 }, { create_subtr, 2 }, { create_limit, 0 },
+  { create_p, 0 }, { create_i, 0 }, { create_d, 0 }, { create_pid, 0 }, { create_qpd, 0 },
+  { create_fol, 0 }, { create_sol, 0 }, { create_pc, 0 }, { create_adapt, 0 },
+  { create_lin, 2 }, { create_lin, 8 }, { create_lin, 32 },
+  { create_linmimo, 4 }, { create_linmimo, 16 },
+  { create_tf, 2 }, { create_tf, 4 }, { create_tf, 8 },
+  { create_maf, 0 },
+  { create_bw, 1 }, { create_bw, 2 }, { create_bw, 4 }, { create_bw, 8 },
+  { create_bwmulti, 8 }, { create_bwmulti, 64 },
+  { create_step, 0 }, { create_ramp, 0 }, { create_sine, 0 }, { create_whitenoise, 0 },
+  { create_batch, 8 }, { create_batch, 64 },
+  { NULL, 0 },
+};
+
+double elapsed(clock_t c){ return (double)( clock() - c ) / CLOCKS_PER_SEC; }
+
+/* time per update of a system in nanoseconds */
+double bench_sys(dzSys *sys)
+{
+  clock_t c;
+  long n = 0;
+  int i;
+
+  for( i=0; i<dzSysInputNum(sys); i++ )
+    dzSysInputPtr(sys,i) = &u[i%8];
+  c = clock();
+  do{
+    for( i=0; i<8; i++ ) u[i] = zRandF(-1,1);
+    for( i=0; i<BENCH_LOOP; i++ )
+      dzSysUpdate( sys, DT );
+    n += BENCH_LOOP;
+  } while( elapsed( c ) < BENCH_TIME );
+  return elapsed( c ) / n * 1.0e9;
+}
+
+/* random acyclic graph of n systems fed by a sinusoid */
+bool create_graph(dzSysArray *arr, int n)
+{
+  dzSys *(* create[])(dzSys*,int) = { create_fol, create_pid, create_bw, create_p, create_sol };
+  int i;
+
+  if( !dzSysArrayAlloc( arr, n ) ) return false;
+  create_sine( zArrayElemNC(arr,0), 0 );
+  for( i=1; i<n; i++ ){
+    if( !create[i%5]( zArrayElemNC(arr,i), 2 ) ) return false;
+    dzSysConnect( zArrayElemNC(arr,zRandI(zMax(0,i-16),i-1)), 0, zArrayElemNC(arr,i), 0 );
+  }
+  return true;
+}
+
+/* ticks per second of an array of systems */
+double bench_graph(dzSysArray *arr)
+{
+  dzSysPlan plan;
+  clock_t c;
+  long n = 0;
+
+  if( !dzSysPlanCreate( &plan, arr ) ) return 0;
+  c = clock();
+  do{
+    dzSysPlanUpdate( &plan, DT );
+    n++;
+  } while( elapsed( c ) < BENCH_TIME );
+  dzSysPlanDestroy( &plan );
+  return n / elapsed( c );
+}
+
+int main(int argc, char *argv[])
+{
+  DZ_SYS_COM_ARRAY;
+  int graphsize[] = { 10, 100, 1000, 10000, 100000, 0 };
+  bool covered[sizeof(_dz_sys_com)/sizeof(dzSysCom*)];
+  dzSys sys;
+  dzSysArray arr;
+  FILE *fcsv, *fjson;
+  double ns, tps;
+  int i, j;
+
+  zRandInit();
+  if( !( fcsv = fopen( argc > 1 ? argv[1] : "sys_bench.csv", "w" ) ) ||
+      !( fjson = fopen( argc > 2 ? argv[2] : "sys_bench.json", "w" ) ) ){
+    ZOPENERROR( "output file" );
+    return 1;
+  }
+  fprintf( fcsv, "kind,type,param,ns_per_update,ticks_per_sec\n" );
+  fprintf( fjson, "[\n" );
+  memset( covered, 0, sizeof(covered) );
+  for( i=0; bench[i].create; i++ ){
+    if( !bench[i].create( &sys, bench[i].param ) ){
+      eprintf( "cannot create a system #%d\n", i );
+      return 1;
+    }
+    for( j=0; _dz_sys_com[j]; j++ )
+      if( _dz_sys_com[j] == sys.com ) covered[j] = true;
+    ns = bench_sys( &sys );
+    printf( "%-20s %4d %10.1f ns/update\n", sys.com->typestr, bench[i].param, ns );
+    fprintf( fcsv, "sys,%s,%d,%.3f,\n", sys.com->typestr, bench[i].param, ns );
+    fprintf( fjson, "  {\"kind\":\"sys\",\"type\":\"%s\",\"param\":%d,\"ns_per_update\":%.3f},\n", sys.com->typestr, bench[i].param, ns );
+    dzSysDestroy( &sys );
+  }
+  for( j=0; _dz_sys_com[j]; j++ )
+    if( !covered[j] ) eprintf( "warning: %s not benchmarked\n", _dz_sys_com[j]->typestr );
+  for( i=0; graphsize[i]>0; i++ ){
+    if( !create_graph( &arr, graphsize[i] ) ){
+      eprintf( "cannot create a graph of %d systems\n", graphsize[i] );
+      return 1;
+    }
+    tps = bench_graph( &arr );
+    ns = tps > 0 ? 1.0e9 / tps / graphsize[i] : 0;
+    printf( "graph %6d systems %12.1f ticks/s %10.1f ns/update\n", graphsize[i], tps, ns );
+    fprintf( fcsv, "graph,,%d,%.3f,%.3f\n", graphsize[i], ns, tps );
+    fprintf( fjson, "  {\"kind\":\"graph\",\"param\":%d,\"ns_per_update\":%.3f,\"ticks_per_sec\":%.3f}%s\n",
+      graphsize[i], ns, tps, graphsize[i+1] > 0 ? "," : "" );
+    dzSysArrayDestroy( &arr );
+  }
+  fprintf( fjson, "]\n" );
+  fclose( fcsv );
+  fclose( fjson );
+  return 0;
+}
@@ -1,4 +1,5 @@
 #include <dzco/dz_lin.h>
+#include <time.h>
 
 void alloc_sample(dzLin *lin, zMat *q, zMat *p, zMat *res, int n, double aarray[], double barray[], double qarray[], double ansarray[])
 {
@@ -96,25 +97,43 @@ void (* gen_sample[])(dzLin*,zMat*,double*,zMat*,zMat*) = {
 };
 
 
+#define TRIAL 100
+
 int main(void)
 {
   dzLin lin;
   zMat q, p, res;
   double r;
-  int i;
-  bool result_euler, result_kleinman;
+  int i, j;
+  bool result_euler, result_kleinman, result_sign;
+  clock_t t_euler, t_kleinman, t_sign;
 
   for( i=0; gen_sample[i]; i++ ){
     gen_sample[i]( &lin, &q, &r, &p, &res );
     /* Euler's method */
+    t_euler = clock();
     dzLinRiccatiSolveEuler( p, &lin, q, r, 0.01*zTOL, 0 );
+    t_euler = clock() - t_euler;
     dzLinRiccatiError( p, &lin, q, r, res );
     result_euler = zMatIsTiny( res );
     /* Kleinman's method */
-    dzLinRiccatiSolveKleinman( p, NULL, &lin, q, r, zTOL, 0 );
+    t_kleinman = clock();
+    for( j=0; j<TRIAL; j++ )
+      dzLinRiccatiSolveKleinman( p, NULL, &lin, q, r, zTOL, 0 );
+    t_kleinman = clock() - t_kleinman;
     dzLinRiccatiError( p, &lin, q, r, res );
     result_kleinman = zMatIsTiny( res );
-    printf( "case #%d: Euler=%s, Kleinman=%s\n", i, zBoolStr(result_euler), zBoolStr(result_kleinman) );
+    /* sign function method */
+    t_sign = clock();
+    for( j=0; j<TRIAL; j++ )
+      dzLinRiccatiSolveSign( p, NULL, &lin, q, r, zTOL, 0 );
+    t_sign = clock() - t_sign;
+    dzLinRiccatiError( p, &lin, q, r, res );
+    result_sign = zMatIsTiny( res );
+    printf( "case #%d: Euler=%s (%g us), Kleinman=%s (%g us), Sign=%s (%g us)\n", i,
+      zBoolStr(result_euler), 1.0e6*t_euler/CLOCKS_PER_SEC,
+      zBoolStr(result_kleinman), 1.0e6*t_kleinman/CLOCKS_PER_SEC/TRIAL,
+      zBoolStr(result_sign), 1.0e6*t_sign/CLOCKS_PER_SEC/TRIAL );
     dzLinDestroy( &lin );
     zMatFreeAtOnce( 3, q, p, res );
   }
@@ -23,20 +23,36 @@
 
 #define DZ_WARN_SYSARRAY_EMPTY         "empty array of systems specified."
 
+#define DZ_WARN_SYSPLAN_ALGEBRAICLOOP  "algebraic loop found through a system %s."
+#define DZ_WARN_SYSPLAN_PERIODMISMATCH "sampling period %s:%g is not a multiple of %g, rounded off."
+#define DZ_WARN_SYSPLAN_INTERP_DISABLED "failed to prepare interpolation, outputs are held instead."
+#define DZ_WARN_SYSPLAN_REQUNFOUND     "required system %s not found in the plan, ignored."
+
+#define DZ_WARN_SYSENS_EMPTY           "empty ensemble specified."
+
 /* error messages */
 
 #define DZ_ERR_TF_UNABLE_CREATE        "cannot create a transfer function."
 #define DZ_ERR_TF_INVALID_DEN          "invalid denominator."
 #define DZ_ERR_TF_NONPROPER            "non-proper system."
+#define DZ_ERR_TF_FR_SLICE             "cannot resize a slice of frequency responses."
+#define DZ_ERR_TF_FR_TOOLONGTOKEN      "too long token in frequency response data."
 
 #define DZ_ERR_LIN_UNCTRL              "system is not controllable."
 #define DZ_ERR_LIN_UNASSIGNABLE_POLE   "cannot assign desired poles."
 #define DZ_ERR_LIN_UNCONVERTIBLE_TF    "cannot convert a transfer function to linear system."
 #define DZ_ERR_LIN_SIZMIS              "size mismatch of system matrices."
+#define DZ_ERR_LIN_INVALID_GAINTABLE   "invalid range or number of grid points of a gain scheduling table."
 
 #define DZ_ERR_IDENT_LAG_UNTRIGERRED   "trigger not found."
 
 #define DZ_ERR_SYS_TYPE_UNSPECIFIED    "type not specified."
+#define DZ_ERR_SYS_TYPE_DUPLICATE      "system type %s already registered."
+
+#define DZ_ERR_SYS_CLONE_UNSUPPORTED   "cannot clone a system of type %s."
+#define DZ_ERR_SYS_SNAPSHOT_UNSUPPORTED "cannot take a snapshot of a system of type %s."
+#define DZ_ERR_SYS_SNAPSHOT_SIZMIS     "size mismatch of a snapshot of systems."
+#define DZ_ERR_SYS_CLONE_SIZMIS        "size mismatch of a cloned system of type %s."
 
 #define DZ_ERR_SYS_TF_UNABLE_CONV      "unable to convert a linear system to a transfer function."
 
@@ -47,6 +63,21 @@
 
 #define DZ_ERR_SYS_BW_ZEROORDER        "cannot create a zero-order filter."
 
+#define DZ_ERR_SYS_BATCH_INVALIDKIND   "invalid kind %d of batched systems."
+#define DZ_ERR_SYS_BATCH_UNMATCHKIND   "cannot load a system of type %s to the batch."
+
+#define DZ_ERR_SYS_LANE_INVALIDWIDTH   "invalid number %d of lanes."
+#define DZ_ERR_SYS_LANE_UNMATCHTYPE    "cannot load a system of type %s to the lanes."
+#define DZ_ERR_SYS_LANE_OUTOFRANGE     "lane %d out of range."
+#define DZ_ERR_SYS_LANE_NOTSERIALIZABLE "lanes are not serializable."
+
+#define DZ_ERR_SYS_BIN_UNSUPPORTED     "cannot encode a system of type %s."
+#define DZ_ERR_SYS_BIN_BROKEN          "broken binary image of systems."
+#define DZ_ERR_SYS_BIN_INCOMPATIBLE    "incompatible binary image of systems."
+
+#define DZ_ERR_SYSENS_INVALID_OUTSYS   "invalid index %d of the observed system."
+#define DZ_ERR_SYSENS_UNPERTURBABLE    "cannot perturb a parameter of a system %s:%d."
+
 #define DZ_ERR_FATAL                   "fatal error! - please report to the author."
 
 #endif /* __DZ_ERRMSG_H__ */
@@ -26,10 +26,18 @@ ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzLin ){
   zVec _ax;  /* inner working memory space */
   zVec _bu;  /* inner working memory space */
   zODE _ode; /* integrator */
+  /* zero-order-hold discretization */
+  zMat _phi;   /* state transition matrix exp(A dt) */
+  zMat _psi;   /* integral of exp(A t) over [0,dt] */
+  zVec _gamma; /* discrete input vector _psi b */
+  zMat _a;     /* A matrix at discretization */
+  zVec _b;     /* B matrix at discretization */
+  double _dt;  /* sampling time at discretization */
   /*! \endcond */
 };
 
 #define dzLinDim(c) zVecSizeNC((c)->x)
+#define dzLinIsZOH(c) ( (c)->_phi != NULL )
 
 /*! \brief initialize a linear system.
  */
@@ -81,6 +89,45 @@ __DZCO_EXPORT void dzLinStateUpdate(dzLin *c, double input, double dt);
 __DZCO_EXPORT void dzLinObsUpdate(dzLin *c, zVec k, double input, double error, double dt);
 __DZCO_EXPORT double dzLinOutput(dzLin *c, double input);
 
+/*! \brief exact zero-order-hold discretization of linear system.
+ *
+ * dzLinSetZOH() switches the state update of a linear system \a c
+ * from the Runge-Kutta-Gill integration to the exact discretization
+ * under the zero-order hold of the input, namely,
+ *   x <- Phi x + Gamma u,
+ * where Phi = exp(A dt) and Gamma = int_0^dt exp(A t) dt b.
+ * Phi and Gamma are computed by dzLinStateUpdate() and dzLinObsUpdate()
+ * at the first step, and cached until the sampling time, A or b
+ * is changed.
+ *
+ * dzLinUnsetZOH() switches the state update of \a c back to the
+ * Runge-Kutta-Gill integration, and frees the cache.
+ *
+ * dzLinDiscretize() computes Phi and Gamma of \a c for the sampling
+ * time \a dt into the cache. \a c has to be switched to the discrete
+ * mode by dzLinSetZOH() in advance.
+ * \return
+ * dzLinSetZOH() returns the true value if it succeeds to allocate
+ * the cache. Otherwise, the false value is returned.
+ *
+ * dzLinDiscretize() returns the false value if \a c is not in the
+ * discrete mode or it fails to allocate the internal work space.
+ * Otherwise, the true value is returned.
+ */
+__DZCO_EXPORT bool dzLinSetZOH(dzLin *c);
+__DZCO_EXPORT void dzLinUnsetZOH(dzLin *c);
+__DZCO_EXPORT bool dzLinDiscretize(dzLin *c, double dt);
+
+/*! \brief exponential of a square matrix.
+ *
+ * dzMatExp() computes the exponential of a square matrix \a m by
+ * scaling and squaring of Taylor series, and puts it into \a e.
+ * \return
+ * dzMatExp() returns a pointer \a e if it succeeds. If it fails
+ * to allocate the internal work space, the null pointer is returned.
+ */
+__DZCO_EXPORT zMat dzMatExp(zMat m, zMat e);
+
 /*! \brief state feedback for linear system.
  *
  * dzLinStateFeedback() reinputs a state-feedback value, namely,
@@ -197,13 +244,24 @@ __DZCO_EXPORT zVec dzLinCreateObs(dzLin *c, zVec pole, zVec k);
  * method, proposed by D. L. Kleinman (1967). In addition
  * to solve AMRE, the optimal feedback gain \a f of the
  * regulator consisting of \a c is simultaneously computed.
+ *
+ * dzLinRiccatiSolveSign() solves AMRE directly from the
+ * stable invariant subspace of the Hamiltonian matrix
+ *  H = [ A -b b^T/r ; -Q -A^T ],
+ * which is found by the matrix sign function W of H computed
+ * by Newton's iteration with determinant scaling. P is the
+ * least-square solution of [ W12 ; W22+I ] P = -[ W11+I ; W21 ].
+ * Neither an initial stabilizing gain nor Lyapunov equations
+ * are required. \a tol is a tolerance of the relative
+ * correction of W. If \a f is not the null pointer, the
+ * optimal feedback gain is also computed.
  * \return
  * dzLinRiccatiErrorDRC() and dzLinRiccatiError() return
  * the norm of the error matrix.
  *
- * dzLinRiccatiSolveEuler() and dzLinRiccatiSolveKleinman()
- * return a pointer \a p, if succeed. Otherwise, the null
- * pointer is returned.
+ * dzLinRiccatiSolveEuler(), dzLinRiccatiSolveKleinman() and
+ * dzLinRiccatiSolveSign() return a pointer \a p, if succeed.
+ * Otherwise, the null pointer is returned.
  * \sa
  * dzLinLQR
  */
@@ -211,6 +269,7 @@ __DZCO_EXPORT double dzLinRiccatiErrorDRC(zMat p, dzLin *c, zMat q, double r, zM
 __DZCO_EXPORT double dzLinRiccatiError(zMat p, dzLin *c, zMat q, double r, zMat e);
 __DZCO_EXPORT zMat dzLinRiccatiSolveEuler(zMat p, dzLin *c, zMat q, double r, double tol, int iter);
 __DZCO_EXPORT zMat dzLinRiccatiSolveKleinman(zMat p, zVec f, dzLin *c, zMat q, double r, double tol, int iter);
+__DZCO_EXPORT zMat dzLinRiccatiSolveSign(zMat p, zVec f, dzLin *c, zMat q, double r, double tol, int iter);
 
 /*! \brief linear optimal regulator of linear system control.
  *
@@ -219,13 +278,99 @@ __DZCO_EXPORT zMat dzLinRiccatiSolveKleinman(zMat p, zVec f, dzLin *c, zMat q, d
  * where all components should be more than or equal to zero.
  * \a r, which must be positive, is the weighting value to
  * the input.
+ *
+ * dzLinLQRMethod() does the same with dzLinLQR() with the
+ * Riccati equation solver specified by \a method, which is
+ * one of the followings.
+ *  DZ_RICCATI_KLEINMAN: dzLinRiccatiSolveKleinman()
+ *  DZ_RICCATI_EULER:    dzLinRiccatiSolveEuler()
+ *  DZ_RICCATI_SIGN:     dzLinRiccatiSolveSign()
+ * If Kleinman's method or the sign function method fails,
+ * Euler's method is tried instead. dzLinLQR() uses Kleinman's
+ * method.
  * \return
- * dzLinLQR() returns a pointer \a f, if succeeding.
- * Otherwise, the null pointer is returned.
+ * dzLinLQR() and dzLinLQRMethod() return a pointer \a f, if
+ * succeeding. Otherwise, the null pointer is returned.
  * \sa
  * dzLinStateFeedback
  */
+typedef enum{
+  DZ_RICCATI_KLEINMAN=0, DZ_RICCATI_EULER, DZ_RICCATI_SIGN
+} dzRiccatiMethod;
+
 __DZCO_EXPORT zVec dzLinLQR(dzLin *c, zVec q, double r, zVec f);
+__DZCO_EXPORT zVec dzLinLQRMethod(dzLin *c, zVec q, double r, zVec f, dzRiccatiMethod method);
+
+/*! \brief discrete-time linear optimal regulator of linear system control.
+ *
+ * dzLinDRiccatiSolveSDA() solves the discrete-time algebraic
+ * Riccati equation
+ *  P = Phi^T P Phi - Phi^T P gamma ( r + gamma^T P gamma )^-1 gamma^T P Phi + Q
+ * by the structure-preserving doubling algorithm, where \a phi
+ * and \a gamma are the state transition matrix and the input
+ * vector of a discrete-time system, \a q is the weighting matrix
+ * to the state and \a r is the weighting value to the input.
+ * \a tol is a tolerance of the increment of P relative to P.
+ * The iteration is done up to \a iter, and Z_MAX_ITER_NUM is
+ * chosen if zero is given for \a iter.
+ * If \a f is not the null pointer, the optimal feedback gain
+ * f = ( r + gamma^T P gamma )^-1 gamma^T P Phi is also computed.
+ *
+ * dzLinDLQR() creates the discrete-time linear-quadratic optimal
+ * regulator of \a c sampled with \a dt under the zero-order
+ * hold. \a q and \a r are the same with those of dzLinLQR().
+ * The regulator minimizes sum ( x^T Q x + r u^2 ) over samples.
+ * \return
+ * dzLinDRiccatiSolveSDA() returns a pointer \a p, and dzLinDLQR()
+ * returns a pointer \a f, if succeeding. Otherwise, the null
+ * pointer is returned.
+ * \sa
+ * dzLinLQR, dzLinSetZOH
+ */
+__DZCO_EXPORT zMat dzLinDRiccatiSolveSDA(zMat p, zVec f, zMat phi, zVec gamma, zMat q, double r, double tol, int iter);
+__DZCO_EXPORT zVec dzLinDLQR(dzLin *c, zVec q, double r, double dt, zVec f);
+
+/* ********************************************************** */
+/* CLASS: dzLinGainTable
+ * gain scheduling table
+ * ********************************************************** */
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzLinGainTable ){
+  double min; /*!< minimum of scheduling parameter */
+  double max; /*!< maximum of scheduling parameter */
+  zMat gain;  /*!< gains at grid points, each row corresponding to a grid point */
+};
+
+#define dzLinGainTableNum(t) zMatRowSizeNC((t)->gain)
+#define dzLinGainTableDim(t) zMatColSizeNC((t)->gain)
+
+/*! \brief gain scheduling table.
+ *
+ * dzLinGainTableCreate() creates a gain scheduling table \a tab,
+ * which stores feedback gains at \a num grid points evenly placed
+ * over [\a min, \a max] of a scheduling parameter. The gain of
+ * size \a dim at a scheduling parameter s is computed by a function
+ * \a gain as gain( s, \a util, f ), where \a util is a pointer to
+ * a programmer's utility, and f is the gain vector to be computed.
+ * \a gain typically modifies a plant by s and calls dzLinLQR() or
+ * dzLinDLQR(), and has to return the null pointer if it fails.
+ *
+ * dzLinGainTableInterp() linearly interpolates the gains stored
+ * in \a tab at a scheduling parameter \a s, and puts it into \a f.
+ * \a s out of the range is clamped. It takes a constant time
+ * regardless of the number of grid points.
+ *
+ * dzLinGainTableDestroy() destroys \a tab.
+ * \return
+ * dzLinGainTableCreate() returns a pointer \a tab if it succeeds.
+ * Otherwise, the null pointer is returned.
+ *
+ * dzLinGainTableInterp() returns a pointer \a f.
+ */
+__DZCO_EXPORT dzLinGainTable *dzLinGainTableInit(dzLinGainTable *tab);
+__DZCO_EXPORT dzLinGainTable *dzLinGainTableCreate(dzLinGainTable *tab, double min, double max, int num, int dim, zVec (* gain)(double,void*,zVec), void *util);
+__DZCO_EXPORT void dzLinGainTableDestroy(dzLinGainTable *tab);
+__DZCO_EXPORT zVec dzLinGainTableInterp(dzLinGainTable *tab, double s, zVec f);
 
 /*! \brief conversion from polynomial transfer function to linear system.
  *
@@ -253,6 +398,7 @@ __DZCO_EXPORT dzLin *dzTF2LinObsCanon(dzTF *tf, dzLin *lin);
 #define ZTK_KEY_DZCO_LIN_B "b"
 #define ZTK_KEY_DZCO_LIN_C "c"
 #define ZTK_KEY_DZCO_LIN_D "d"
+#define ZTK_KEY_DZCO_LIN_DISCRETIZE "discretize"
 
 __DZCO_EXPORT dzLin *dzLinFromZTK(dzLin *lin, ZTK *ztk);
 __DZCO_EXPORT void dzLinFPrintZTK(FILE *fp, dzLin *lin);
@@ -0,0 +1,183 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_lin_mimo - multi-input multi-output linear system
+ */
+
+#ifndef __DZ_LIN_MIMO_H__
+#define __DZ_LIN_MIMO_H__
+
+#include <dzco/dz_lin.h>
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/* CLASS: dzLinMIMO
+ * multi-input multi-output linear system
+ * ********************************************************** */
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzLinMIMO ){
+  zMat a;    /*!< A matrix */
+  zMat b;    /*!< B matrix */
+  zMat c;    /*!< C matrix */
+  zMat d;    /*!< D matrix */
+  zVec x;    /*!< state variable vector */
+  /*! \cond */
+  zVec _u;   /* inner working memory space */
+  zVec _ax;  /* inner working memory space */
+  zVec _bu;  /* inner working memory space */
+  zODE _ode; /* integrator */
+  /* zero-order-hold discretization */
+  zMat _phi;   /* state transition matrix exp(A dt) */
+  zMat _psi;   /* integral of exp(A t) over [0,dt] */
+  zMat _gamma; /* discrete input matrix _psi B */
+  zMat _a;     /* A matrix at discretization */
+  zMat _b;     /* B matrix at discretization */
+  double _dt;  /* sampling time at discretization */
+  /*! \endcond */
+};
+
+#define dzLinMIMODim(l)        zVecSizeNC((l)->x)
+#define dzLinMIMOInputSize(l)  zMatColSizeNC((l)->b)
+#define dzLinMIMOOutputSize(l) zMatRowSizeNC((l)->c)
+#define dzLinMIMOIsZOH(l)      ( (l)->_phi != NULL )
+
+/*! \brief initialize a multi-input multi-output linear system.
+ */
+__DZCO_EXPORT dzLinMIMO *dzLinMIMOInit(dzLinMIMO *lin);
+
+/*! \brief allocate and destroy work space for multi-input multi-output linear system.
+ *
+ * dzLinMIMOAlloc() creates a multi-input multi-output linear system
+ * \a c desecribed as
+ *   dx = A x + B u    (state equation)
+ *    y = C x + D u    (output equation)
+ * \a dim is a dimention of the system. \a m and \a p are the sizes
+ * of the input and output vectors, respectively.
+ *
+ * dzLinMIMODestroy() destroys the internal work space of \a c.
+ * \return
+ * dzLinMIMOAlloc() returns the true value if succeeding to create
+ * the instance, or the false value otherwise.
+ *
+ * dzLinMIMODestroy() returns no value.
+ */
+__DZCO_EXPORT bool dzLinMIMOAlloc(dzLinMIMO *c, int dim, int m, int p);
+__DZCO_EXPORT void dzLinMIMODestroy(dzLinMIMO *c);
+
+/*! \brief output and update the inner state of multi-input multi-output linear system.
+ *
+ * dzLinMIMOStateUpdate() updates the inner state of a linear system
+ * \a c. \a input is the input vector to \a c.
+ *
+ * dzLinMIMOObsUpdate() updates the inner state of a linear system
+ * \a c which functions as an observer.
+ * \a k is an observer gain matrix, \a input is the input vector to
+ * \a c, and \a error is an error between the predicted and the real
+ * output of the plant (the former minus the latter is \a error).
+ *
+ * dzLinMIMOOutput() computes the output vector \a output of \a c by
+ * the current state and the input \a input.
+ *
+ * dzLinMIMOStateFeedback() computes a state-feedback input \a input,
+ * namely, u = -\a f ( x - \a ref ), where \a f is a feedback gain
+ * matrix and \a ref is the reference. If \a ref is the null pointer,
+ * it is regarded as the zero vector.
+ * \return
+ * dzLinMIMOStateUpdate() and dzLinMIMOObsUpdate() returns no value.
+ *
+ * dzLinMIMOOutput() returns a pointer \a output.
+ *
+ * dzLinMIMOStateFeedback() returns a pointer \a input.
+ * \notes
+ * The state update is switched to the exact zero-order-hold
+ * discretization by dzLinMIMOSetZOH() in the same way with dzLin.
+ * \sa
+ * dzLinStateUpdate, dzLinSetZOH
+ */
+__DZCO_EXPORT void dzLinMIMOStateUpdate(dzLinMIMO *c, zVec input, double dt);
+__DZCO_EXPORT void dzLinMIMOObsUpdate(dzLinMIMO *c, zMat k, zVec input, zVec error, double dt);
+__DZCO_EXPORT zVec dzLinMIMOOutput(dzLinMIMO *c, zVec input, zVec output);
+__DZCO_EXPORT zVec dzLinMIMOStateFeedback(dzLinMIMO *c, zVec ref, zMat f, zVec input);
+
+/*! \brief exact zero-order-hold discretization of multi-input multi-output linear system.
+ *
+ * dzLinMIMOSetZOH(), dzLinMIMOUnsetZOH() and dzLinMIMODiscretize()
+ * are the multi-input multi-output versions of dzLinSetZOH(),
+ * dzLinUnsetZOH() and dzLinDiscretize(), respectively.
+ * The cache is rebuilt when the sampling time, A or B is changed.
+ */
+__DZCO_EXPORT bool dzLinMIMOSetZOH(dzLinMIMO *c);
+__DZCO_EXPORT void dzLinMIMOUnsetZOH(dzLinMIMO *c);
+__DZCO_EXPORT bool dzLinMIMODiscretize(dzLinMIMO *c, double dt);
+
+/*! \brief algebraic matrix Riccati equation solver for multi-input multi-output linear system.
+ *
+ * dzLinMIMORiccatiError() computes the residual matrix of the
+ * algebraic matrix Riccati equation
+ *  Q+P A + A^T P - P B R^-1 B^T P = 0,
+ * where A and B are held in a linear system \a c and R is a
+ * diagonal matrix of which diagonal components are \a r. The
+ * residual matrix will be stored in \a e, if it is not the null
+ * pointer.
+ *
+ * dzLinMIMORiccatiSolveKleinman() solves the equation by Kleinman's
+ * method, and simultaneously computes the optimal feedback gain
+ * matrix \a f = R^-1 B^T P. The initial stabilizing gain is found
+ * by a pole assignment of a single-input system (A, B h) with a
+ * random vector h, which is controllable for almost every h if
+ * \a c is controllable. \a tol and \a iter are the same with those
+ * of dzLinRiccatiSolveKleinman().
+ * \return
+ * dzLinMIMORiccatiError() returns the norm of the residual matrix.
+ *
+ * dzLinMIMORiccatiSolveKleinman() returns a pointer \a p if it
+ * succeeds. Otherwise, the null pointer is returned.
+ * \sa
+ * dzLinRiccatiSolveKleinman
+ */
+__DZCO_EXPORT double dzLinMIMORiccatiError(zMat p, dzLinMIMO *c, zMat q, zVec r, zMat e);
+__DZCO_EXPORT zMat dzLinMIMORiccatiSolveKleinman(zMat p, zMat f, dzLinMIMO *c, zMat q, zVec r, double tol, int iter);
+
+/*! \brief linear optimal regulator and observer of multi-input multi-output linear system.
+ *
+ * dzLinMIMOLQR() creates the linear-quadratic optimal regulator
+ * of \a c. \a q is the weighting vector to the state vector, where
+ * all components should be more than or equal to zero. \a r, of
+ * which all components must be positive, is the weighting vector
+ * to the input vector. The feedback gain matrix is put into \a f.
+ *
+ * dzLinMIMOCreateObs() creates an observer of \a c so as to locate
+ * the eigenvalues at \a pole. The observer gain matrix is put into
+ * \a k. It is computed in accordance with duality from a pole
+ * assignment of the single-output system (A, h^T C) with a random
+ * vector h.
+ * \return
+ * dzLinMIMOLQR() returns a pointer \a f, and dzLinMIMOCreateObs()
+ * returns a pointer \a k, if succeeding. Otherwise, the null pointer
+ * is returned.
+ * \sa
+ * dzLinLQR, dzLinCreateObs, dzLinMIMOStateFeedback, dzLinMIMOObsUpdate
+ */
+__DZCO_EXPORT zMat dzLinMIMOLQR(dzLinMIMO *c, zVec q, zVec r, zMat f);
+__DZCO_EXPORT zMat dzLinMIMOCreateObs(dzLinMIMO *c, zVec pole, zMat k);
+
+/*! \brief conversion from a single-input single-output linear system.
+ *
+ * dzLin2LinMIMO() converts a single-input single-output linear
+ * system \a lin to a multi-input multi-output linear system \a mimo
+ * with one input and one output.
+ * \return
+ * dzLin2LinMIMO() returns a pointer \a mimo if it succeeds.
+ * Otherwise, the null pointer is returned.
+ */
+__DZCO_EXPORT dzLinMIMO *dzLin2LinMIMO(dzLin *lin, dzLinMIMO *mimo);
+
+/* ZTK */
+
+__DZCO_EXPORT dzLinMIMO *dzLinMIMOFromZTK(dzLinMIMO *lin, ZTK *ztk);
+__DZCO_EXPORT void dzLinMIMOFPrintZTK(FILE *fp, dzLinMIMO *lin);
+
+__END_DECLS
+
+#endif /* __DZ_LIN_MIMO_H__ */
@@ -16,6 +16,8 @@ __BEGIN_DECLS
  * ********************************************************** */
 
 struct _dzSys;
+struct _dzSysBin;
+struct _dzTF;
 
 ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysPort ){
   struct _dzSys *sp;
@@ -36,6 +38,18 @@ ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysCom ){
   zVec (* _update)(struct _dzSys*, double);
   struct _dzSys *(* _fromZTK)(struct _dzSys*, ZTK*);
   void (* _fprintZTK)(FILE *fp, struct _dzSys*);
+  bool (* _feedthrough)(struct _dzSys*); /* null means direct feedthrough */
+  /* binary image */
+  int _prpnum; /* number of values if the property is a flat array of double-precision values */
+  bool (* _encode)(struct _dzSys*, struct _dzSysBin*);
+  struct _dzSys *(* _decode)(struct _dzSys*, struct _dzSysBin*);
+  /* clone */
+  struct _dzSys *(* _clone)(struct _dzSys*, struct _dzSys*); /* null means a flat property is copied */
+  /* snapshot of internal states */
+  int (* _snapshot)(struct _dzSys*, double*); /* null means a flat property is saved */
+  void (* _restore)(struct _dzSys*, const double*);
+  /* linear time-invariant model */
+  bool (* _tf)(struct _dzSys*, struct _dzTF*); /* null means not a linear time-invariant system */
 };
 
 typedef struct _dzSys{
@@ -44,6 +58,8 @@ typedef struct _dzSys{
   zVec output;
   void *prp; /* utility for inheritance class of dzSys */
   dzSysCom *com; /* methods */
+  double period; /* sampling period; zero means every step of a plan */
+  bool persistent; /* never pruned from a plan */
 } dzSys;
 
 #define dzSysInput(s)         ( &(s)->input )
@@ -60,12 +76,22 @@ typedef struct _dzSys{
 #define dzSysInputVal(s,i)    ( dzSysInputPtr(s,i) ? *dzSysInputPtr(s,i) : 0 )
 #define dzSysOutputVal(s,i)   zVecElemNC( dzSysOutput(s), i )
 
+#define dzSysPeriod(s)        (s)->period
+#define dzSysSetPeriod(s,p)   ( (s)->period = (p) )
+
+#define dzSysIsPersistent(s)  (s)->persistent
+#define dzSysSetPersistent(s,p) ( (s)->persistent = (p) )
+/* a system is regarded as stateful if its class has an own refreshing method */
+#define dzSysIsStateful(s)    ( (s)->com->_refresh != dzSysDefaultRefresh )
+
 #define dzSysInit(s) do{\
   zNameSet( s, NULL );\
   zArrayInit( dzSysInput(s) );\
   dzSysOutput(s) = NULL;\
   (s)->prp = NULL;\
   (s)->com = NULL;\
+  (s)->period = 0;\
+  (s)->persistent = false;\
 } while(0)
 
 /*! \brief destroy, refresh and update dynamical systems.
@@ -93,6 +119,18 @@ typedef struct _dzSys{
 #define dzSysRefresh(s)  (s)->com->_refresh( s )
 #define dzSysUpdate(s,h) (s)->com->_update( s, h )
 
+/*! \brief check if the output of a system directly depends on the current input.
+ *
+ * dzSysIsDirect() checks if the output of a system \a s directly
+ * depends on the current input values. A system of which the
+ * output is determined only by the internal state, such as an
+ * integrator and a function generator, has no direct feedthrough.
+ * \return
+ * dzSysIsDirect() returns the true value if \a s has direct
+ * feedthrough, or the false value otherwise.
+ */
+#define dzSysIsDirect(s) ( !(s)->com->_feedthrough || (s)->com->_feedthrough( s ) )
+
 /*! \brief connect dynamical systems.
  *
  * dzSysConnect() connects the system \a c1 to the other
@@ -114,12 +152,55 @@ typedef struct _dzSys{
 __DZCO_EXPORT bool dzSysConnect(dzSys *s1, int p1, dzSys *s2, int p2);
 __DZCO_EXPORT void dzSysChain(int n, ...);
 
+/*! \brief clone a system.
+ *
+ * dzSysClone() creates a system \a dest which is a deep copy of \a src,
+ * including the name, parameters, internal states and outputs. The
+ * property of \a src is duplicated by _clone of the methods. If it is
+ * the null pointer, a flat property declared by _prpnum is copied as
+ * is, or the property is passed through the encoder and the decoder
+ * of the class.
+ * The inputs of \a dest are connected to the same systems as those of
+ * \a src.
+ * \return
+ * dzSysClone() returns a pointer \a dest if it succeeds. If the class
+ * of \a src cannot be cloned or it fails to allocate memory, the null
+ * pointer is returned.
+ */
+__DZCO_EXPORT dzSys *dzSysClone(dzSys *src, dzSys *dest);
+
 /* default destroying method */
 __DZCO_EXPORT void dzSysDefaultDestroy(dzSys *sys);
 
 /* default refreshing method */
 __DZCO_EXPORT void dzSysDefaultRefresh(dzSys *sys);
 
+/* feedthrough checking method for systems without direct feedthrough */
+__DZCO_EXPORT bool dzSysNoFeedthrough(dzSys *sys);
+
+/*! \brief register and find methods of a system class.
+ *
+ * dzSysComRegister() registers methods \a com of a system class,
+ * so that systems of the class can be read from ZTK files and binary
+ * images by its type name. The built-in classes listed in
+ * DZ_SYS_COM_ARRAY are registered in advance.
+ *
+ * dzSysComFind() finds methods of a system class of which type name
+ * is \a typestr from the registered classes.
+ *
+ * The registry is a hash table, and is not thread-safe. Register
+ * user classes before reading systems in multiple threads.
+ * \return
+ * dzSysComRegister() returns the true value if it succeeds. If
+ * another class of the same type name is already registered, or it
+ * fails to allocate memory, the false value is returned.
+ *
+ * dzSysComFind() returns a pointer to the methods found, or the null
+ * pointer if not found.
+ */
+__DZCO_EXPORT bool dzSysComRegister(dzSysCom *com);
+__DZCO_EXPORT dzSysCom *dzSysComFind(const char *typestr);
+
 /* ZTK */
 
 #define ZTK_TAG_DZCO_SYS                  "dzco::sys"
@@ -128,6 +209,8 @@ __DZCO_EXPORT void dzSysDefaultRefresh(dzSys *sys);
 #define ZTK_KEY_DZCO_SYS_NAME             "name"
 #define ZTK_KEY_DZCO_SYS_TYPE             "type"
 #define ZTK_KEY_DZCO_SYS_INPUTNUM         "in"
+#define ZTK_KEY_DZCO_SYS_SAMPLINGPERIOD   "samplingperiod"
+#define ZTK_KEY_DZCO_SYS_PERSISTENT       "persistent"
 #define ZTK_KEY_DZCO_SYS_TIMECONSTANT     "timeconstant"
 #define ZTK_KEY_DZCO_SYS_T1               "t1"
 #define ZTK_KEY_DZCO_SYS_T2               "t2"
@@ -160,10 +243,78 @@ __DZCO_EXPORT dzSysArray *dzSysArrayAlloc(dzSysArray *arr, int size);
 /*! \brief destroy an array of systems. */
 __DZCO_EXPORT void dzSysArrayDestroy(dzSysArray *arr);
 
+/*! \brief clone an array of systems and rebind inputs.
+ *
+ * dzSysArrayClone() creates an array of systems \a dest which is a
+ * deep copy of \a src by dzSysClone(). Connections between systems in
+ * \a src are remapped to those in \a dest, while connections from
+ * systems out of \a src are kept.
+ *
+ * dzSysRebind() reconnects inputs of a system \a sys which are
+ * connected to systems in an array \a from to the corresponding
+ * systems in another array \a to, namely, those at the same indices.
+ * The other inputs are not changed. It is useful to connect a system
+ * cloned alone to a cloned array, e.g. a controller forked for
+ * prediction to a copy of the plant. \a from and \a to have to be of
+ * the same size.
+ * \return
+ * dzSysArrayClone() returns a pointer \a dest if it succeeds.
+ * Otherwise, the null pointer is returned.
+ *
+ * dzSysRebind() returns the true value if it succeeds. If a system in
+ * \a to lacks the output port to be connected, the false value is
+ * returned.
+ */
+__DZCO_EXPORT dzSysArray *dzSysArrayClone(dzSysArray *src, dzSysArray *dest);
+__DZCO_EXPORT bool dzSysRebind(dzSys *sys, dzSysArray *from, dzSysArray *to);
+
 /*! \brief find a system from array by name. */
 __DZCO_EXPORT dzSys *dzSysArrayNameFind(dzSysArray *arr, const char *name);
 
-/*! \brief update all systems of an array. */
+/* ********************************************************** */
+/* \class dzSysNameIndex
+ * hashed index of systems in an array by name
+ * ********************************************************** */
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysNameIndex ){
+  int size;       /*!< size of the table */
+  dzSys **table;  /*!< hash table */
+};
+
+#define dzSysNameIndexInit(idx) do{\
+  (idx)->size = 0;\
+  (idx)->table = NULL;\
+} while(0)
+
+/*! \brief create and destroy a name index of an array of systems.
+ *
+ * dzSysNameIndexCreate() creates a name index \a idx of an array of
+ * systems \a arr, by which a system is found in a constant time.
+ * Systems without names are not indexed. If \a arr includes systems
+ * of the same name, the first one is indexed.
+ * Note that \a idx has to be re-created if \a arr is reallocated
+ * or systems are renamed.
+ *
+ * dzSysNameIndexDestroy() destroys \a idx.
+ *
+ * dzSysNameIndexFind() finds a system named \a name from \a idx.
+ * \return
+ * dzSysNameIndexCreate() returns a pointer \a idx if it succeeds.
+ * Otherwise, the null pointer is returned.
+ *
+ * dzSysNameIndexFind() returns a pointer to the system found, or the
+ * null pointer if not found or \a idx is empty.
+ */
+__DZCO_EXPORT dzSysNameIndex *dzSysNameIndexCreate(dzSysNameIndex *idx, dzSysArray *arr);
+__DZCO_EXPORT void dzSysNameIndexDestroy(dzSysNameIndex *idx);
+__DZCO_EXPORT dzSys *dzSysNameIndexFind(dzSysNameIndex *idx, const char *name);
+
+/*! \brief update all systems of an array.
+ *
+ * dzSysArrayUpdate() updates all systems of \a arr with the same
+ * sampling time \a dt in the order of the array. Sampling periods of
+ * the systems are ignored. See dzSysPlanUpdate() for multirate systems.
+ */
 __DZCO_EXPORT void dzSysArrayUpdate(dzSysArray *arr, double dt);
 
 /*! \brief read the current position of a ZTK file and create an array of systems. */
@@ -191,21 +342,35 @@ __END_DECLS
 
 #include <dzco/dz_sys_fg.h> /* function generators */
 
+#include <dzco/dz_sys_batch.h> /* batch of homogeneous systems */
+
 __BEGIN_DECLS
 
-/* add a handle to the following list when you create a new system class. */
+/* add a handle to the following list when you create a new built-in system
+ * class. user classes are registered by dzSysComRegister(). */
 #define DZ_SYS_COM_ARRAY \
   dzSysCom *_dz_sys_com[] = {\
     &dz_sys_adder_com, &dz_sys_subtr_com, &dz_sys_limit_com,\
     &dz_sys_p_com, &dz_sys_i_com, &dz_sys_d_com, &dz_sys_pid_com, &dz_sys_qpd_com,\
     &dz_sys_fol_com, &dz_sys_sol_com, &dz_sys_pc_com, &dz_sys_adapt_com,\
-    &dz_sys_lin_com,\
+    &dz_sys_lin_com, &dz_sys_linmimo_com,\
     &dz_sys_tf_com,\
-    &dz_sys_maf_com, &dz_sys_bw_com,\
+    &dz_sys_maf_com, &dz_sys_bw_com, &dz_sys_bwmulti_com,\
     &dz_sys_step_com, &dz_sys_ramp_com, &dz_sys_sine_com, &dz_sys_whitenoise_com,\
+    &dz_sys_batch_com,\
     NULL,\
   }
 
 __END_DECLS
 
+#include <dzco/dz_sys_plan.h> /* execution plan */
+#include <dzco/dz_sys_bin.h>  /* binary image */
+#include <dzco/dz_sys_prof.h> /* profiler */
+#include <dzco/dz_sys_ens.h>  /* ensemble */
+#include <dzco/dz_sys_snap.h> /* snapshot of internal states */
+#include <dzco/dz_sys_lane.h> /* lane-parallel simulation */
+#include <dzco/dz_sys_par.h>  /* level-parallel execution */
+#include <dzco/dz_sys_fuse.h> /* fusion of linear systems */
+#include <dzco/dz_sys_bus.h>  /* signal bus */
+
 #endif /* __DZ_SYS_H__ */
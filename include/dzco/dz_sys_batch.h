@@ -0,0 +1,99 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_batch - batch of homogeneous systems
+ */
+
+#ifndef __DZ_SYS_BATCH_H__
+#define __DZ_SYS_BATCH_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/* batch of homogeneous systems
+ * ********************************************************** */
+
+/*! \brief kinds of systems to be batched. */
+typedef enum{
+  DZ_SYS_BATCH_FOL=0, /*!< first-order-lag system; parameters: [tc][gain] */
+  DZ_SYS_BATCH_SOL,   /*!< second-order-lag system; parameters: [t1][t2][damp][gain] */
+  DZ_SYS_BATCH_PC,    /*!< phase compensator; parameters: [t1][t2][gain] */
+  DZ_SYS_BATCH_MAF,   /*!< moving-average filter; parameters: [ff] */
+  DZ_SYS_BATCH_I,     /*!< integrator; parameters: [gain][fgt] */
+  DZ_SYS_BATCH_P,     /*!< amplifier; parameters: [gain] */
+  DZ_SYS_BATCH_D,     /*!< differentiator; parameters: [gain][tc] */
+  DZ_SYS_BATCH_PID,   /*!< PID controller; parameters: [kp][ki][kd][tc][fgt] */
+  DZ_SYS_BATCH_INVALID
+} dzSysBatchKind;
+
+/*! \brief create a batch of homogeneous systems.
+ *
+ * dzSysBatchCreate() creates a batch \a sys of \a n systems of the
+ * same kind \a kind, which has \a n inputs and \a n outputs. The
+ * i-th output is the output of the i-th system driven by the i-th
+ * input. Each system behaves identically to the corresponding single
+ * system, i.e. dzSysFOLCreate(), dzSysSOLCreate(), dzSysPCCreate(),
+ * dzSysMAFCreate(), dzSysICreate(), dzSysPCreate(), dzSysDCreate() and
+ * dzSysPIDCreate().
+ *
+ * Parameters and internal states of all systems are stored in
+ * contiguous arrays parameter by parameter, so that all systems are
+ * updated in one loop which compilers can vectorize.
+ * The parameters are initialized with the same default values as
+ * those of the single systems read from ZTK files.
+ *
+ * dzSysBatchSetFOL(), dzSysBatchSetSOL(), dzSysBatchSetPC(),
+ * dzSysBatchSetMAF(), dzSysBatchSetI(), dzSysBatchSetP(),
+ * dzSysBatchSetD() and dzSysBatchSetPID() set parameters of the
+ * \a i-th system of a batch \a sys. The meanings of the parameters
+ * are the same with those of the corresponding single systems.
+ * They never check if \a sys is a batch of the corresponding kind.
+ *
+ * dzSysBatchLoad() copies parameters, internal states and the output
+ * of a single system \a src to the \a i-th system of \a sys.
+ * \return
+ * dzSysBatchCreate() returns a pointer \a sys if it succeeds.
+ * If it fails to allocate the internal work space, the null pointer
+ * is returned.
+ *
+ * dzSysBatchSetSOL() returns the false value without setting the
+ * parameters if \a t1 is too short, or the true value otherwise.
+ *
+ * dzSysBatchLoad() returns the false value if \a src is not of the
+ * kind of \a sys, or the true value otherwise.
+ */
+__DZCO_EXPORT dzSys *dzSysBatchCreate(dzSys *sys, dzSysBatchKind kind, int n);
+
+__DZCO_EXPORT void dzSysBatchSetFOL(dzSys *sys, int i, double tc, double gain);
+__DZCO_EXPORT bool dzSysBatchSetSOL(dzSys *sys, int i, double t1, double t2, double damp, double gain);
+__DZCO_EXPORT void dzSysBatchSetPC(dzSys *sys, int i, double t1, double t2, double gain);
+__DZCO_EXPORT void dzSysBatchSetMAF(dzSys *sys, int i, double ff);
+__DZCO_EXPORT void dzSysBatchSetI(dzSys *sys, int i, double gain, double fgt);
+__DZCO_EXPORT void dzSysBatchSetP(dzSys *sys, int i, double gain);
+__DZCO_EXPORT void dzSysBatchSetD(dzSys *sys, int i, double gain, double tc);
+__DZCO_EXPORT void dzSysBatchSetPID(dzSys *sys, int i, double kp, double ki, double kd, double tc, double fgt);
+
+__DZCO_EXPORT bool dzSysBatchLoad(dzSys *sys, int i, dzSys *src);
+
+/*! \brief kind and number of systems in a batch.
+ *
+ * dzSysBatchKindFind() returns the kind of batch of which systems
+ * are of a class \a com, or DZ_SYS_BATCH_INVALID if the class cannot
+ * be batched.
+ */
+__DZCO_EXPORT dzSysBatchKind dzSysBatchKindFind(dzSysCom *com);
+__DZCO_EXPORT dzSysBatchKind dzSysBatchKindOf(dzSys *sys);
+#define dzSysBatchNum(sys) dzSysOutputNum(sys)
+
+__DZCO_EXPORT dzSysCom dz_sys_batch_com;
+
+/* ZTK */
+
+#define ZTK_KEY_DZCO_SYS_BATCH_KIND "kind"
+#define ZTK_KEY_DZCO_SYS_BATCH_NUM  "num"
+
+__END_DECLS
+
+#endif /* __DZ_SYS_BATCH_H__ */
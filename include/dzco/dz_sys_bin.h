@@ -0,0 +1,143 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_bin - binary image of systems
+ */
+
+#ifndef __DZ_SYS_BIN_H__
+#define __DZ_SYS_BIN_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/* \class dzSysBin
+ * byte stream of a binary image
+ * ********************************************************** */
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysBin ){
+  char *buf;       /*!< buffer */
+  size_t size;     /*!< size of stored data */
+  size_t capacity; /*!< size of allocated buffer */
+  size_t cur;      /*!< cursor to read data */
+};
+
+/*! \brief initialize and destroy a byte stream. */
+__DZCO_EXPORT dzSysBin *dzSysBinInit(dzSysBin *bin);
+__DZCO_EXPORT void dzSysBinDestroy(dzSysBin *bin);
+
+/*! \brief write and read data to and from a byte stream.
+ *
+ * dzSysBinWrite() appends \a size bytes of \a data to the tail of a
+ * byte stream \a bin.
+ * dzSysBinRead() reads \a size bytes from the cursor of \a bin to
+ * \a data, and moves the cursor forward.
+ *
+ * dzSysBinWriteInt(), dzSysBinWriteDouble() and dzSysBinWriteDoubleArray()
+ * write an integer value, a double-precision value and an array of
+ * \a n double-precision values, respectively.
+ * dzSysBinWriteStr() writes a null-terminated string with its length.
+ * dzSysBinWriteVec() and dzSysBinWriteMat() write a vector and a
+ * matrix with their sizes, respectively.
+ *
+ * dzSysBinReadInt(), dzSysBinReadDouble(), dzSysBinReadDoubleArray(),
+ * dzSysBinReadVec() and dzSysBinReadMat() read the corresponding data.
+ * dzSysBinReadVec() and dzSysBinReadMat() read the values into an
+ * already allocated vector and matrix, and fail if the sizes do not
+ * match. dzSysBinReadStr() allocates a new string to \a str.
+ * \return
+ * All these functions return the true value if they succeed. If
+ * they fail to allocate memory, or the data is broken, the false
+ * value is returned.
+ */
+__DZCO_EXPORT bool dzSysBinWrite(dzSysBin *bin, const void *data, size_t size);
+__DZCO_EXPORT bool dzSysBinRead(dzSysBin *bin, void *data, size_t size);
+
+__DZCO_EXPORT bool dzSysBinWriteInt(dzSysBin *bin, int val);
+__DZCO_EXPORT bool dzSysBinWriteDouble(dzSysBin *bin, double val);
+__DZCO_EXPORT bool dzSysBinWriteDoubleArray(dzSysBin *bin, const double *val, int n);
+__DZCO_EXPORT bool dzSysBinWriteStr(dzSysBin *bin, const char *str);
+__DZCO_EXPORT bool dzSysBinWriteVec(dzSysBin *bin, zVec v);
+__DZCO_EXPORT bool dzSysBinWriteMat(dzSysBin *bin, zMat m);
+
+__DZCO_EXPORT bool dzSysBinReadInt(dzSysBin *bin, int *val);
+__DZCO_EXPORT bool dzSysBinReadDouble(dzSysBin *bin, double *val);
+__DZCO_EXPORT bool dzSysBinReadDoubleArray(dzSysBin *bin, double *val, int n);
+__DZCO_EXPORT bool dzSysBinReadStr(dzSysBin *bin, char **str);
+__DZCO_EXPORT bool dzSysBinReadVec(dzSysBin *bin, zVec v);
+__DZCO_EXPORT bool dzSysBinReadMat(dzSysBin *bin, zMat m);
+
+/*! \brief write and read a byte stream to and from a file.
+ *
+ * dzSysBinWriteFile() writes the whole data of a byte stream \a bin
+ * to a file \a filename.
+ * dzSysBinReadFile() reads the whole file \a filename to \a bin by
+ * one read.
+ * \return
+ * dzSysBinWriteFile() and dzSysBinReadFile() return the true value
+ * if they succeed. Otherwise, the false value is returned.
+ */
+__DZCO_EXPORT bool dzSysBinWriteFile(dzSysBin *bin, char filename[]);
+__DZCO_EXPORT bool dzSysBinReadFile(dzSysBin *bin, char filename[]);
+
+/* ********************************************************** */
+/* binary image of systems
+ * ********************************************************** */
+
+/*! \brief encode and decode a system.
+ *
+ * dzSysEncode() encodes a system \a sys to a byte stream \a bin.
+ * The type name, the name, the numbers of inputs and outputs and
+ * the property of \a sys are written. A property which is a flat
+ * array of double-precision values, declared by _prpnum of the
+ * methods, is written as is. Otherwise, _encode of the methods is
+ * called.
+ *
+ * dzSysDecode() decodes a system \a sys from \a bin. The connections
+ * of inputs are not restored.
+ * \return
+ * dzSysEncode() returns the true value if it succeeds. If \a sys is
+ * of a class which has neither a flat property nor an encoder, the
+ * false value is returned.
+ *
+ * dzSysDecode() returns a pointer \a sys if it succeeds. Otherwise,
+ * the null pointer is returned.
+ */
+__DZCO_EXPORT bool dzSysEncode(dzSys *sys, dzSysBin *bin);
+__DZCO_EXPORT dzSys *dzSysDecode(dzSys *sys, dzSysBin *bin);
+
+/*! \brief encode and decode an array of systems.
+ *
+ * dzSysArrayEncode() encodes an array of systems \a arr to a byte
+ * stream \a bin. The connections are encoded as pairs of indices of
+ * systems and ports, so that no name lookup is needed to restore
+ * them. If \a state is the true value, the internal states and the
+ * outputs of the systems are also encoded. Otherwise, the systems
+ * are refreshed at decoding.
+ *
+ * dzSysArrayDecode() decodes an array of systems \a arr from \a bin.
+ *
+ * dzSysArrayWriteBin() writes \a arr to a file \a filename as a
+ * binary image.
+ * dzSysArrayReadBin() reads a binary image in a file \a filename by
+ * one read and creates \a arr.
+ *
+ * The binary image depends on the byte order and the size of data
+ * types of the machine, which are checked at decoding.
+ * \return
+ * dzSysArrayEncode() and dzSysArrayWriteBin() return the true value
+ * if they succeed. Otherwise, the false value is returned.
+ *
+ * dzSysArrayDecode() and dzSysArrayReadBin() return a pointer \a arr
+ * if they succeed. Otherwise, the null pointer is returned.
+ */
+__DZCO_EXPORT bool dzSysArrayEncode(dzSysArray *arr, dzSysBin *bin, bool state);
+__DZCO_EXPORT dzSysArray *dzSysArrayDecode(dzSysArray *arr, dzSysBin *bin);
+
+__DZCO_EXPORT bool dzSysArrayWriteBin(dzSysArray *arr, char filename[], bool state);
+__DZCO_EXPORT dzSysArray *dzSysArrayReadBin(dzSysArray *arr, char filename[]);
+
+__END_DECLS
+
+#endif /* __DZ_SYS_BIN_H__ */
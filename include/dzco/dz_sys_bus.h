@@ -0,0 +1,88 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_bus - contiguous signal bus of outputs of systems
+ */
+
+#ifndef __DZ_SYS_BUS_H__
+#define __DZ_SYS_BUS_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* alignment of a signal bus in bytes */
+#define DZ_SYS_BUS_ALIGN 64
+
+/* ********************************************************** */
+/* \class dzSysBus
+ * outputs of an array of systems in a contiguous buffer
+ * ********************************************************** */
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysBus ){
+  dzSysArray *arr; /*!< array of systems */
+  int size;        /*!< number of signals */
+  double *buf;     /*!< aligned buffer of signals */
+  int *offset;     /*!< offset of outputs of each system of the array */
+  double **org;    /*!< original buffers of outputs of each system */
+  void *_mem;      /*!< allocated memory */
+};
+
+#define dzSysBusSize(b)       (b)->size
+#define dzSysBusBuf(b)        (b)->buf
+#define dzSysBusOffset(b,i)   (b)->offset[i]
+
+#define dzSysBusInit(b) do{\
+  (b)->arr = NULL;\
+  (b)->size = 0;\
+  (b)->buf = NULL;\
+  (b)->offset = NULL;\
+  (b)->org = NULL;\
+  (b)->_mem = NULL;\
+} while(0)
+
+/*! \brief create and destroy a signal bus.
+ *
+ * dzSysBusCreate() moves outputs of all systems of the array of an
+ * execution plan \a plan to a signal bus \a bus, a contiguous buffer
+ * aligned to DZ_SYS_BUS_ALIGN bytes. The outputs are laid out in the
+ * order of execution of \a plan, followed by those of the systems not
+ * scheduled in \a plan. Input ports connected to the systems of the
+ * array are resolved to the offsets of the outputs in \a bus.
+ * Since a step of \a plan sweeps \a bus from head to tail, it touches
+ * far fewer cache lines than outputs allocated one by one for graphs
+ * of many small systems.
+ * The offset of outputs of the i-th system of the array is
+ * dzSysBusOffset(\a bus, i).
+ *
+ * dzSysBusDestroy() moves the outputs back to the original buffers of
+ * the systems, and reconnects input ports to them.
+ * \return
+ * dzSysBusCreate() returns a pointer \a bus if it succeeds. If it fails
+ * to allocate memory, the null pointer is returned and the systems are
+ * not modified.
+ * \notes
+ * The array has to be neither destroyed nor fused by dzSysPlanFuse()
+ * while \a bus is alive, nor unfused by dzSysPlanUnfuse(). Systems out
+ * of the array which read outputs of the array have to be reconnected
+ * after the creation and the destruction of \a bus.
+ */
+__DZCO_EXPORT dzSysBus *dzSysBusCreate(dzSysBus *bus, dzSysPlan *plan);
+__DZCO_EXPORT void dzSysBusDestroy(dzSysBus *bus);
+
+/*! \brief copy all signals of a bus.
+ *
+ * dzSysBusCopy() copies all signals of a signal bus \a bus to an array
+ * \a dest, which has to have dzSysBusSize(\a bus) values at least, at
+ * once. It is intended to log all signals at every step.
+ * \return
+ * dzSysBusCopy() returns a pointer \a dest.
+ */
+__DZCO_EXPORT double *dzSysBusCopy(dzSysBus *bus, double *dest);
+
+/*! \brief print all signals of a bus in a line. */
+__DZCO_EXPORT void dzSysBusFPrint(FILE *fp, dzSysBus *bus);
+
+__END_DECLS
+
+#endif /* __DZ_SYS_BUS_H__ */
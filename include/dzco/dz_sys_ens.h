@@ -0,0 +1,107 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_ens - ensemble of perturbed arrays of systems
+ */
+
+#ifndef __DZ_SYS_ENS_H__
+#define __DZ_SYS_ENS_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/* \class dzSysEns
+ * ensemble of copies of an array of systems for Monte Carlo
+ * simulations
+ * ********************************************************** */
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysEns ){
+  int num;         /*!< number of instances */
+  dzSysArray *arr; /*!< instances */
+  int outsys;      /*!< index of the observed system */
+  int outnum;      /*!< number of observed outputs */
+  double *final;   /*!< final values of outputs of each instance */
+  double *peak;    /*!< peak values of outputs of each instance */
+  double *ise;     /*!< integrals of squared outputs of each instance */
+};
+
+#define dzSysEnsNum(e)         (e)->num
+#define dzSysEnsInstance(e,k)  ( &(e)->arr[k] )
+#define dzSysEnsOutNum(e)      (e)->outnum
+#define dzSysEnsFinal(e,k,i)   (e)->final[(k)*(e)->outnum+(i)]
+#define dzSysEnsPeak(e,k,i)    (e)->peak[(k)*(e)->outnum+(i)]
+#define dzSysEnsISE(e,k,i)     (e)->ise[(k)*(e)->outnum+(i)]
+
+/*! \brief create and destroy an ensemble.
+ *
+ * dzSysEnsCreate() creates an ensemble \a ens of \a num copies of an
+ * array of systems \a arr. Parameters, internal states and connections
+ * of \a arr are copied to each instance. Then, \a perturb is called
+ * for each instance with its index and \a util, in order to perturb
+ * parameters of the instance. \a perturb is called in the calling
+ * thread, so that random numbers drawn there are reproducible. If
+ * \a perturb is the null pointer, the instances are identical.
+ *
+ * dzSysEnsDestroy() destroys \a ens. \a arr is not destroyed.
+ * \return
+ * dzSysEnsCreate() returns a pointer \a ens if it succeeds. If it
+ * fails to copy \a arr or \a perturb returns the false value, the null
+ * pointer is returned.
+ */
+__DZCO_EXPORT dzSysEns *dzSysEnsCreate(dzSysEns *ens, dzSysArray *arr, int num, bool (* perturb)(dzSysArray*,int,void*), void *util);
+__DZCO_EXPORT void dzSysEnsDestroy(dzSysEns *ens);
+
+/*! \brief run simulations of an ensemble.
+ *
+ * dzSysEnsRun() updates every instance of an ensemble \a ens \a step
+ * times with a sampling time \a dt along an execution plan, and
+ * reduces outputs of the \a outsys-th system of each instance to
+ * the final values, the peak values (the largest ones) and the
+ * integrals of the squared values (ISE) with respect to time, which
+ * are stored in \a ens. No trace of outputs is kept. The instances
+ * start from their current states, namely, another call continues
+ * the simulations.
+ *
+ * The instances are distributed to \a threadnum threads. If
+ * \a threadnum is zero or negative, as many threads as the online
+ * processors are used. If threads are not available, the instances
+ * are simulated one after another.
+ * \return
+ * dzSysEnsRun() returns the true value if it succeeds. If \a outsys
+ * is out of range or it fails to allocate memory, the false value
+ * is returned.
+ * \notes
+ * Built-in systems do not share any memory between instances except
+ * whitenoise, which draws random numbers from the generator shared
+ * in the process. Its results are not reproducible with multiple
+ * threads.
+ */
+__DZCO_EXPORT bool dzSysEnsRun(dzSysEns *ens, int outsys, double dt, int step, int threadnum);
+
+/*! \brief perturb a parameter of a system.
+ *
+ * dzSysPerturbPrp() multiplies the \a i-th value of a property of a
+ * system \a sys by a uniform random factor in [1-\a ratio, 1+\a ratio].
+ * It is applicable only to a system of which the property is a flat
+ * array of double-precision values (see _prpnum of dzSysCom).
+ * \return
+ * dzSysPerturbPrp() returns the true value if it succeeds. If \a sys
+ * does not have a flat property or \a i is out of range, the false
+ * value is returned.
+ */
+__DZCO_EXPORT bool dzSysPerturbPrp(dzSys *sys, int i, double ratio);
+
+/*! \brief print results of an ensemble.
+ *
+ * dzSysEnsFPrint() prints the final values, the peak values and ISE
+ * of each instance of an ensemble \a ens to the current position of
+ * a file \a fp in a line, followed by their means and standard
+ * deviations over the instances.
+ */
+__DZCO_EXPORT void dzSysEnsFPrint(FILE *fp, dzSysEns *ens);
+
+__END_DECLS
+
+#endif /* __DZ_SYS_ENS_H__ */
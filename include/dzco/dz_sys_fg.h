@@ -30,6 +30,8 @@ dzSysCom dz_sys_##mtype##_com = {\
   ._update = _dzSys##Type##Update,\
   ._fromZTK = _dzSys##Type##FromZTK,\
   ._fprintZTK = _dzSysFGFPrintZTK,\
+  ._feedthrough = dzSysNoFeedthrough,\
+  ._prpnum = 4,\
 };\
 dzSys *dzSys##Type##Create(dzSys *sys, double amp, double delay, double period)\
 {\
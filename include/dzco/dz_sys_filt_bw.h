@@ -29,6 +29,30 @@ __DZCO_EXPORT dzSys *dzSysBWCreate(dzSys *sys, double cf, uint dim);
 
 __DZCO_EXPORT dzSysCom dz_sys_bw_com;
 
+/*! \brief create a multi-channel Butterworth filter.
+ *
+ * dzSysBWMultiCreate() creates a Butterworth filter \a sys of \a n
+ * channels with the cut-off frequency \a cf and the dimension \a dim
+ * common to all channels. The i-th output is the i-th input filtered.
+ * Each channel is equivalent to a filter created by dzSysBWCreate().
+ *
+ * The cascaded sections are updated for all channels at once, where
+ * 2, 4 or 8 channels are processed simultaneously by NEON, AVX2 or
+ * AVX-512 instructions if the library is compiled for them. The
+ * instructions are chosen at compile time, not at run time.
+ * The outputs are not bitwise equal to those of dzSysBWCreate(), since
+ * the compiler may contract the scalar path into fused multiply-adds
+ * while the vector path rounds products and sums one by one. The
+ * difference of each output is within 1.0e-10 times one plus its
+ * magnitude.
+ * \retval
+ * dzSysBWMultiCreate() returns a pointer \a sys if succeeding.
+ * Or, it returns the null pointer when failing by any reasons.
+ */
+__DZCO_EXPORT dzSys *dzSysBWMultiCreate(dzSys *sys, double cf, uint dim, int n);
+
+__DZCO_EXPORT dzSysCom dz_sys_bwmulti_com;
+
 __END_DECLS
 
 #endif /* __DZ_SYS_FILT_BW_H__ */
@@ -0,0 +1,59 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_fuse - fusion of chains of linear systems
+ */
+
+#ifndef __DZ_SYS_FUSE_H__
+#define __DZ_SYS_FUSE_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/*! \brief fuse chains of linear systems of an execution plan.
+ *
+ * dzSysPlanFuse() replaces each chain of linear time-invariant
+ * single-input-single-output systems scheduled in \a plan with a single
+ * state-space model, so that a chain is updated at the cost of one
+ * system.
+ * A system is linear if its class has _tf method that returns its
+ * transfer function (amplifier, first-order-lag, second-order-lag,
+ * phase compensator, transfer function, and adder and subtractor with
+ * a single input) or it is a linear system created by dzSysLinCreate().
+ * Linear systems form a chain if each of them but the last is read
+ * only by the next one. A chain ends at a system whose name is in an
+ * array of names \a probe with \a probenum elements, so that its output
+ * is kept observable. A system with a sampling period does not join
+ * chains.
+ *
+ * Each system of a chain is converted to the controllable canonical
+ * form by dzTF2LinCtrlCanon(), and they are connected in series in
+ * the state space. The last system of the chain is replaced with the
+ * fused model, which reads the input of the first system and writes
+ * the output of the last one, and the others are removed from \a plan.
+ * The fused model starts from rest, and is discretized by zero-order
+ * hold, so that the outputs are slightly different from those of the
+ * original systems which are discretized one by one. The difference
+ * vanishes as the sampling time gets short.
+ *
+ * dzSysPlanUnfuse() restores the systems replaced by dzSysPlanFuse()
+ * and the order of execution of \a plan. The internal states of the
+ * original systems are those when they were fused.
+ * \return
+ * dzSysPlanFuse() returns the number of fused chains. If it fails to
+ * allocate the internal work space, -1 is returned and \a plan is not
+ * modified.
+ * \notes
+ * Outputs of the systems removed from \a plan are no longer updated.
+ * Systems out of the array of \a plan that read them, if any, have to
+ * be probed.
+ * A parallel executor of \a plan made by dzSysParCreate() makes its
+ * levels again at the next update after fusion.
+ */
+__DZCO_EXPORT int dzSysPlanFuse(dzSysPlan *plan, int probenum, char *probe[]);
+__DZCO_EXPORT void dzSysPlanUnfuse(dzSysPlan *plan);
+
+__END_DECLS
+
+#endif /* __DZ_SYS_FUSE_H__ */
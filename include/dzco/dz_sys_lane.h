@@ -0,0 +1,83 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_lane - lane-parallel simulation of systems
+ */
+
+#ifndef __DZ_SYS_LANE_H__
+#define __DZ_SYS_LANE_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/* lanes of a system
+ * ********************************************************** */
+
+/*! \brief create lanes of a system.
+ *
+ * dzSysLaneCreate() creates a system \a sys which simulates \a width
+ * copies of a system \a src in parallel. Each copy is called a lane.
+ * If \a src has n inputs and m outputs, \a sys has n*\a width inputs
+ * and m*\a width outputs, where the j-th port of the l-th lane is the
+ * (j*\a width+l)-th port of \a sys. Every lane is initialized with the
+ * parameters, the internal states and the outputs of \a src.
+ *
+ * If the class of \a src can be batched (see dzSysBatchKindFind()),
+ * \a sys is a batch, of which lanes are updated in one loop over
+ * contiguous arrays. Otherwise, \a sys holds \a width clones of \a src
+ * made by dzSysClone(), which are updated one after another.
+ *
+ * dzSysLaneLoad() copies the parameters, the internal states and the
+ * outputs of a system \a src to the \a l-th lane of \a sys. \a src has
+ * to be of the same class with the system from which \a sys is created.
+ * It is useful to set a different parameter for each lane, e.g.
+ *   for( l=0; l<width; l++ ){
+ *     dzSysPIDSetPGain( &pid, kp[l] );
+ *     dzSysLaneLoad( &lanes, l, &pid );
+ *   }
+ *
+ * dzSysLaneOutputVal() is the i-th output of the l-th lane of \a sys
+ * with \a width lanes.
+ * \return
+ * dzSysLaneCreate() returns a pointer \a sys if it succeeds. If
+ * \a width is not positive, \a src cannot be cloned, or it fails to
+ * allocate memory, the null pointer is returned.
+ *
+ * dzSysLaneLoad() returns the true value if it succeeds. If \a l is
+ * out of range or the class of \a src does not match, the false value
+ * is returned.
+ * \notes
+ * Lanes of a system cannot be read from ZTK files nor encoded to
+ * binary images. dzSysFPrintZTK() prints only the name and the type
+ * of lanes, and raises an error.
+ */
+__DZCO_EXPORT dzSys *dzSysLaneCreate(dzSys *sys, dzSys *src, int width);
+__DZCO_EXPORT bool dzSysLaneLoad(dzSys *sys, int l, dzSys *src);
+
+#define dzSysLaneOutputVal(s,width,i,l) dzSysOutputVal( s, (i)*(width)+(l) )
+
+__DZCO_EXPORT dzSysCom dz_sys_lanes_com;
+
+/*! \brief create lanes of an array of systems.
+ *
+ * dzSysArrayLane() creates an array of systems \a dest of which the
+ * i-th system is the lanes of the i-th system of \a src created by
+ * dzSysLaneCreate() with \a width lanes. Connections between systems
+ * in \a src are reproduced lane by lane, namely, the l-th lane of a
+ * system in \a dest is driven by the l-th lanes of the others. An input
+ * connected to a system out of \a src is shared by all lanes.
+ *
+ * The topology of \a dest is the same with \a src, so that it is
+ * simulated by an execution plan created by dzSysPlanCreate() in the
+ * same way, where each update of a system proceeds all lanes at once.
+ * \return
+ * dzSysArrayLane() returns a pointer \a dest if it succeeds. If it
+ * fails to create lanes of a system, the null pointer is returned.
+ */
+__DZCO_EXPORT dzSysArray *dzSysArrayLane(dzSysArray *src, dzSysArray *dest, int width);
+
+__END_DECLS
+
+#endif /* __DZ_SYS_LANE_H__ */
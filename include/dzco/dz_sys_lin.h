@@ -10,6 +10,7 @@
 /* NOTE: never include this header file in user programs. */
 
 #include <dzco/dz_lin.h>
+#include <dzco/dz_lin_mimo.h>
 
 __BEGIN_DECLS
 
@@ -37,6 +38,32 @@ __DZCO_EXPORT dzSys *dzSysLinCreate(dzSys *sys, dzLin *lin);
 
 __DZCO_EXPORT dzSysCom dz_sys_lin_com;
 
+/* ********************************************************** */
+/* multi-input multi-output linear system
+ * ********************************************************** */
+
+/*! \brief create multi-input multi-output linear system.
+ *
+ * dzSysLinMIMOCreate() creates a multi-input multi-output linear
+ * system \a sys, which has the same number of input ports with
+ * the size of the input vector of \a lin and the same number of
+ * output ports with the size of the output vector of \a lin.
+ * \a lin is assigned to \a sys, and destroyed and freed together
+ * with \a sys by dzSysDestroy(). Hence, it has to be allocated by
+ * zAlloc() in advance.
+ * At each step, the output is computed from the state before it is
+ * updated, so that the output depends on the current input only
+ * through the feedthrough matrix D.
+ * \return
+ * dzSysLinMIMOCreate() returns a pointer \a sys if it succeeds.
+ * Otherwise, the null pointer is returned.
+ */
+__DZCO_EXPORT dzSys *dzSysLinMIMOCreate(dzSys *sys, dzLinMIMO *lin);
+
+#define dzSysLinMIMO(sys) ((dzLinMIMO *)((sys)->prp))
+
+__DZCO_EXPORT dzSysCom dz_sys_linmimo_com;
+
 __END_DECLS
 
 #endif /* __DZ_SYS_LIN_H__ */
@@ -0,0 +1,89 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_par - level-parallel execution of an array of systems
+ */
+
+#ifndef __DZ_SYS_PAR_H__
+#define __DZ_SYS_PAR_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/* \class dzSysPar
+ * parallel executor of an execution plan on a pool of threads
+ * ********************************************************** */
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysPar ){
+  dzSysPlan *plan;  /*!< execution plan */
+  int num;          /*!< number of systems of the plan when the levels are made */
+  uint gen;         /*!< generation of the plan when the levels are made */
+  int levelnum;     /*!< number of levels */
+  int *head;        /*!< heads of systems of each level (levelnum+1) */
+  dzSys **sys;      /*!< systems sorted by level */
+  dzSysUpdateMethod *update; /*!< updating methods sorted by level */
+  int threadnum;    /*!< number of threads including the calling thread */
+  void *pool;       /*!< pool of worker threads */
+};
+
+#define dzSysParLevelNum(p)    (p)->levelnum
+#define dzSysParLevelSize(p,l) ( (p)->head[(l)+1] - (p)->head[l] )
+#define dzSysParThreadNum(p)   (p)->threadnum
+
+/*! \brief create and destroy a parallel executor.
+ *
+ * dzSysParCreate() creates a parallel executor \a par of an execution
+ * plan \a plan created by dzSysPlanCreate(). The systems of \a plan
+ * are partitioned into levels, where every system only reads outputs
+ * of systems in the lower levels updated at the same step, and every
+ * system read by another system before its update in \a plan (i.e.
+ * through a broken loop) is in a higher level than the reader. Hence,
+ * systems in a level are independent of each other.
+ * \a threadnum - 1 worker threads are started and kept in a pool until
+ * \a par is destroyed. If \a threadnum is zero or negative, as many
+ * threads as the online processors are used.
+ *
+ * dzSysParDestroy() stops the worker threads and destroys \a par.
+ * \a plan is not destroyed.
+ * \return
+ * dzSysParCreate() returns a pointer \a par if it succeeds. If it
+ * fails to allocate memory, the null pointer is returned. If it fails
+ * to start threads, \a par works with fewer threads.
+ * \notes
+ * \a par has to be re-created when \a plan is re-created. If \a plan
+ * is modified by dzSysPlanPrune(), dzSysPlanFuse() or dzSysPlanUnfuse(),
+ * the levels are made again at the next call of dzSysParUpdate().
+ */
+__DZCO_EXPORT dzSysPar *dzSysParCreate(dzSysPar *par, dzSysPlan *plan, int threadnum);
+__DZCO_EXPORT void dzSysParDestroy(dzSysPar *par);
+
+/*! \brief update all systems in parallel.
+ *
+ * dzSysParUpdate() updates all systems of a parallel executor \a par
+ * level by level with a sampling time \a dt. Systems in a level are
+ * distributed to the threads in chunks, and the next level starts
+ * after all of them are updated. Levels with a few systems are updated
+ * only by the calling thread to save the cost of synchronization.
+ *
+ * Since each system reads the same values as in dzSysPlanUpdate(), the
+ * results are identical to those of dzSysPlanUpdate() bit by bit.
+ * A multirate plan and a lazy plan switched by dzSysPlanSetLazy() are
+ * updated by dzSysPlanUpdate() in the calling thread.
+ * If the order of the plan has been modified since the levels were
+ * made, they are made again before the update. If it fails, the plan
+ * is updated by dzSysPlanUpdate() in the calling thread.
+ * \notes
+ * whitenoise draws random numbers from the generator shared in the
+ * process, so that the sequence of random numbers depends on the
+ * order of threads.
+ */
+__DZCO_EXPORT void dzSysParUpdate(dzSysPar *par, double dt);
+
+/*! \brief print levels of a parallel executor. */
+__DZCO_EXPORT void dzSysParFPrint(FILE *fp, dzSysPar *par);
+
+__END_DECLS
+
+#endif /* __DZ_SYS_PAR_H__ */
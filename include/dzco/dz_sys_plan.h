@@ -0,0 +1,196 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_plan - execution plan of an array of systems
+ */
+
+#ifndef __DZ_SYS_PLAN_H__
+#define __DZ_SYS_PLAN_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/* \class dzSysPlan
+ * ********************************************************** */
+
+typedef zVec (* dzSysUpdateMethod)(dzSys*,double);
+
+/*! \brief handling of outputs of a slow system read by faster systems. */
+typedef enum{
+  DZ_SYS_RATE_HOLD=0, /*!< the latest output is held until the next sampling */
+  DZ_SYS_RATE_INTERP, /*!< linearly interpolated between the last two samples with a delay of a period */
+} dzSysRateTransition;
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysPlan ){
+  dzSysArray *arr; /*!< array of systems scheduled */
+  int num;         /*!< number of scheduled systems */
+  dzSys **sys;     /*!< systems in the order of execution */
+  dzSysUpdateMethod *update; /*!< updating methods in the order of execution */
+  int loopnum;     /*!< number of algebraic loops found */
+  uint gen;        /*!< generation of the order, counted up when it is modified */
+  /* multirate scheduling */
+  double dt;       /*!< base sampling time for which the rates are computed */
+  int *div;        /*!< numbers of base steps in a sampling period of each system */
+  int *cnt;        /*!< counters of base steps of each system */
+  dzSysRateTransition transition; /*!< handling of rate transitions */
+  zVec *prev;      /*!< previous samples of outputs to be interpolated */
+  zVec *cur;       /*!< current samples of outputs to be interpolated */
+  /* fusion of linear systems */
+  void *fuse;      /*!< systems replaced by fused ones */
+  /* demand-driven evaluation */
+  bool lazy;       /*!< whether systems are updated on demand */
+  unsigned long tick; /*!< count of steps, which restarts from one when it wraps */
+  unsigned long *stamp; /*!< step at which each system of the array was updated last */
+  int *pos;        /*!< index of each system of the array in the order of execution, or -1 */
+  int *stack;      /*!< work space to trace demands (twice the size of the array) */
+};
+
+#define dzSysPlanNum(p)       (p)->num
+#define dzSysPlanSys(p,i)     (p)->sys[i]
+#define dzSysPlanLoopNum(p)   (p)->loopnum
+#define dzSysPlanGen(p)       (p)->gen
+#define dzSysPlanIsMultirate(p) ( (p)->div != NULL )
+#define dzSysPlanIsLazy(p)    (p)->lazy
+
+/*! \brief initialize an execution plan. */
+__DZCO_EXPORT dzSysPlan *dzSysPlanInit(dzSysPlan *plan);
+
+/*! \brief create and destroy an execution plan of an array of systems.
+ *
+ * dzSysPlanCreate() compiles an execution plan \a plan of an array
+ * of systems \a arr. The systems are topologically sorted with respect
+ * to the connection graph, so that every system is updated after all
+ * systems feeding it within the same step.
+ * If a closed loop is found, it is broken at a system in the loop
+ * without direct feedthrough (e.g. an integrator) if any. Otherwise,
+ * the loop is an algebraic loop, which is reported and broken at the
+ * system in the loop declared first in \a arr. Systems downstream of
+ * a loop are not chosen, so that they are updated after the loop.
+ * The number of algebraic loops is counted in dzSysPlanLoopNum(plan).
+ * Connections from systems out of \a arr are regarded as external
+ * inputs.
+ *
+ * dzSysPlanDestroy() destroys \a plan. \a arr is not destroyed.
+ * Systems fused by dzSysPlanFuse() are restored.
+ * \return
+ * dzSysPlanCreate() returns a pointer \a plan if it succeeds.
+ * If it fails to allocate the internal work space, the null pointer
+ * is returned.
+ * \notes
+ * \a plan has to be re-created when the connections of \a arr are
+ * modified.
+ */
+__DZCO_EXPORT dzSysPlan *dzSysPlanCreate(dzSysPlan *plan, dzSysArray *arr);
+__DZCO_EXPORT void dzSysPlanDestroy(dzSysPlan *plan);
+
+/*! \brief update all systems along an execution plan.
+ *
+ * dzSysPlanUpdate() updates all systems scheduled in \a plan in the
+ * compiled order. \a dt is the sampling time.
+ *
+ * If a sampling period of a system is specified by dzSysSetPeriod()
+ * or the key 'samplingperiod' of a ZTK file, \a plan is multirate,
+ * where \a dt is regarded as the base sampling time. The system is
+ * updated only once every n calls, where n is its sampling period
+ * divided by \a dt and rounded off, with a sampling time n*\a dt.
+ * It is updated at the first call of every period, and the output is
+ * held during the period. The systems due at a step are updated in the
+ * compiled order, so that a system always reads the latest outputs of
+ * the others regardless of their rates.
+ * Outputs of a slow system read by faster systems are handled as
+ * specified by dzSysPlanSetTransition(). DZ_SYS_RATE_HOLD (default)
+ * holds the latest output, and DZ_SYS_RATE_INTERP linearly interpolates
+ * the last two samples at each base step, which delays the output by
+ * a sampling period of the slow system.
+ * The numbers of steps are recomputed if \a dt changes.
+ *
+ * A plan without sampling periods updates all systems at every call
+ * at no extra cost.
+ */
+__DZCO_EXPORT void dzSysPlanUpdate(dzSysPlan *plan, double dt);
+__DZCO_EXPORT void dzSysPlanSetTransition(dzSysPlan *plan, dzSysRateTransition transition);
+
+/*! \brief update systems of an execution plan one by one.
+ *
+ * dzSysPlanUpdateBegin() prepares an execution plan \a plan for a step
+ * with the sampling time \a dt, namely, recomputes the numbers of steps
+ * of a multirate plan if \a dt changes.
+ *
+ * dzSysPlanUpdateSys() updates the \a i-th system scheduled in \a plan
+ * in the step in the same way with dzSysPlanUpdate(). A system of a
+ * multirate plan which is not due at the step holds or interpolates
+ * its output.
+ *
+ * Calling dzSysPlanUpdateBegin() and then dzSysPlanUpdateSys() for all
+ * systems in order is equivalent to dzSysPlanUpdate(), which is useful
+ * to instrument each update, e.g. by dzSysProfPlanUpdate(). They do not
+ * support demand-driven evaluation by dzSysPlanSetLazy().
+ * \return
+ * dzSysPlanUpdateSys() returns the true value if the system is updated
+ * at the step, or the false value if it is not due.
+ */
+__DZCO_EXPORT void dzSysPlanUpdateBegin(dzSysPlan *plan, double dt);
+__DZCO_EXPORT bool dzSysPlanUpdateSys(dzSysPlan *plan, int i, double dt);
+
+/*! \brief prune systems not upstream of required systems from a plan.
+ *
+ * dzSysPlanPrune() removes systems from an execution plan \a plan
+ * unless they are required or persistent, or feed them directly or
+ * indirectly. \a req is an array of names of the required systems with
+ * \a reqnum elements, e.g. those logged or sent to actuators.
+ * A system is persistent if it is flagged by dzSysSetPersistent() or
+ * the key 'persistent' of a ZTK file, which has to keep integrating
+ * even if nothing reads it.
+ * The removed systems are no longer updated, while \a arr is not
+ * modified.
+ * \return
+ * dzSysPlanPrune() returns the number of removed systems. If it fails
+ * to allocate the internal work space, -1 is returned and \a plan is
+ * not modified. A name which is not found in \a plan is warned and
+ * ignored.
+ * \notes
+ * Pruning is undone by re-creating \a plan. If \a plan is fused by
+ * dzSysPlanFuse() before pruning, dzSysPlanUnfuse() also undoes it.
+ */
+__DZCO_EXPORT int dzSysPlanPrune(dzSysPlan *plan, int reqnum, char *req[]);
+
+/*! \brief demand-driven evaluation of a plan.
+ *
+ * dzSysPlanSetLazy() switches an execution plan \a plan to demand-driven
+ * evaluation if \a lazy is the true value, or back to the update of all
+ * systems at every step otherwise.
+ * A lazy plan updates only persistent systems, stateful systems, namely,
+ * those of classes with their own _refresh method (see dzSysIsStateful()),
+ * and those which feed them at each call of dzSysPlanUpdate(). The other
+ * systems, which are static, are updated when their outputs are demanded.
+ *
+ * dzSysPlanDemand() updates a system \a sys of a lazy plan \a plan
+ * and the systems which feed it, unless they have already been updated
+ * in the current step. The systems are updated in the order of \a plan
+ * with the latest sampling time given to dzSysPlanUpdate(). A system
+ * fed across a loop broken by \a plan is not demanded, and its latest
+ * output is read.
+ * \return
+ * dzSysPlanSetLazy() returns the true value if it succeeds. If it fails
+ * to allocate the internal work space, the false value is returned and
+ * \a plan stays eager.
+ *
+ * dzSysPlanDemand() returns a pointer to the output vector of \a sys.
+ * \notes
+ * A static system that is not demanded at a step is not updated at the
+ * step, while stateful systems never miss steps.
+ * A multirate plan ignores the demand-driven evaluation.
+ * The systems are not updated on demand until the next call of
+ * dzSysPlanUpdate() after \a plan is pruned or fused.
+ */
+__DZCO_EXPORT bool dzSysPlanSetLazy(dzSysPlan *plan, bool lazy);
+__DZCO_EXPORT zVec dzSysPlanDemand(dzSysPlan *plan, dzSys *sys);
+
+/*! \brief print the order of execution of a plan. */
+__DZCO_EXPORT void dzSysPlanFPrint(FILE *fp, dzSysPlan *plan);
+
+__END_DECLS
+
+#endif /* __DZ_SYS_PLAN_H__ */
@@ -0,0 +1,158 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_prof - profiler of an array of systems
+ */
+
+#ifndef __DZ_SYS_PROF_H__
+#define __DZ_SYS_PROF_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/* ********************************************************** */
+/* \class dzSysHist
+ * log-linear histogram of durations in nanoseconds
+ * ********************************************************** */
+
+/* each power of two is divided into 2^DZ_SYS_HIST_SUBBIT sub-buckets,
+ * so that values are recorded with a relative error less than 1/16.
+ * values not less than 2^(DZ_SYS_HIST_MAXBIT+1) are put into the last
+ * bucket. */
+#define DZ_SYS_HIST_SUBBIT 4
+#define DZ_SYS_HIST_MAXBIT 31
+#define DZ_SYS_HIST_SIZE   ( ( DZ_SYS_HIST_MAXBIT - DZ_SYS_HIST_SUBBIT + 2 ) << DZ_SYS_HIST_SUBBIT )
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysHist ){
+  unsigned long count; /*!< number of recorded values */
+  double sum;          /*!< sum of recorded values */
+  double min;          /*!< minimum value */
+  double max;          /*!< maximum value */
+  uint bucket[DZ_SYS_HIST_SIZE]; /*!< buckets */
+};
+
+#define dzSysHistCount(h) (h)->count
+#define dzSysHistMean(h)  ( (h)->count > 0 ? (h)->sum / (h)->count : 0 )
+#define dzSysHistMin(h)   ( (h)->count > 0 ? (h)->min : 0 )
+#define dzSysHistMax(h)   (h)->max
+
+/*! \brief initialize, add a value to and read a percentile of a histogram.
+ *
+ * dzSysHistInit() initializes a histogram \a hist.
+ *
+ * dzSysHistAdd() adds a value \a val in nanoseconds to \a hist.
+ *
+ * dzSysHistPercentile() returns the \a q-th percentile (0 <= \a q <=
+ * 100) of the values recorded in \a hist. It is the highest value
+ * equivalent to the bucket the percentile falls in, and is not larger
+ * than the maximum value.
+ * \return
+ * dzSysHistInit() returns a pointer \a hist.
+ *
+ * dzSysHistAdd() returns no value.
+ *
+ * dzSysHistPercentile() returns the percentile, or zero if \a hist
+ * is empty.
+ */
+__DZCO_EXPORT dzSysHist *dzSysHistInit(dzSysHist *hist);
+__DZCO_EXPORT void dzSysHistAdd(dzSysHist *hist, double val);
+__DZCO_EXPORT double dzSysHistPercentile(dzSysHist *hist, double q);
+
+/* ********************************************************** */
+/* \class dzSysProf
+ * profiler of an array of systems
+ * ********************************************************** */
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysProf ){
+  dzSysArray *arr;       /*!< array of systems profiled */
+  dzSysHist *block;      /*!< histograms of updating time of systems */
+  dzSysHist tick;        /*!< histogram of latency of ticks */
+  double budget;         /*!< time budget of a tick in nanoseconds */
+  unsigned long overrun; /*!< number of overrun ticks */
+  unsigned long *blame;  /*!< number of overrun ticks in which each system took the longest time */
+  /*! \cond */
+  int tracenum;   /* size of the ring buffer of trace */
+  unsigned long tracecount; /* number of ticks traced */
+  double *trace;  /* ring buffer of trace */
+  double _origin; /* origin of time */
+  /*! \endcond */
+};
+
+#define dzSysProfBlock(p,i)     ( &(p)->block[i] )
+#define dzSysProfTick(p)        ( &(p)->tick )
+#define dzSysProfBudget(p)      (p)->budget
+#define dzSysProfOverrunNum(p)  (p)->overrun
+#define dzSysProfBlame(p,i)     (p)->blame[i]
+
+#define dzSysProfSetBudget(p,b) ( (p)->budget = (b) )
+
+/*! \brief create and destroy a profiler.
+ *
+ * dzSysProfCreate() creates a profiler \a prof of an array of systems
+ * \a arr. Updating times of the latest \a tracenum ticks are kept to
+ * be output as a trace. If \a tracenum is zero, no trace is kept.
+ * The time budget of a tick is unset (zero) by default, and is set by
+ * dzSysProfSetBudget() in nanoseconds.
+ *
+ * dzSysProfReset() clears all records of \a prof.
+ *
+ * dzSysProfDestroy() destroys \a prof. \a arr is not destroyed.
+ * \return
+ * dzSysProfCreate() returns a pointer \a prof if it succeeds. If it
+ * fails to allocate the internal work space, the null pointer is
+ * returned.
+ *
+ * dzSysProfReset() and dzSysProfDestroy() return no value.
+ */
+__DZCO_EXPORT dzSysProf *dzSysProfCreate(dzSysProf *prof, dzSysArray *arr, int tracenum);
+__DZCO_EXPORT void dzSysProfReset(dzSysProf *prof);
+__DZCO_EXPORT void dzSysProfDestroy(dzSysProf *prof);
+
+/*! \brief update all systems with profiling.
+ *
+ * dzSysProfArrayUpdate() and dzSysProfPlanUpdate() are instrumented
+ * versions of dzSysArrayUpdate() and dzSysPlanUpdate(), respectively.
+ * The updating time of each system and the latency of the whole tick
+ * are recorded in \a prof. \a plan has to be made from the array
+ * which \a prof profiles. For a multirate plan, only the systems due
+ * at each step are timed, through dzSysPlanUpdateSys(). A lazy plan
+ * switched by dzSysPlanSetLazy() is updated by dzSysPlanUpdate(), and
+ * only the latency of the whole tick is recorded.
+ * If the latency exceeds the time budget, the tick is counted as an
+ * overrun, and the system which took the longest time in it is blamed.
+ *
+ * When a macro DZ_SYS_NOPROF is defined, they are replaced with the
+ * uninstrumented functions, so that no overhead remains.
+ */
+#ifdef DZ_SYS_NOPROF
+#define dzSysProfArrayUpdate(p,a,dt) dzSysArrayUpdate( a, dt )
+#define dzSysProfPlanUpdate(p,l,dt)  dzSysPlanUpdate( l, dt )
+#else
+__DZCO_EXPORT void dzSysProfArrayUpdate(dzSysProf *prof, dzSysArray *arr, double dt);
+__DZCO_EXPORT void dzSysProfPlanUpdate(dzSysProf *prof, dzSysPlan *plan, double dt);
+#endif /* DZ_SYS_NOPROF */
+
+/*! \brief print results of profiling.
+ *
+ * dzSysProfFPrint() prints the statistics of updating time of each
+ * system and the latency of ticks in \a prof to the current position
+ * of a file \a fp.
+ *
+ * dzSysProfFPrintTrace() prints the latest ticks kept in \a prof in
+ * the trace event format of Chrome to \a fp, which can be viewed by
+ * chrome://tracing or Perfetto.
+ * dzSysProfWriteTrace() writes the trace to a file \a filename.
+ * \return
+ * dzSysProfFPrint() and dzSysProfFPrintTrace() return no value.
+ *
+ * dzSysProfWriteTrace() returns the false value if it fails to open
+ * \a filename. Otherwise, the true value is returned.
+ */
+__DZCO_EXPORT void dzSysProfFPrint(FILE *fp, dzSysProf *prof);
+__DZCO_EXPORT void dzSysProfFPrintTrace(FILE *fp, dzSysProf *prof);
+__DZCO_EXPORT bool dzSysProfWriteTrace(dzSysProf *prof, char filename[]);
+
+__END_DECLS
+
+#endif /* __DZ_SYS_PROF_H__ */
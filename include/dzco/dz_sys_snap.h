@@ -0,0 +1,89 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_snap - snapshot of internal states of systems
+ */
+
+#ifndef __DZ_SYS_SNAP_H__
+#define __DZ_SYS_SNAP_H__
+
+/* NOTE: never include this header file in user programs. */
+
+__BEGIN_DECLS
+
+/*! \brief snapshot of internal states of a system.
+ *
+ * dzSysSnapshotSize() returns the number of values to save the outputs
+ * and the internal states of a system \a sys.
+ *
+ * dzSysSnapshot() saves the outputs and the internal states of \a sys
+ * to an array \a buf, which has to have dzSysSnapshotSize(\a sys)
+ * values at least. The internal states are saved by _snapshot of the
+ * methods. If it is the null pointer, the whole property declared as
+ * a flat array by _prpnum is saved.
+ *
+ * dzSysRestore() restores the outputs and the internal states of
+ * \a sys from \a buf saved by dzSysSnapshot().
+ *
+ * Parameters of a system with a flat property are also restored.
+ * \return
+ * dzSysSnapshotSize() returns the number of values. If the class of
+ * \a sys has neither _snapshot nor a flat property but has a property,
+ * -1 is returned.
+ *
+ * dzSysSnapshot() and dzSysRestore() return a pointer to the next
+ * value in \a buf.
+ */
+__DZCO_EXPORT int dzSysSnapshotSize(dzSys *sys);
+__DZCO_EXPORT double *dzSysSnapshot(dzSys *sys, double *buf);
+__DZCO_EXPORT const double *dzSysRestore(dzSys *sys, const double *buf);
+
+/* ********************************************************** */
+/* \class dzSysState
+ * internal states of an array of systems in a contiguous buffer
+ * ********************************************************** */
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzSysState ){
+  int size;    /*!< number of values */
+  double *buf; /*!< buffer */
+};
+
+#define dzSysStateInit(s) do{\
+  (s)->size = 0;\
+  (s)->buf = NULL;\
+} while(0)
+
+/*! \brief allocate and free a buffer of internal states.
+ *
+ * dzSysStateAlloc() allocates a buffer \a state to save the outputs
+ * and the internal states of all systems in an array \a arr.
+ *
+ * dzSysStateFree() frees \a state.
+ * \return
+ * dzSysStateAlloc() returns a pointer \a state if it succeeds. If
+ * a system of \a arr does not support snapshots or it fails to
+ * allocate memory, the null pointer is returned.
+ */
+__DZCO_EXPORT dzSysState *dzSysStateAlloc(dzSysState *state, dzSysArray *arr);
+__DZCO_EXPORT void dzSysStateFree(dzSysState *state);
+
+/*! \brief take a snapshot of and restore an array of systems.
+ *
+ * dzSysArraySnapshot() saves the outputs and the internal states of
+ * all systems in an array \a arr to a buffer \a state allocated by
+ * dzSysStateAlloc().
+ *
+ * dzSysArrayRestore() rewinds \a arr to the snapshot in \a state.
+ * Neither memory is allocated nor connections are modified, so that
+ * it is cheap enough to roll back and replay a simulation repeatedly.
+ * \return
+ * dzSysArraySnapshot() and dzSysArrayRestore() return the true value
+ * if they succeed. If the size of \a state does not match \a arr, the
+ * false value is returned.
+ */
+__DZCO_EXPORT bool dzSysArraySnapshot(dzSysArray *arr, dzSysState *state);
+__DZCO_EXPORT bool dzSysArrayRestore(dzSysArray *arr, dzSysState *state);
+
+__END_DECLS
+
+#endif /* __DZ_SYS_SNAP_H__ */
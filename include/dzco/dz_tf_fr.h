@@ -45,6 +45,183 @@ __DZCO_EXPORT dzFreqRes *dzFreqRes2Open(dzFreqRes *frin, dzFreqRes *frout);
 __DZCO_EXPORT dzFreqRes *dzFreqResFromTF(dzFreqRes *fr, dzTF *tf, double af);
 __DZCO_EXPORT zComplex *dzTFToComplex(dzTF *tf, double af, zComplex *c);
 
+/*! \brief frequency responses of transfer function on a grid.
+ *
+ * dzFreqResGridFromTF() calculates the frequency responses of a
+ * transfer function \a tf at \a n angular frequencies \a af at once.
+ * The gains and the phase lags are stored into arrays \a g and \a p,
+ * respectively, each of which has to have \a n components.
+ *
+ * The factors of zeros and poles are multiplied as complex numbers
+ * on blocks of frequencies, so that only one logarithm and one
+ * arctangent are computed for each frequency. The phase lags are
+ * unwrapped along \a af, which should be sorted so that the phase
+ * lag changes less than 180 degrees between adjacent frequencies.
+ * The result at the first frequency is the same with that of
+ * dzFreqResFromTF().
+ * \return
+ * dzFreqResGridFromTF() returns the false value if it fails to
+ * compute the zeros and poles of \a tf. Otherwise, the true value
+ * is returned.
+ * \sa
+ * dzFreqResFromTF
+ */
+__DZCO_EXPORT bool dzFreqResGridFromTF(dzTF *tf, const double af[], int n, double g[], double p[]);
+
+/* ********************************************************** */
+/*! \class dzFreqResArray
+ * contiguous table of sampled frequency responses
+ * ********************************************************** */
+
+ZDEF_STRUCT( __DZCO_CLASS_EXPORT, dzFreqResArray ){
+  int size;     /*!< number of samples */
+  int capacity; /*!< number of allocated samples */
+  double *f;    /*!< array of frequencies */
+  double *g;    /*!< array of gains */
+  double *p;    /*!< array of phase lags */
+  /*! \cond */
+  bool _slice;  /* true if the arrays are borrowed from another table */
+  /*! \endcond */
+};
+
+#define dzFreqResArraySize(a)    (a)->size
+#define dzFreqResArrayIsSlice(a) (a)->_slice
+
+/*! \brief initialize, reserve and destroy a table of frequency responses.
+ *
+ * dzFreqResArrayInit() initializes a table of frequency responses
+ * \a arr as an empty table.
+ *
+ * dzFreqResArrayReserve() enlarges the allocated memory of \a arr
+ * so as to store \a capacity samples without reallocation.
+ *
+ * dzFreqResArrayDestroy() frees the memory of \a arr. For a slice,
+ * it only makes \a arr empty.
+ * \return
+ * dzFreqResArrayInit() returns a pointer \a arr.
+ *
+ * dzFreqResArrayReserve() returns the false value if it fails to
+ * allocate memory or \a arr is a slice. Otherwise, the true value
+ * is returned.
+ *
+ * dzFreqResArrayDestroy() returns no value.
+ */
+__DZCO_EXPORT dzFreqResArray *dzFreqResArrayInit(dzFreqResArray *arr);
+__DZCO_EXPORT bool dzFreqResArrayReserve(dzFreqResArray *arr, int capacity);
+__DZCO_EXPORT void dzFreqResArrayDestroy(dzFreqResArray *arr);
+
+/*! \brief append a sample to a table of frequency responses.
+ *
+ * dzFreqResArrayAdd() appends a sample of frequency \a f, gain \a g
+ * and phase lag \a p to the tail of a table \a arr. The capacity
+ * of \a arr is doubled when it is full.
+ * \return
+ * dzFreqResArrayAdd() returns the false value if it fails to allocate
+ * memory or \a arr is a slice. Otherwise, the true value is returned.
+ */
+__DZCO_EXPORT bool dzFreqResArrayAdd(dzFreqResArray *arr, double f, double g, double p);
+
+/*! \brief slice a table of frequency responses.
+ *
+ * dzFreqResArraySlice() makes \a slice refer to the samples of a
+ * table \a arr from the \a from-th to the (\a to-1)-th. The indices
+ * are clamped into the range of \a arr.
+ *
+ * dzFreqResArraySliceFreq() makes \a slice refer to the samples of
+ * \a arr of which frequencies are between \a fmin and \a fmax. The
+ * samples of \a arr have to be sorted in ascending order of the
+ * frequency, since the range is found by binary search.
+ *
+ * A slice shares the memory with \a arr and is never reallocated.
+ * It becomes invalid once \a arr is reallocated or destroyed.
+ * \return
+ * dzFreqResArraySlice() and dzFreqResArraySliceFreq() return a
+ * pointer \a slice.
+ */
+__DZCO_EXPORT dzFreqResArray *dzFreqResArraySlice(dzFreqResArray *arr, int from, int to, dzFreqResArray *slice);
+__DZCO_EXPORT dzFreqResArray *dzFreqResArraySliceFreq(dzFreqResArray *arr, double fmin, double fmax, dzFreqResArray *slice);
+
+/*! \brief conversion of a table of frequency responses.
+ *
+ * dzFreqResArray2Closed() converts open-loop frequency responses in
+ * a table \a arr to those of the closed-loop system with unity
+ * feedback in place.
+ *
+ * dzFreqResArray2Open() converts closed-loop frequency responses in
+ * \a arr to those of the open-loop system in place.
+ *
+ * dzFreqResArrayConnectTF() connects a transfer function \a tf in
+ * series to frequency responses in \a arr in place. The frequency
+ * responses of \a tf are computed by dzFreqResGridFromTF() in blocks,
+ * where the phase lags are unwrapped continuously across the blocks.
+ * Since the phase lags are unwrapped along the frequency, this is done
+ * only if the samples of \a arr are sorted in ascending order of the
+ * frequency. Otherwise, the samples are evaluated one by one by
+ * dzFreqResFromTF().
+ * \return
+ * dzFreqResArray2Closed() and dzFreqResArray2Open() return a pointer
+ * \a arr.
+ *
+ * dzFreqResArrayConnectTF() returns a pointer \a arr if it succeeds.
+ * If it fails to compute the frequency responses of \a tf, the null
+ * pointer is returned.
+ * \sa
+ * dzFreqRes2Closed, dzFreqRes2Open, dzFreqResGridFromTF
+ */
+__DZCO_EXPORT dzFreqResArray *dzFreqResArray2Closed(dzFreqResArray *arr);
+__DZCO_EXPORT dzFreqResArray *dzFreqResArray2Open(dzFreqResArray *arr);
+__DZCO_EXPORT dzFreqResArray *dzFreqResArrayConnectTF(dzFreqResArray *arr, dzTF *tf);
+
+/*! \brief scan and print a table of frequency responses.
+ *
+ * dzFreqResArrayFScan() scans samples of frequency, gain and phase lag
+ * from the current position of a file \a fp and appends them to a
+ * table \a arr. Samples of which frequencies are out of the range
+ * between \a fmin and \a fmax are skipped.
+ *
+ * dzFreqResArrayFPrint() prints samples in \a arr of which
+ * frequencies are between \a fmin and \a fmax to \a fp.
+ *
+ * dzFreqResArrayScanFile() and dzFreqResArrayPrintFile() scan and
+ * print the samples from and to a file \a filename, respectively.
+ * \return
+ * dzFreqResArrayFScan() and dzFreqResArrayScanFile() return the size
+ * of \a arr.
+ *
+ * dzFreqResArrayFPrint() and dzFreqResArrayPrintFile() return the
+ * number of printed samples.
+ */
+__DZCO_EXPORT int dzFreqResArrayFScan(FILE *fp, dzFreqResArray *arr, double fmin, double fmax);
+__DZCO_EXPORT int dzFreqResArrayFPrint(FILE *fp, dzFreqResArray *arr, double fmin, double fmax);
+
+__DZCO_EXPORT int dzFreqResArrayScanFile(dzFreqResArray *arr, char filename[], double fmin, double fmax);
+__DZCO_EXPORT int dzFreqResArrayPrintFile(dzFreqResArray *arr, char filename[], double fmin, double fmax);
+
+/*! \brief streaming scan of frequency responses.
+ *
+ * dzFreqResFScanStream() scans samples of frequency, gain and phase
+ * lag from the current position of a file \a fp, and passes each
+ * sample of which frequency is between \a fmin and \a fmax to a
+ * callback function \a callback with a utility pointer \a util.
+ * The file is read by fixed-size chunks, and numbers are parsed by a
+ * scanner specialized for decimal numbers, which falls back to
+ * strtod() only for numbers that cannot be converted exactly and for
+ * hexadecimal floating-point numbers such as 0x1p-3. The
+ * whole file is never buffered. Scanning stops at the end of file,
+ * at an invalid token, or when \a callback returns the false value.
+ *
+ * dzFreqResScanFileStream() does the same for a file \a filename.
+ *
+ * dzFreqResArrayFScan() and dzFreqResArrayScanFile() are implemented
+ * on dzFreqResFScanStream().
+ * \return
+ * dzFreqResFScanStream() and dzFreqResScanFileStream() return the
+ * number of samples accepted by \a callback, namely, for which it
+ * returned the true value.
+ */
+__DZCO_EXPORT int dzFreqResFScanStream(FILE *fp, double fmin, double fmax, bool (* callback)(dzFreqRes*,void*), void *util);
+__DZCO_EXPORT int dzFreqResScanFileStream(char filename[], double fmin, double fmax, bool (* callback)(dzFreqRes*,void*), void *util);
+
 /* ********************************************************** */
 /*! \class dzFreqResList
  * list of sampled frequency responses
@@ -54,6 +231,31 @@ zListClass( dzFreqResList, dzFreqResListCell, dzFreqRes );
 
 #define dzFreqResListDestroy(list) zListDestroy( dzFreqResListCell, list )
 
+/*! \brief conversion between a list and a table of frequency responses.
+ *
+ * dzFreqResArrayFromList() appends all samples in a list \a list to
+ * a table \a arr.
+ *
+ * dzFreqResArrayToList() creates a list \a list of all samples in
+ * \a arr.
+ *
+ * dzFreqResList2Closed(), dzFreqResList2Open() and
+ * dzFreqResListConnectTF() create a list \a outlist of frequency
+ * responses converted from those in \a inlist cell by cell, without
+ * copying \a inlist to a table. dzFreqResListConnectTF() gathers
+ * frequencies of \a inlist in blocks for dzFreqResGridFromTF() if
+ * \a inlist is sorted in ascending order of the frequency, or evaluates
+ * them one by one otherwise, as dzFreqResArrayConnectTF() does.
+ * \return
+ * dzFreqResArrayFromList() returns the size of \a arr.
+ * dzFreqResArrayToList() returns the size of \a list.
+ *
+ * dzFreqResList2Closed(), dzFreqResList2Open() and
+ * dzFreqResListConnectTF() return the size of \a outlist.
+ */
+__DZCO_EXPORT int dzFreqResArrayFromList(dzFreqResArray *arr, dzFreqResList *list);
+__DZCO_EXPORT int dzFreqResArrayToList(dzFreqResArray *arr, dzFreqResList *list);
+
 __DZCO_EXPORT int dzFreqResList2Closed(dzFreqResList *inlist, dzFreqResList *outlist);
 __DZCO_EXPORT int dzFreqResList2Open(dzFreqResList *inlist, dzFreqResList *outlist);
 __DZCO_EXPORT int dzFreqResListConnectTF(dzFreqResList *inlist, dzTF *tf, dzFreqResList *outlist);
@@ -68,6 +270,20 @@ __DZCO_EXPORT int dzFreqResListPrintFile(dzFreqResList *list, char filename[], d
 /* identification of a transfer function from frequency response
  * ********************************************************** */
 
+/*! \brief identify a transfer function from frequency responses.
+ *
+ * dzTFIdentFromFreqResArray() identifies a transfer function \a tf
+ * of which numerator and denominator have dimensions \a nn and \a nd,
+ * respectively, from sampled frequency responses in a table \a arr.
+ * \a iter is the maximum number of iterations.
+ *
+ * dzTFIdentFromFreqRes() does the same from a list \a list.
+ * \return
+ * dzTFIdentFromFreqResArray() and dzTFIdentFromFreqRes() return a
+ * pointer \a tf if they succeed. Otherwise, the null pointer is
+ * returned.
+ */
+__DZCO_EXPORT dzTF *dzTFIdentFromFreqResArray(dzTF *tf, dzFreqResArray *arr, int nn, int nd, int iter);
 __DZCO_EXPORT dzTF *dzTFIdentFromFreqRes(dzTF *tf, dzFreqResList *list, int nn, int nd, int iter);
 
 __END_DECLS
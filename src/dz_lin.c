@@ -23,6 +23,9 @@ dzLin *dzLinInit(dzLin *lin)
   lin->b = lin->c = lin->x = NULL;
   lin->d = 0;
   lin->_ax = lin->_bu = NULL;
+  lin->_phi = lin->_psi = lin->_a = NULL;
+  lin->_gamma = lin->_b = NULL;
+  lin->_dt = 0;
   return lin;
 }
 
@@ -48,6 +51,7 @@ void dzLinDestroy(dzLin *lin)
 {
   _dzLinDestroy( lin );
   _dzLinDestroyODE( lin );
+  dzLinUnsetZOH( lin );
 }
 
 /* allocate internal working space of a linear system. */
@@ -90,9 +94,131 @@ static bool _dzLinCheckSize(dzLin *lin)
          zMatRowVecSizeEqual( lin->a, lin->c ) ? true : false;
 }
 
+/* switch a linear system to the exact zero-order-hold discretization. */
+bool dzLinSetZOH(dzLin *c)
+{
+  int dim;
+
+  if( dzLinIsZOH(c) ) return true;
+  dim = dzLinDim( c );
+  c->_phi = zMatAllocSqr( dim );
+  c->_psi = zMatAllocSqr( dim );
+  c->_gamma = zVecAlloc( dim );
+  c->_a = zMatAllocSqr( dim );
+  c->_b = zVecAlloc( dim );
+  c->_dt = 0; /* invalidate the cache */
+  if( !c->_phi || !c->_psi || !c->_gamma || !c->_a || !c->_b ){
+    ZALLOCERROR();
+    dzLinUnsetZOH( c );
+    return false;
+  }
+  return true;
+}
+
+/* switch a linear system back to the Runge-Kutta-Gill integration. */
+void dzLinUnsetZOH(dzLin *c)
+{
+  zMatFree( c->_phi );
+  zMatFree( c->_psi );
+  zVecFree( c->_gamma );
+  zMatFree( c->_a );
+  zVecFree( c->_b );
+  c->_phi = c->_psi = c->_a = NULL;
+  c->_gamma = c->_b = NULL;
+  c->_dt = 0;
+}
+
+/* exponential of a square matrix by scaling and squaring of Taylor series. */
+zMat dzMatExp(zMat m, zMat e)
+{
+#define DZ_LIN_EXP_ORDER 16
+  zMat x, tmp;
+  double norm;
+  int i, s;
+
+  x = zMatAllocSqr( zMatRowSizeNC(m) );
+  tmp = zMatAllocSqr( zMatRowSizeNC(m) );
+  if( !x || !tmp ){
+    e = NULL;
+    goto TERMINATE;
+  }
+  for( s=0, norm=zMatNorm(m); norm > 0.5; s++, norm*=0.5 );
+  zMatMulNC( m, ldexp( 1.0, -s ), x );
+  zMatIdent( e ); /* Horner's scheme: e = I + x e / i */
+  for( i=DZ_LIN_EXP_ORDER; i>0; i-- ){
+    zMulMatMatNC( x, e, tmp );
+    zMatDivDRC( tmp, i );
+    zMatIdent( e );
+    zMatAddNCDRC( e, tmp );
+  }
+  for( ; s>0; s-- ){
+    zMulMatMatNC( e, e, tmp );
+    zMatCopyNC( tmp, e );
+  }
+ TERMINATE:
+  zMatFree( x );
+  zMatFree( tmp );
+  return e;
+}
+
+/* discretize a linear system by zero-order hold, where
+ * exp( [ A I ; O O ] dt ) = [ Phi Psi ; O I ].
+ */
+bool dzLinDiscretize(dzLin *c, double dt)
+{
+  zMat m, e;
+  int i, j, dim;
+  bool ret = true;
+
+  if( !dzLinIsZOH(c) ) return false;
+  dim = dzLinDim( c );
+  m = zMatAllocSqr( 2*dim );
+  e = zMatAllocSqr( 2*dim );
+  if( !m || !e ){
+    ret = false;
+    goto TERMINATE;
+  }
+  for( i=0; i<dim; i++ ){
+    for( j=0; j<dim; j++ )
+      zMatSetElemNC( m, i, j, zMatElemNC(c->a,i,j)*dt );
+    zMatSetElemNC( m, i, dim+i, dt );
+  }
+  if( !dzMatExp( m, e ) ){
+    ret = false;
+    goto TERMINATE;
+  }
+  for( i=0; i<dim; i++ )
+    for( j=0; j<dim; j++ ){
+      zMatSetElemNC( c->_phi, i, j, zMatElemNC(e,i,j) );
+      zMatSetElemNC( c->_psi, i, j, zMatElemNC(e,i,dim+j) );
+    }
+  zMulMatVecNC( c->_psi, c->b, c->_gamma );
+  zMatCopyNC( c->a, c->_a );
+  zVecCopyNC( c->b, c->_b );
+  c->_dt = dt;
+ TERMINATE:
+  zMatFree( m );
+  zMatFree( e );
+  return ret;
+}
+
+/* update the cache of discretization if the sampling time, A or b is changed. */
+static bool _dzLinUpdateZOH(dzLin *c, double dt)
+{
+  if( c->_dt == dt &&
+      memcmp( zMatBuf(c->a), zMatBuf(c->_a), sizeof(double)*zMatRowSizeNC(c->a)*zMatColSizeNC(c->a) ) == 0 &&
+      memcmp( zVecBuf(c->b), zVecBuf(c->_b), sizeof(double)*zVecSizeNC(c->b) ) == 0 ) return true;
+  return dzLinDiscretize( c, dt );
+}
+
 /* update the inner state of linear system. */
 void dzLinStateUpdate(dzLin *c, double input, double dt)
 {
+  if( dzLinIsZOH(c) && _dzLinUpdateZOH( c, dt ) ){
+    zMulMatVecNC( c->_phi, c->x, c->_ax );
+    zVecCatNC( c->_ax, input, c->_gamma, c->x );
+    return;
+  }
   zVecMul( c->b, input, c->_bu );
   zODEUpdate( &c->_ode, 0, c->x, dt, c );
 }
@@ -100,6 +226,13 @@ void dzLinStateUpdate(dzLin *c, double input, double dt)
 /* update the inner state of linear observer. */
 void dzLinObsUpdate(dzLin *c, zVec k, double input, double error, double dt)
 {
+  if( dzLinIsZOH(c) && _dzLinUpdateZOH( c, dt ) ){
+    zMulMatVecNC( c->_phi, c->x, c->_ax );
+    zVecCatNCDRC( c->_ax, input, c->_gamma );
+    zMulMatVecNC( c->_psi, k, c->_bu );
+    zVecCatNC( c->_ax, -error, c->_bu, c->x );
+    return;
+  }
   zVecMul( c->b, input, c->_bu );
   zVecCatDRC( c->_bu, -error, k );
   zODEUpdate( &c->_ode, 0, c->x, dt, c );
@@ -404,33 +537,283 @@ zMat dzLinRiccatiSolveKleinman(zMat p, zVec f, dzLin *c, zMat q, double r, doubl
   return p;
 }
 
-/* linear quadratic optimal regulator. */
-zVec dzLinLQR(dzLin *c, zVec q, double r, zVec f)
+/* solve Riccati's equation by the matrix sign function of the Hamiltonian matrix. */
+zMat dzLinRiccatiSolveSign(zMat p, zVec f, dzLin *c, zMat q, double r, double tol, int iter)
+{
+  zMat h, hinv, m, mtm, mtn;
+  double scale, diff, val;
+  int i, j, k, n;
+
+  n = dzLinDim(c);
+  h = zMatAllocSqr( 2*n );
+  hinv = zMatAllocSqr( 2*n );
+  m = zMatAlloc( 2*n, n );
+  mtm = zMatAllocSqr( n );
+  mtn = zMatAllocSqr( n );
+  if( !h || !hinv || !m || !mtm || !mtn ){
+    p = NULL;
+    goto TERMINATE;
+  }
+  /* Hamiltonian matrix [ A -b b^T/r ; -Q -A^T ] */
+  for( i=0; i<n; i++ )
+    for( j=0; j<n; j++ ){
+      zMatSetElemNC( h, i, j, zMatElemNC(c->a,i,j) );
+      zMatSetElemNC( h, i, n+j, -zVecElemNC(c->b,i)*zVecElemNC(c->b,j)/r );
+      zMatSetElemNC( h, n+i, j, -zMatElemNC(q,i,j) );
+      zMatSetElemNC( h, n+i, n+j, -zMatElemNC(c->a,j,i) );
+    }
+  /* Newton's iteration with determinant scaling: H <- ( s H + (s H)^-1 ) / 2 */
+  ZITERINIT( iter );
+  for( i=0; ; i++ ){
+    if( !zMatInv( h, hinv ) ){
+      p = NULL;
+      goto TERMINATE;
+    }
+    scale = pow( fabs( zMatDet( h ) ), -0.5/n );
+    if( !zIsInf( scale ) && !zIsNan( scale ) && scale > 0 ){
+      zMatMulDRC( h, scale );
+      zMatDivDRC( hinv, scale );
+    }
+    zMatSubNCDRC( hinv, h );
+    diff = zMatNorm( hinv ) / zMatNorm( h ); /* norm of the correction */
+    zMatCatNCDRC( h, 0.5, hinv );
+    if( diff < tol ) break;
+    if( i >= iter ){
+      ZITERWARN( iter );
+      break;
+    }
+  }
+  /* solve [ W12 ; W22+I ] P = -[ W11+I ; W21 ] in the least-square sense */
+  for( i=0; i<2*n; i++ )
+    for( j=0; j<n; j++ ){
+      zMatSetElemNC( m, i, j, zMatElemNC(h,i,n+j) + ( i == n+j ? 1 : 0 ) );
+      zMatSetElemNC( hinv, i, j, -zMatElemNC(h,i,j) - ( i == j ? 1 : 0 ) );
+    }
+  zMulMatTMatNC( m, m, mtm );
+  for( i=0; i<n; i++ ) /* M^T N, N being the left half of hinv */
+    for( j=0; j<n; j++ ){
+      for( val=0, k=0; k<2*n; k++ )
+        val += zMatElemNC(m,k,i) * zMatElemNC(hinv,k,j);
+      zMatSetElemNC( mtn, i, j, val );
+    }
+  if( !zMulInvMatMat( mtm, mtn, p ) ){
+    p = NULL;
+    goto TERMINATE;
+  }
+  for( i=0; i<n; i++ ) /* symmetrize */
+    for( j=i+1; j<n; j++ ){
+      val = 0.5 * ( zMatElemNC(p,i,j) + zMatElemNC(p,j,i) );
+      zMatSetElemNC( p, i, j, val );
+      zMatSetElemNC( p, j, i, val );
+    }
+  if( f ){
+    zMulMatTVec( p, c->b, f );
+    zVecDivDRC( f, r );
+  }
+ TERMINATE:
+  zMatFreeAtOnce( 5, h, hinv, m, mtm, mtn );
+  return p;
+}
+
+/* linear quadratic optimal regulator with a specified Riccati equation solver. */
+zVec dzLinLQRMethod(dzLin *c, zVec q, double r, zVec f, dzRiccatiMethod method)
 {
-  zMat _q, _r, _p;
+  zMat _q, _p;
 
   _p = zMatAllocSqr( dzLinDim(c) );
   _q = zMatAllocSqr( dzLinDim(c) );
-  _r = zMatAllocSqr( dzLinDim(c) );
-  if( !_p || !_q || !_r || !zMatDiag( _q, q ) ){
+  if( !_p || !_q || !zMatDiag( _q, q ) ){
     f = NULL;
     goto TERMINATE;
   }
-  zVecDyad( c->b, c->b, _r );
-  zMatDivDRC( _r, r );
-  if( !dzLinRiccatiSolveKleinman( _p, f, c, _q, r, zTOL, 0 ) ){
+  switch( method ){
+  case DZ_RICCATI_SIGN: /* falls back to Euler's method if failing */
+    if( dzLinRiccatiSolveSign( _p, f, c, _q, r, zTOL, 0 ) ) break;
+    /* fall through */
+  case DZ_RICCATI_EULER:
     if( !dzLinRiccatiSolveEuler( _p, c, _q, r, zTOL, 0 ) ){
       f = NULL;
       goto TERMINATE;
     }
     zMulMatTVec( _p, c->b, f );
     zVecDivDRC( f, r );
+    break;
+  case DZ_RICCATI_KLEINMAN:
+  default:
+    if( !dzLinRiccatiSolveKleinman( _p, f, c, _q, r, zTOL, 0 ) ){
+      if( !dzLinRiccatiSolveEuler( _p, c, _q, r, zTOL, 0 ) ){
+        f = NULL;
+        goto TERMINATE;
+      }
+      zMulMatTVec( _p, c->b, f );
+      zVecDivDRC( f, r );
+    }
   }
 
  TERMINATE:
   zMatFree( _p );
   zMatFree( _q );
-  zMatFree( _r );
+  return f;
+}
+
+/* linear quadratic optimal regulator. */
+zVec dzLinLQR(dzLin *c, zVec q, double r, zVec f)
+{
+  return dzLinLQRMethod( c, q, r, f, DZ_RICCATI_KLEINMAN );
+}
+
+/* solve discrete-time Riccati's equation by the structure-preserving doubling algorithm. */
+zMat dzLinDRiccatiSolveSDA(zMat p, zVec f, zMat phi, zVec gamma, zMat q, double r, double tol, int iter)
+{
+  zMat a, g, w, wa, wg, tmp;
+  zVec pg;
+  double err;
+  int i, n;
+
+  n = zMatRowSizeNC(phi);
+  a = zMatClone( phi );
+  g = zMatAllocSqr( n );
+  w = zMatAllocSqr( n );
+  wa = zMatAllocSqr( n );
+  wg = zMatAllocSqr( n );
+  tmp = zMatAllocSqr( n );
+  pg = zVecAlloc( n );
+  if( !a || !g || !w || !wa || !wg || !tmp || !pg ){
+    p = NULL;
+    goto TERMINATE;
+  }
+  zVecDyad( gamma, gamma, g );
+  zMatDivDRC( g, r );
+  zMatCopyNC( q, p );
+  ZITERINIT( iter );
+  for( i=0; ; i++ ){
+    /* W = I + G H */
+    zMulMatMatNC( g, p, w );
+    zMatIdent( tmp );
+    zMatAddNCDRC( w, tmp );
+    if( !zMulInvMatMat( w, a, wa ) || !zMulInvMatMat( w, g, wg ) ){
+      p = NULL;
+      goto TERMINATE;
+    }
+    /* H <- H + A^T H W^-1 A */
+    zMulMatMatNC( p, wa, w );
+    zMulMatTMatNC( a, w, tmp );
+    zMatAddNCDRC( p, tmp );
+    err = zMatNorm( tmp );
+    /* G <- G + A W^-1 G A^T */
+    zMulMatMatNC( a, wg, w );
+    zMulMatMatTNC( w, a, tmp );
+    zMatAddNCDRC( g, tmp );
+    /* A <- A W^-1 A */
+    zMulMatMatNC( a, wa, tmp );
+    zMatCopyNC( tmp, a );
+    if( err < tol * ( 1 + zMatNorm( p ) ) ) break;
+    if( i >= iter ){
+      ZITERWARN( iter );
+      break;
+    }
+  }
+  if( f ){ /* f = ( r + gamma^T P gamma )^-1 gamma^T P phi */
+    zMulMatVecNC( p, gamma, pg );
+    zMulMatTVecNC( phi, pg, f );
+    zVecDivDRC( f, r + zVecInnerProd( gamma, pg ) );
+  }
+ TERMINATE:
+  zMatFreeAtOnce( 6, a, g, w, wa, wg, tmp );
+  zVecFree( pg );
+  return p;
+}
+
+/* discrete-time linear quadratic optimal regulator. */
+zVec dzLinDLQR(dzLin *c, zVec q, double r, double dt, zVec f)
+{
+  zMat _q, _p;
+  bool zoh;
+
+  zoh = dzLinIsZOH(c);
+  _p = zMatAllocSqr( dzLinDim(c) );
+  _q = zMatAllocSqr( dzLinDim(c) );
+  if( !_p || !_q || !zMatDiag( _q, q ) ||
+      ( !zoh && !dzLinSetZOH( c ) ) ){
+    f = NULL;
+    goto TERMINATE;
+  }
+  if( !dzLinDiscretize( c, dt ) ||
+      !dzLinDRiccatiSolveSDA( _p, f, c->_phi, c->_gamma, _q, r, zTOL, 0 ) ) f = NULL;
+  if( !zoh ) dzLinUnsetZOH( c );
+ TERMINATE:
+  zMatFree( _p );
+  zMatFree( _q );
+  return f;
+}
+
+/* ********************************************************** */
+/* gain scheduling table
+ * ********************************************************** */
+
+/* initialize a gain scheduling table. */
+dzLinGainTable *dzLinGainTableInit(dzLinGainTable *tab)
+{
+  tab->min = tab->max = 0;
+  tab->gain = NULL;
+  return tab;
+}
+
+/* create a gain scheduling table. */
+dzLinGainTable *dzLinGainTableCreate(dzLinGainTable *tab, double min, double max, int num, int dim, zVec (* gain)(double,void*,zVec), void *util)
+{
+  zVec f;
+  int i;
+
+  dzLinGainTableInit( tab );
+  if( num < 2 || max <= min ){
+    ZRUNERROR( DZ_ERR_LIN_INVALID_GAINTABLE );
+    return NULL;
+  }
+  tab->min = min;
+  tab->max = max;
+  if( !( tab->gain = zMatAlloc( num, dim ) ) ) return NULL;
+  if( !( f = zVecAlloc( dim ) ) ){
+    dzLinGainTableDestroy( tab );
+    return NULL;
+  }
+  for( i=0; i<num; i++ ){
+    if( !gain( min + ( max - min ) * i / ( num - 1 ), util, f ) ){
+      dzLinGainTableDestroy( tab );
+      tab = NULL;
+      break;
+    }
+    zMatPutRowNC( tab->gain, i, f );
+  }
+  zVecFree( f );
+  return tab;
+}
+
+/* destroy a gain scheduling table. */
+void dzLinGainTableDestroy(dzLinGainTable *tab)
+{
+  zMatFree( tab->gain );
+  dzLinGainTableInit( tab );
+}
+
+/* interpolate a gain scheduling table. */
+zVec dzLinGainTableInterp(dzLinGainTable *tab, double s, zVec f)
+{
+  double r, *g0, *g1;
+  int i, j;
+
+  r = ( s - tab->min ) / ( tab->max - tab->min ) * ( dzLinGainTableNum(tab) - 1 );
+  if( r <= 0 ){
+    i = 0; r = 0;
+  } else
+  if( r >= dzLinGainTableNum(tab) - 1 ){
+    i = dzLinGainTableNum(tab) - 2; r = 1;
+  } else
+    r -= ( i = (int)r );
+  g0 = zMatRowBufNC( tab->gain, i );
+  g1 = zMatRowBufNC( tab->gain, i+1 );
+  for( j=0; j<zVecSizeNC(f); j++ )
+    zVecSetElemNC( f, j, g0[j] + r * ( g1[j] - g0[j] ) );
   return f;
 }
 
@@ -538,6 +921,10 @@ static void *_dzLinDFromZTK(void *obj, int i, void *arg, ZTK *ztk){
   ((dzLin*)obj)->d = ZTKDouble(ztk);
   return obj;
 }
+static void *_dzLinDiscretizeFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  *(bool*)arg = ZTKValCmp( ztk, "zoh" );
+  return obj;
+}
 
 static bool _dzLinAFPrintZTK(FILE *fp, int i, void *prp){
   zMatFPrint( fp, ((dzLin*)prp)->a );
@@ -561,12 +948,15 @@ static const ZTKPrp __ztk_prp_dzlin[] = {
   { ZTK_KEY_DZCO_LIN_B, 1, _dzLinBFromZTK, _dzLinBFPrintZTK },
   { ZTK_KEY_DZCO_LIN_C, 1, _dzLinCFromZTK, _dzLinCFPrintZTK },
   { ZTK_KEY_DZCO_LIN_D, 1, _dzLinDFromZTK, _dzLinDFPrintZTK },
+  { ZTK_KEY_DZCO_LIN_DISCRETIZE, 1, _dzLinDiscretizeFromZTK, NULL },
 };
 
 dzLin *dzLinFromZTK(dzLin *lin, ZTK *ztk)
 {
+  bool zoh = false;
+
   dzLinInit( lin );
-  if( !_ZTKEvalKey( lin, NULL, ztk, __ztk_prp_dzlin ) ) return NULL;
+  if( !_ZTKEvalKey( lin, &zoh, ztk, __ztk_prp_dzlin ) ) return NULL;
   if( !lin->a || !lin->b || !lin->c ){
     _dzLinDestroy( lin );
     return NULL;
@@ -576,7 +966,8 @@ dzLin *dzLinFromZTK(dzLin *lin, ZTK *ztk)
     return NULL;
   }
   if( !( lin->x = zVecAlloc( zVecSize(lin->c) ) ) ||
-      !_dzLinAllocODE( lin ) ){
+      !_dzLinAllocODE( lin ) ||
+      ( zoh && !dzLinSetZOH( lin ) ) ){
     _dzLinDestroy( lin );
     return NULL;
   }
@@ -586,4 +977,7 @@ dzLin *dzLinFromZTK(dzLin *lin, ZTK *ztk)
 void dzLinFPrintZTK(FILE *fp, dzLin *lin)
 {
   _ZTKPrpKeyFPrint( fp, lin, __ztk_prp_dzlin );
+  /* the default discretization is omitted for compatibility */
+  if( dzLinIsZOH(lin) )
+    fprintf( fp, "%s: zoh\n", ZTK_KEY_DZCO_LIN_DISCRETIZE );
 }
@@ -0,0 +1,477 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_lin_mimo - multi-input multi-output linear system
+ */
+
+#include <dzco/dz_lin_mimo.h>
+
+/* compute state velocity. */
+static zVec __dz_lin_mimo_state_dif(double t, zVec x, void *sys, zVec dx)
+{
+  dzLinMIMO *lin;
+
+  lin = (dzLinMIMO *)sys;
+  zMulMatVec( lin->a, x, lin->_ax );
+  return zVecAdd( lin->_ax, lin->_bu, dx );
+}
+
+/* initialize a multi-input multi-output linear system. */
+dzLinMIMO *dzLinMIMOInit(dzLinMIMO *lin)
+{
+  lin->a = lin->b = lin->c = lin->d = NULL;
+  lin->x = NULL;
+  lin->_u = lin->_ax = lin->_bu = NULL;
+  lin->_phi = lin->_psi = lin->_gamma = lin->_a = lin->_b = NULL;
+  lin->_dt = 0;
+  return lin;
+}
+
+/* destroy internal working space of a multi-input multi-output linear system. */
+static void _dzLinMIMODestroyODE(dzLinMIMO *lin)
+{
+  zVecFree( lin->_u );
+  zVecFree( lin->_ax );
+  zVecFree( lin->_bu );
+  zODEDestroy( &lin->_ode );
+}
+
+/* destroy working space of a multi-input multi-output linear system. */
+static void _dzLinMIMODestroy(dzLinMIMO *lin)
+{
+  zMatFree( lin->a );
+  zMatFree( lin->b );
+  zMatFree( lin->c );
+  zMatFree( lin->d );
+  zVecFree( lin->x );
+}
+
+/* destroy a multi-input multi-output linear system. */
+void dzLinMIMODestroy(dzLinMIMO *lin)
+{
+  _dzLinMIMODestroy( lin );
+  _dzLinMIMODestroyODE( lin );
+  dzLinMIMOUnsetZOH( lin );
+}
+
+/* allocate internal working space of a multi-input multi-output linear system. */
+static bool _dzLinMIMOAllocODE(dzLinMIMO *lin)
+{
+  int dim;
+
+  dim = dzLinMIMODim( lin );
+  lin->_u = zVecAlloc( dzLinMIMOInputSize(lin) );
+  lin->_ax = zVecAlloc( dim );
+  lin->_bu = zVecAlloc( dim );
+  zODEAssign( &lin->_ode, RKG, NULL, NULL ); /* Runge-Kutta-Gill's method */
+  if( !lin->_u || !lin->_ax || !lin->_bu ||
+      !zODEInit( &lin->_ode, dim, 0, __dz_lin_mimo_state_dif ) ){
+    _dzLinMIMODestroyODE( lin );
+    return false;
+  }
+  return true;
+}
+
+/* allocate working space of a multi-input multi-output linear system. */
+bool dzLinMIMOAlloc(dzLinMIMO *lin, int dim, int m, int p)
+{
+  dzLinMIMOInit( lin );
+  lin->a = zMatAllocSqr( dim );
+  lin->b = zMatAlloc( dim, m );
+  lin->c = zMatAlloc( p, dim );
+  lin->d = zMatAlloc( p, m );
+  lin->x = zVecAlloc( dim );
+  if( !lin->a || !lin->b || !lin->c || !lin->d || !lin->x || !_dzLinMIMOAllocODE( lin ) ){
+    _dzLinMIMODestroy( lin );
+    return false;
+  }
+  return true;
+}
+
+/* check size consistency of a multi-input multi-output linear system. */
+static bool _dzLinMIMOCheckSize(dzLinMIMO *lin)
+{
+  return zMatIsSqr( lin->a ) &&
+         zMatRowSize(lin->a) == zMatRowSize(lin->b) &&
+         zMatColSize(lin->a) == zMatColSize(lin->c) &&
+         zMatRowSize(lin->c) == zMatRowSize(lin->d) &&
+         zMatColSize(lin->b) == zMatColSize(lin->d) ? true : false;
+}
+
+/* switch a multi-input multi-output linear system to the exact zero-order-hold discretization. */
+bool dzLinMIMOSetZOH(dzLinMIMO *c)
+{
+  int dim;
+
+  if( dzLinMIMOIsZOH(c) ) return true;
+  dim = dzLinMIMODim( c );
+  c->_phi = zMatAllocSqr( dim );
+  c->_psi = zMatAllocSqr( dim );
+  c->_gamma = zMatAlloc( dim, dzLinMIMOInputSize(c) );
+  c->_a = zMatAllocSqr( dim );
+  c->_b = zMatAlloc( dim, dzLinMIMOInputSize(c) );
+  c->_dt = 0; /* invalidate the cache */
+  if( !c->_phi || !c->_psi || !c->_gamma || !c->_a || !c->_b ){
+    ZALLOCERROR();
+    dzLinMIMOUnsetZOH( c );
+    return false;
+  }
+  return true;
+}
+
+/* switch a multi-input multi-output linear system back to the Runge-Kutta-Gill integration. */
+void dzLinMIMOUnsetZOH(dzLinMIMO *c)
+{
+  zMatFree( c->_phi );
+  zMatFree( c->_psi );
+  zMatFree( c->_gamma );
+  zMatFree( c->_a );
+  zMatFree( c->_b );
+  c->_phi = c->_psi = c->_gamma = c->_a = c->_b = NULL;
+  c->_dt = 0;
+}
+
+/* discretize a multi-input multi-output linear system by zero-order hold. */
+bool dzLinMIMODiscretize(dzLinMIMO *c, double dt)
+{
+  zMat m, e;
+  int i, j, dim;
+  bool ret = true;
+
+  if( !dzLinMIMOIsZOH(c) ) return false;
+  dim = dzLinMIMODim( c );
+  m = zMatAllocSqr( 2*dim );
+  e = zMatAllocSqr( 2*dim );
+  if( !m || !e ){
+    ret = false;
+    goto TERMINATE;
+  }
+  for( i=0; i<dim; i++ ){
+    for( j=0; j<dim; j++ )
+      zMatSetElemNC( m, i, j, zMatElemNC(c->a,i,j)*dt );
+    zMatSetElemNC( m, i, dim+i, dt );
+  }
+  if( !dzMatExp( m, e ) ){
+    ret = false;
+    goto TERMINATE;
+  }
+  for( i=0; i<dim; i++ )
+    for( j=0; j<dim; j++ ){
+      zMatSetElemNC( c->_phi, i, j, zMatElemNC(e,i,j) );
+      zMatSetElemNC( c->_psi, i, j, zMatElemNC(e,i,dim+j) );
+    }
+  zMulMatMatNC( c->_psi, c->b, c->_gamma );
+  zMatCopyNC( c->a, c->_a );
+  zMatCopyNC( c->b, c->_b );
+  c->_dt = dt;
+ TERMINATE:
+  zMatFree( m );
+  zMatFree( e );
+  return ret;
+}
+
+/* update the cache of discretization if the sampling time, A or B is changed. */
+static bool _dzLinMIMOUpdateZOH(dzLinMIMO *c, double dt)
+{
+  if( c->_dt == dt &&
+      memcmp( zMatBuf(c->a), zMatBuf(c->_a), sizeof(double)*zMatRowSizeNC(c->a)*zMatColSizeNC(c->a) ) == 0 &&
+      memcmp( zMatBuf(c->b), zMatBuf(c->_b), sizeof(double)*zMatRowSizeNC(c->b)*zMatColSizeNC(c->b) ) == 0 ) return true;
+  return dzLinMIMODiscretize( c, dt );
+}
+
+/* update the inner state of a multi-input multi-output linear system. */
+void dzLinMIMOStateUpdate(dzLinMIMO *c, zVec input, double dt)
+{
+  if( dzLinMIMOIsZOH(c) && _dzLinMIMOUpdateZOH( c, dt ) ){
+    zMulMatVecNC( c->_phi, c->x, c->_ax );
+    zMulMatVecNC( c->_gamma, input, c->_bu );
+    zVecAddNC( c->_ax, c->_bu, c->x );
+    return;
+  }
+  zMulMatVecNC( c->b, input, c->_bu );
+  zODEUpdate( &c->_ode, 0, c->x, dt, c );
+}
+
+/* update the inner state of a multi-input multi-output linear observer. */
+void dzLinMIMOObsUpdate(dzLinMIMO *c, zMat k, zVec input, zVec error, double dt)
+{
+  zMulMatVecNC( c->b, input, c->_bu );
+  zMulMatVecNC( k, error, c->_ax );
+  zVecSubNCDRC( c->_bu, c->_ax );
+  if( dzLinMIMOIsZOH(c) && _dzLinMIMOUpdateZOH( c, dt ) ){
+    zMulMatVecNC( c->_phi, c->x, c->_ax );
+    zMulMatVecNC( c->_psi, c->_bu, c->x );
+    zVecAddNCDRC( c->x, c->_ax );
+    return;
+  }
+  zODEUpdate( &c->_ode, 0, c->x, dt, c );
+}
+
+/* output of a multi-input multi-output linear system. */
+zVec dzLinMIMOOutput(dzLinMIMO *c, zVec input, zVec output)
+{
+  int i;
+
+  zMulMatVecNC( c->c, c->x, output );
+  for( i=0; i<dzLinMIMOOutputSize(c); i++ )
+    zVecElemNC(output,i) += zRawVecInnerProd( zMatRowBuf(c->d,i), zVecBuf(input), dzLinMIMOInputSize(c) );
+  return output;
+}
+
+/* state feedback for a multi-input multi-output linear system. */
+zVec dzLinMIMOStateFeedback(dzLinMIMO *c, zVec ref, zMat f, zVec input)
+{
+  if( ref )
+    zVecSubNC( ref, c->x, c->_ax );
+  else
+    zVecRevNC( c->x, c->_ax );
+  return zMulMatVecNC( f, c->_ax, input );
+}
+
+/* pole assignment of a single-input system (A, B h) with a random
+ * vector h, where the resultant gain matrix is h g^T. If dual is
+ * true, the dual system (A^T, C^T h) is used instead, and the gain
+ * matrix is g h^T.
+ */
+static zMat _dzLinMIMOPoleAssignRand(dzLinMIMO *c, zVec pole, zMat f, bool dual)
+{
+#define DZ_LIN_MIMO_TRIAL_NUM 10
+  dzLin siso;
+  zVec h;
+  int i;
+
+  if( !dzLinAlloc( &siso, dzLinMIMODim(c) ) ) return NULL;
+  if( !( h = zVecAlloc( dual ? dzLinMIMOOutputSize(c) : dzLinMIMOInputSize(c) ) ) ){
+    f = NULL;
+    goto TERMINATE;
+  }
+  if( dual )
+    zMatTNC( c->a, siso.a );
+  else
+    zMatCopyNC( c->a, siso.a );
+  for( i=0; i<DZ_LIN_MIMO_TRIAL_NUM; i++ ){
+    zVecRandUniform( h, -1, 1 );
+    if( dual )
+      zMulMatTVecNC( c->c, h, siso.b );
+    else
+      zMulMatVecNC( c->b, h, siso.b );
+    if( dzLinIsCtrl( &siso ) && dzLinPoleAssign( &siso, pole, siso.c ) ){
+      if( dual )
+        zVecDyad( siso.c, h, f );
+      else
+        zVecDyad( h, siso.c, f );
+      goto TERMINATE;
+    }
+  }
+  ZRUNERROR( DZ_ERR_LIN_UNASSIGNABLE_POLE );
+  f = NULL;
+ TERMINATE:
+  zVecFree( h );
+  dzLinDestroy( &siso );
+  return f;
+}
+
+/* residual matrix of Riccati equation of a multi-input multi-output linear system.
+ * (working memories are manually provided.)
+ */
+static double _dzLinMIMORiccatiErrorDRC(zMat p, dzLinMIMO *c, zMat q, zVec r, zMat res, zMat tmp, zMat bp, zMat rbp)
+{
+  int i;
+
+  zMulMatTMatNC( c->b, p, bp );
+  zMatCopyNC( bp, rbp );
+  for( i=0; i<zVecSizeNC(r); i++ )
+    zRawVecDivDRC( zMatRowBuf(rbp,i), zVecElemNC(r,i), zMatColSizeNC(rbp) );
+  zMulMatMatNC( p, c->a, res );
+  zMulMatTMatNC( c->a, p, tmp );
+  zMatAddNCDRC( res, tmp );
+  zMatAddNCDRC( res, q );
+  zMulMatTMatNC( bp, rbp, tmp );
+  zMatSubNCDRC( res, tmp );
+  return zMatNorm( res );
+}
+
+/* residual matrix of Riccati equation of a multi-input multi-output linear system. */
+double dzLinMIMORiccatiError(zMat p, dzLinMIMO *c, zMat q, zVec r, zMat e)
+{
+  zMat tmp, res, bp, rbp;
+  double err = HUGE_VAL;
+
+  tmp = zMatAllocSqr( zMatRowSizeNC(p) );
+  res = e ? e : zMatAllocSqr( zMatRowSizeNC(p) );
+  bp = zMatAlloc( dzLinMIMOInputSize(c), dzLinMIMODim(c) );
+  rbp = zMatAlloc( dzLinMIMOInputSize(c), dzLinMIMODim(c) );
+  if( tmp && res && bp && rbp )
+    err = _dzLinMIMORiccatiErrorDRC( p, c, q, r, res, tmp, bp, rbp );
+  if( !e ) zMatFree( res );
+  zMatFreeAtOnce( 3, tmp, bp, rbp );
+  return err;
+}
+
+/* solve Riccati's equation of a multi-input multi-output linear system by Kleinman's method (1967). */
+zMat dzLinMIMORiccatiSolveKleinman(zMat p, zMat f, dzLinMIMO *c, zMat q, zVec r, double tol, int iter)
+{
+  int i, j;
+  zMat ae, qe, bp, rf, _f;
+  zVec pole;
+  double err, err_old = HUGE_VAL;
+  double mag;
+
+  ae = zMatAllocSqr( zMatRowSizeNC(p) );
+  qe = zMatAllocSqr( zMatRowSizeNC(p) );
+  bp = zMatAlloc( dzLinMIMOInputSize(c), dzLinMIMODim(c) );
+  rf = zMatAlloc( dzLinMIMOInputSize(c), dzLinMIMODim(c) );
+  _f = f ? f : zMatAlloc( dzLinMIMOInputSize(c), dzLinMIMODim(c) );
+  pole = zVecAlloc( dzLinMIMODim(c) );
+  if( !ae || !qe || !bp || !rf || !_f || !pole ){
+    p = NULL;
+    goto TERMINATE;
+  }
+  ZITERINIT( iter );
+  /* initial value */
+  mag = zMax( zMatNorm( c->a ), 1.0 );
+  zVecLinSpace( pole, -mag, -2*mag );
+  if( !_dzLinMIMOPoleAssignRand( c, pole, _f, false ) ){
+    p = NULL;
+    goto TERMINATE;
+  }
+  for( i=0; ; i++ ){
+    zMulMatMatNC( c->b, _f, ae );
+    zMatSubNC( c->a, ae, ae );
+    zMatCopyNC( _f, rf );
+    for( j=0; j<zVecSizeNC(r); j++ )
+      zRawVecMulDRC( zMatRowBuf(rf,j), zVecElemNC(r,j), zMatColSizeNC(rf) );
+    zMulMatTMatNC( _f, rf, qe );
+    zMatAddNCDRC( qe, q );
+    zMatRevNC( qe, qe );
+    zLELyapnovSolve( ae, qe, p );
+    zMulMatTMatNC( c->b, p, _f );
+    for( j=0; j<zVecSizeNC(r); j++ )
+      zRawVecDivDRC( zMatRowBuf(_f,j), zVecElemNC(r,j), zMatColSizeNC(_f) );
+    err = _dzLinMIMORiccatiErrorDRC( p, c, q, r, ae, qe, bp, rf );
+    if( fabs( err - err_old ) < tol ) break;
+    err_old = err;
+    if( i >= iter ){
+      ZITERWARN( iter );
+      break;
+    }
+  }
+ TERMINATE:
+  zMatFreeAtOnce( 4, ae, qe, bp, rf );
+  zVecFree( pole );
+  if( !f ) zMatFree( _f );
+  return p;
+}
+
+/* linear quadratic optimal regulator of a multi-input multi-output linear system. */
+zMat dzLinMIMOLQR(dzLinMIMO *c, zVec q, zVec r, zMat f)
+{
+  zMat _q, _p;
+
+  _p = zMatAllocSqr( dzLinMIMODim(c) );
+  _q = zMatAllocSqr( dzLinMIMODim(c) );
+  if( !_p || !_q || !zMatDiag( _q, q ) ||
+      !dzLinMIMORiccatiSolveKleinman( _p, f, c, _q, r, zTOL, 0 ) ) f = NULL;
+  zMatFree( _p );
+  zMatFree( _q );
+  return f;
+}
+
+/* creation of observer of a multi-input multi-output linear system. */
+zMat dzLinMIMOCreateObs(dzLinMIMO *c, zVec pole, zMat k)
+{
+  return _dzLinMIMOPoleAssignRand( c, pole, k, true );
+}
+
+/* conversion from a single-input single-output linear system. */
+dzLinMIMO *dzLin2LinMIMO(dzLin *lin, dzLinMIMO *mimo)
+{
+  if( !dzLinMIMOAlloc( mimo, dzLinDim(lin), 1, 1 ) ) return NULL;
+  zMatCopyNC( lin->a, mimo->a );
+  zMatPutColNC( mimo->b, 0, lin->b );
+  zMatPutRowNC( mimo->c, 0, lin->c );
+  zMatSetElemNC( mimo->d, 0, 0, lin->d );
+  zVecCopyNC( lin->x, mimo->x );
+  return mimo;
+}
+
+/* ZTK */
+
+static void *_dzLinMIMOAFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return ( ((dzLinMIMO*)obj)->a = zMatFromZTK( ztk ) ) ? obj : NULL;
+}
+static void *_dzLinMIMOBFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return ( ((dzLinMIMO*)obj)->b = zMatFromZTK( ztk ) ) ? obj : NULL;
+}
+static void *_dzLinMIMOCFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return ( ((dzLinMIMO*)obj)->c = zMatFromZTK( ztk ) ) ? obj : NULL;
+}
+static void *_dzLinMIMODFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return ( ((dzLinMIMO*)obj)->d = zMatFromZTK( ztk ) ) ? obj : NULL;
+}
+static void *_dzLinMIMODiscretizeFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  *(bool*)arg = ZTKValCmp( ztk, "zoh" );
+  return obj;
+}
+
+static bool _dzLinMIMOAFPrintZTK(FILE *fp, int i, void *prp){
+  zMatFPrint( fp, ((dzLinMIMO*)prp)->a );
+  return true;
+}
+static bool _dzLinMIMOBFPrintZTK(FILE *fp, int i, void *prp){
+  zMatFPrint( fp, ((dzLinMIMO*)prp)->b );
+  return true;
+}
+static bool _dzLinMIMOCFPrintZTK(FILE *fp, int i, void *prp){
+  zMatFPrint( fp, ((dzLinMIMO*)prp)->c );
+  return true;
+}
+static bool _dzLinMIMODFPrintZTK(FILE *fp, int i, void *prp){
+  zMatFPrint( fp, ((dzLinMIMO*)prp)->d );
+  return true;
+}
+
+static const ZTKPrp __ztk_prp_dzlinmimo[] = {
+  { ZTK_KEY_DZCO_LIN_A, 1, _dzLinMIMOAFromZTK, _dzLinMIMOAFPrintZTK },
+  { ZTK_KEY_DZCO_LIN_B, 1, _dzLinMIMOBFromZTK, _dzLinMIMOBFPrintZTK },
+  { ZTK_KEY_DZCO_LIN_C, 1, _dzLinMIMOCFromZTK, _dzLinMIMOCFPrintZTK },
+  { ZTK_KEY_DZCO_LIN_D, 1, _dzLinMIMODFromZTK, _dzLinMIMODFPrintZTK },
+  { ZTK_KEY_DZCO_LIN_DISCRETIZE, 1, _dzLinMIMODiscretizeFromZTK, NULL },
+};
+
+dzLinMIMO *dzLinMIMOFromZTK(dzLinMIMO *lin, ZTK *ztk)
+{
+  bool zoh = false;
+
+  dzLinMIMOInit( lin );
+  if( !_ZTKEvalKey( lin, &zoh, ztk, __ztk_prp_dzlinmimo ) ) return NULL;
+  if( !lin->a || !lin->b || !lin->c ){
+    _dzLinMIMODestroy( lin );
+    return NULL;
+  }
+  if( !lin->d && /* D is zero unless specified */
+      !( lin->d = zMatAlloc( zMatRowSize(lin->c), zMatColSize(lin->b) ) ) ){
+    _dzLinMIMODestroy( lin );
+    return NULL;
+  }
+  if( !_dzLinMIMOCheckSize( lin ) ){
+    ZRUNERROR( DZ_ERR_LIN_SIZMIS );
+    _dzLinMIMODestroy( lin );
+    return NULL;
+  }
+  if( !( lin->x = zVecAlloc( zMatColSize(lin->c) ) ) ||
+      !_dzLinMIMOAllocODE( lin ) ||
+      ( zoh && !dzLinMIMOSetZOH( lin ) ) ){
+    _dzLinMIMODestroy( lin );
+    return NULL;
+  }
+  return lin;
+}
+
+void dzLinMIMOFPrintZTK(FILE *fp, dzLinMIMO *lin)
+{
+  _ZTKPrpKeyFPrint( fp, lin, __ztk_prp_dzlinmimo );
+  /* the default discretization is omitted for compatibility */
+  if( dzLinMIMOIsZOH(lin) )
+    fprintf( fp, "%s: zoh\n", ZTK_KEY_DZCO_LIN_DISCRETIZE );
+}
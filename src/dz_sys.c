@@ -21,6 +21,9 @@ void dzSysDefaultDestroy(dzSys *sys)
 /* default refreshing method */
 void dzSysDefaultRefresh(dzSys *sys){}
 
+/* feedthrough checking method for systems without direct feedthrough */
+bool dzSysNoFeedthrough(dzSys *sys){ return false; }
+
 /* connect two systems. */
 bool dzSysConnect(dzSys *s1, int p1, dzSys *s2, int p2)
 {
@@ -55,18 +58,175 @@ void dzSysChain(int n, ...)
   va_end( arg );
 }
 
-static dzSys *_dzSysQueryAssign(dzSys *sys, const char *str)
+/* duplicate the property of a system through its binary image. */
+static dzSys *_dzSysCloneBin(dzSys *src, dzSys *dest)
+{
+  dzSysBin bin;
+
+  dzSysBinInit( &bin );
+  if( !dzSysEncode( src, &bin ) || !dzSysDecode( dest, &bin ) ) dest = NULL;
+  dzSysBinDestroy( &bin );
+  return dest;
+}
+
+/* clone a system. */
+dzSys *dzSysClone(dzSys *src, dzSys *dest)
+{
+  dzSysInit( dest );
+  if( src->com->_clone ){
+    if( !src->com->_clone( src, dest ) ){
+      if( dest->com ) dzSysDestroy( dest );
+      return NULL;
+    }
+  } else
+  if( src->com->_prpnum > 0 || !src->prp ){
+    dest->com = src->com;
+    dzSysAllocInput( dest, dzSysInputNum(src) );
+    if( dzSysInputNum(dest) != dzSysInputNum(src) ||
+        !dzSysAllocOutput( dest, dzSysOutputNum(src) ) ||
+        ( src->com->_prpnum > 0 && !( dest->prp = zAlloc( double, src->com->_prpnum ) ) ) ){
+      ZALLOCERROR();
+      dzSysDefaultDestroy( dest );
+      return NULL;
+    }
+    if( src->prp )
+      memcpy( dest->prp, src->prp, sizeof(double)*src->com->_prpnum );
+  } else
+  if( src->com->_encode && src->com->_decode ){
+    if( !_dzSysCloneBin( src, dest ) ) return NULL;
+  } else{
+    ZRUNERROR( DZ_ERR_SYS_CLONE_UNSUPPORTED, src->com->typestr );
+    return NULL;
+  }
+  if( dzSysInputNum(dest) != dzSysInputNum(src) ||
+      dzSysOutputNum(dest) != dzSysOutputNum(src) ){
+    ZRUNERROR( DZ_ERR_SYS_CLONE_SIZMIS, src->com->typestr );
+    goto FAILURE;
+  }
+  if( zNamePtr(src) && !zNamePtr(dest) && !zNameSet( dest, zName(src) ) ){
+    ZALLOCERROR();
+    goto FAILURE;
+  }
+  if( dzSysInputNum(src) > 0 )
+    memcpy( zArrayBuf(dzSysInput(dest)), zArrayBuf(dzSysInput(src)), sizeof(dzSysPort)*dzSysInputNum(src) );
+  if( dzSysOutput(src) )
+    zVecCopyNC( dzSysOutput(src), dzSysOutput(dest) );
+  dest->period = src->period;
+  dest->persistent = src->persistent;
+  return dest;
+
+ FAILURE:
+  dzSysDestroy( dest );
+  return NULL;
+}
+
+/* hash value of a string (FNV-1a). */
+static uint _dzSysHashStr(const char *str)
+{
+  uint h = 2166136261U;
+
+  while( *str ){
+    h ^= (unsigned char)*str++;
+    h *= 16777619U;
+  }
+  return h;
+}
+
+/* registry of system classes as an open-addressing hash table,
+ * which is initially on a static buffer and grows on demand. */
+#define DZ_SYS_COM_REGISTRY_SIZE 64
+
+static dzSysCom *_dz_sys_com_registry_buf[DZ_SYS_COM_REGISTRY_SIZE];
+static struct{
+  int size; /* size of the table (power of two) */
+  int num;  /* number of registered classes */
+  dzSysCom **table;
+} _dz_sys_com_registry = { DZ_SYS_COM_REGISTRY_SIZE, 0, _dz_sys_com_registry_buf };
+
+/* slot of a type name in the registry. */
+static dzSysCom **_dzSysComRegistrySlot(const char *typestr)
+{
+  int i;
+
+  for( i=_dzSysHashStr(typestr)&(_dz_sys_com_registry.size-1);
+       _dz_sys_com_registry.table[i];
+       i=(i+1)&(_dz_sys_com_registry.size-1) )
+    if( strcmp( _dz_sys_com_registry.table[i]->typestr, typestr ) == 0 ) break;
+  return &_dz_sys_com_registry.table[i];
+}
+
+/* double the size of the registry. */
+static bool _dzSysComRegistryExpand(void)
+{
+  dzSysCom **table_old;
+  int size_old, i;
+
+  table_old = _dz_sys_com_registry.table;
+  size_old = _dz_sys_com_registry.size;
+  if( !( _dz_sys_com_registry.table = zAlloc( dzSysCom*, size_old*2 ) ) ){
+    ZALLOCERROR();
+    _dz_sys_com_registry.table = table_old;
+    return false;
+  }
+  _dz_sys_com_registry.size = size_old * 2;
+  for( i=0; i<size_old; i++ )
+    if( table_old[i] ) *_dzSysComRegistrySlot( table_old[i]->typestr ) = table_old[i];
+  if( table_old != _dz_sys_com_registry_buf ) zFree( table_old );
+  return true;
+}
+
+static bool _dzSysComRegister(dzSysCom *com)
+{
+  dzSysCom **slot;
+
+  if( *( slot = _dzSysComRegistrySlot( com->typestr ) ) ){
+    if( *slot == com ) return true;
+    ZRUNERROR( DZ_ERR_SYS_TYPE_DUPLICATE, com->typestr );
+    return false;
+  }
+  if( 2*( _dz_sys_com_registry.num + 1 ) > _dz_sys_com_registry.size ){
+    if( !_dzSysComRegistryExpand() ) return false;
+    slot = _dzSysComRegistrySlot( com->typestr );
+  }
+  *slot = com;
+  _dz_sys_com_registry.num++;
+  return true;
+}
+
+/* register built-in system classes at the first access. */
+static void _dzSysComRegistryInit(void)
 {
   DZ_SYS_COM_ARRAY;
+  static bool initialized = false;
   int i;
 
+  if( initialized ) return;
+  initialized = true;
   for( i=0; _dz_sys_com[i]; i++ )
-    if( strcmp( _dz_sys_com[i]->typestr, str ) == 0 ){
-      sys->com = _dz_sys_com[i];
-      return sys;
-    }
-  ZRUNERROR( DZ_WARN_SYS_TYPE_UNFOUND, str );
-  return NULL;
+    _dzSysComRegister( _dz_sys_com[i] );
+}
+
+/* register methods of a system class. */
+bool dzSysComRegister(dzSysCom *com)
+{
+  _dzSysComRegistryInit();
+  return _dzSysComRegister( com );
+}
+
+/* find methods of a system class by type name. */
+dzSysCom *dzSysComFind(const char *typestr)
+{
+  _dzSysComRegistryInit();
+  return *_dzSysComRegistrySlot( typestr );
+}
+
+static dzSys *_dzSysQueryAssign(dzSys *sys, const char *str)
+{
+  if( !( sys->com = dzSysComFind( str ) ) ){
+    ZRUNERROR( DZ_WARN_SYS_TYPE_UNFOUND, str );
+    return NULL;
+  }
+  return sys;
 }
 
 /* ZTK */
@@ -77,6 +237,14 @@ static void *_dzSysNameFromZTK(void *obj, int i, void *arg, ZTK *ztk){
 static void *_dzSysTypeFromZTK(void *obj, int i, void *arg, ZTK *ztk){
   return _dzSysQueryAssign( (dzSys*)obj, ZTKVal(ztk) ) ? obj : NULL;
 }
+static void *_dzSysPeriodFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  ((dzSys*)obj)->period = ZTKDouble(ztk);
+  return obj;
+}
+static void *_dzSysPersistentFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  ((dzSys*)obj)->persistent = ZTKValCmp( ztk, "true" );
+  return obj;
+}
 
 static bool _dzSysNameFPrintZTK(FILE *fp, int i, void *obj){
   fprintf( fp, "%s\n", zName((dzSys*)obj) );
@@ -90,21 +258,36 @@ static bool _dzSysTypeFPrintZTK(FILE *fp, int i, void *obj){
 static const ZTKPrp __ztk_prp_dzsys[] = {
   { ZTK_KEY_DZCO_SYS_NAME, 1, _dzSysNameFromZTK, _dzSysNameFPrintZTK },
   { ZTK_KEY_DZCO_SYS_TYPE, 1, _dzSysTypeFromZTK, _dzSysTypeFPrintZTK },
+  { ZTK_KEY_DZCO_SYS_SAMPLINGPERIOD, 1, _dzSysPeriodFromZTK, NULL },
+  { ZTK_KEY_DZCO_SYS_PERSISTENT, 1, _dzSysPersistentFromZTK, NULL },
 };
 
 void *dzSysFromZTK(dzSys *sys, ZTK *ztk)
 {
   char *name;
+  double period;
+  bool persistent;
+
+  sys->period = 0;
+  sys->persistent = false;
   if( !_ZTKEvalKey( sys, NULL, ztk, __ztk_prp_dzsys ) ) return NULL;
   name = zNamePtr(sys);
+  period = sys->period;
+  persistent = sys->persistent;
   if( !sys->com || !sys->com->_fromZTK( sys, ztk ) ) return NULL;
   zNameSet( sys, name );
+  sys->period = period;
+  sys->persistent = persistent;
   return sys;
 }
 
 void dzSysFPrintZTK(FILE *fp, dzSys *sys)
 {
   _ZTKPrpKeyFPrint( fp, sys, __ztk_prp_dzsys );
+  if( sys->period > 0 )
+    fprintf( fp, "%s: %.10g\n", ZTK_KEY_DZCO_SYS_SAMPLINGPERIOD, sys->period );
+  if( sys->persistent )
+    fprintf( fp, "%s: true\n", ZTK_KEY_DZCO_SYS_PERSISTENT );
   if( sys->com )
     sys->com->_fprintZTK( fp, sys );
 }
@@ -135,6 +318,53 @@ void dzSysArrayDestroy(dzSysArray *arr)
   zArrayFree( arr );
 }
 
+/* destroy systems of an array cloned so far. */
+static void _dzSysArrayCloneAbort(dzSysArray *arr, int n)
+{
+  int i;
+
+  for( i=0; i<n; i++ )
+    dzSysDestroy( zArrayElemNC(arr,i) );
+  zArrayFree( arr );
+}
+
+/* clone an array of systems. */
+dzSysArray *dzSysArrayClone(dzSysArray *src, dzSysArray *dest)
+{
+  int i;
+
+  if( !dzSysArrayAlloc( dest, zArraySize(src) ) ) return NULL;
+  for( i=0; i<zArraySize(src); i++ )
+    if( !dzSysClone( zArrayElemNC(src,i), zArrayElemNC(dest,i) ) ){
+      _dzSysArrayCloneAbort( dest, i );
+      return NULL;
+    }
+  for( i=0; i<zArraySize(dest); i++ )
+    if( !dzSysRebind( zArrayElemNC(dest,i), src, dest ) ){
+      _dzSysArrayCloneAbort( dest, zArraySize(dest) );
+      return NULL;
+    }
+  return dest;
+}
+
+/* rebind inputs of a system from an array to another. */
+bool dzSysRebind(dzSys *sys, dzSysArray *from, dzSysArray *to)
+{
+  dzSysPort *port;
+  int i, j;
+
+  if( zArraySize(from) == 0 ) return true;
+  for( i=0; i<dzSysInputNum(sys); i++ ){
+    port = dzSysInputElem(sys,i);
+    if( !port->sp ) continue;
+    j = port->sp - zArrayElemNC(from,0);
+    if( j < 0 || j >= zArraySize(from) ) continue;
+    if( j >= zArraySize(to) ||
+        !dzSysConnect( zArrayElemNC(to,j), port->port, sys, i ) ) return false;
+  }
+  return true;
+}
+
 /* find a system from array by name. */
 dzSys *dzSysArrayNameFind(dzSysArray *arr, const char *name)
 {
@@ -148,6 +378,47 @@ dzSys *dzSysArrayNameFind(dzSysArray *arr, const char *name)
   return sys;
 }
 
+/* name index of an array of systems */
+
+/* create a name index of an array of systems. */
+dzSysNameIndex *dzSysNameIndexCreate(dzSysNameIndex *idx, dzSysArray *arr)
+{
+  dzSys *sys;
+  int i, j;
+
+  for( idx->size=1; idx->size<2*zArraySize(arr); idx->size*=2 );
+  if( !( idx->table = zAlloc( dzSys*, idx->size ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  for( i=0; i<zArraySize(arr); i++ ){
+    if( !zNamePtr( ( sys = zArrayElemNC(arr,i) ) ) ) continue;
+    for( j=_dzSysHashStr(zName(sys))&(idx->size-1); idx->table[j]; j=(j+1)&(idx->size-1) )
+      if( strcmp( zName(idx->table[j]), zName(sys) ) == 0 ) break;
+    if( !idx->table[j] ) idx->table[j] = sys; /* the first one is prior as dzSysArrayNameFind() */
+  }
+  return idx;
+}
+
+/* destroy a name index of an array of systems. */
+void dzSysNameIndexDestroy(dzSysNameIndex *idx)
+{
+  zFree( idx->table );
+  idx->size = 0;
+}
+
+/* find a system from a name index. */
+dzSys *dzSysNameIndexFind(dzSysNameIndex *idx, const char *name)
+{
+  int i;
+
+  if( idx->size == 0 ) return NULL; /* not created or already destroyed */
+  for( i=_dzSysHashStr(name)&(idx->size-1); idx->table[i]; i=(i+1)&(idx->size-1) )
+    if( strcmp( zName(idx->table[i]), name ) == 0 ) return idx->table[i];
+  ZRUNWARN( DZ_WARN_SYS_NAME_UNFOUND, name );
+  return NULL;
+}
+
 /* update all systems of an array. */
 void dzSysArrayUpdate(dzSysArray *arr, double dt)
 {
@@ -164,24 +435,29 @@ static void *_dzSysArraySysFromZTK(void *obj, int i, void *arg, ZTK *ztk){
   return dzSysFromZTK( zArrayElemNC((dzSysArray*)obj,i), ztk ) ? obj : NULL;
 }
 
+/* the name index is created at the first connection, after all
+ * systems are read. */
 static void *_dzSysArrayConnectFromZTK(void *obj, int i, void *arg, ZTK *ztk){
   _dzSysConnectState state = DZ_SYS_CONNECT_OUT;
+  dzSysNameIndex *idx;
   dzSys *sys_out, *sys_in;
   int port_out, port_in;
 
+  idx = (dzSysNameIndex *)arg;
+  if( !idx->table && !dzSysNameIndexCreate( idx, (dzSysArray *)obj ) ) return NULL;
   if( !ZTKKeyRewind( ztk ) || !ZTKValRewind( ztk ) ) return NULL;
   sys_out = sys_in = NULL;
   port_out = port_in = 0;
   do{
     switch( state ){
     case DZ_SYS_CONNECT_OUT:
-      if( !( sys_out = dzSysArrayNameFind( (dzSysArray *)obj, ZTKVal(ztk) ) ) ) return NULL;
+      if( !( sys_out = dzSysNameIndexFind( idx, ZTKVal(ztk) ) ) ) return NULL;
       ZTKValNext( ztk );
       port_out = ZTKInt(ztk);
       state = DZ_SYS_CONNECT_IN;
       break;
     case DZ_SYS_CONNECT_IN:
-      if( !( sys_in = dzSysArrayNameFind( (dzSysArray *)obj, ZTKVal(ztk) ) ) ) return NULL;
+      if( !( sys_in = dzSysNameIndexFind( idx, ZTKVal(ztk) ) ) ) return NULL;
       ZTKValNext( ztk );
       port_in = ZTKInt(ztk);
       if( !dzSysConnect( sys_out, port_out, sys_in, port_in ) ) return NULL;
@@ -218,6 +494,7 @@ static const ZTKPrp __ztk_prp_tag_dzco_sys[] = {
 /* read the current position of a ZTK file and create an array of systems. */
 dzSysArray *dzSysArrayFromZTK(dzSysArray *sarray, ZTK *ztk)
 {
+  dzSysNameIndex idx;
   int num_sys;
 
   if( ( num_sys = ZTKCountTag( ztk, ZTK_TAG_DZCO_SYS ) ) == 0 ){
@@ -225,7 +502,9 @@ dzSysArray *dzSysArrayFromZTK(dzSysArray *sarray, ZTK *ztk)
     return NULL;
   }
   if( !dzSysArrayAlloc( sarray, num_sys ) ) return NULL;
-  _ZTKEvalTag( sarray, NULL, ztk, __ztk_prp_tag_dzco_sys );
+  dzSysNameIndexInit( &idx );
+  _ZTKEvalTag( sarray, &idx, ztk, __ztk_prp_tag_dzco_sys );
+  dzSysNameIndexDestroy( &idx );
   return sarray;
 }
 
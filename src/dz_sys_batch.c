@@ -0,0 +1,576 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_batch - batch of homogeneous systems
+ */
+
+#include <dzco/dz_sys.h>
+
+/* parameters and internal states of each system are stored in the
+ * following maps, where each entry is an array of n values.
+ *  FOL: [tc][gain]
+ *  SOL: [t1][t2][damp][gain][prevout][previn][tr]
+ *  PC:  [t1][t2][gain][prev]
+ *  MAF: [ff][iov]
+ *  I:   [gain][fgt][prev]
+ *  P:   [gain]
+ *  D:   [gain][tc][prev]
+ *  PID: [pgain][igain][dgain][tc][fgt][intg][prev]
+ */
+typedef struct{
+  dzSysBatchKind kind;
+  int n;
+  double *val; /* parameters and states */
+  double *in;  /* gathered inputs */
+} _dzSysBatch;
+
+static const struct{
+  dzSysCom *com;   /* single system of the same kind */
+  int prmnum;      /* number of parameters */
+  int valnum;      /* number of parameters and states */
+  const char *key[5]; /* ZTK keys of parameters */
+  double val[5];   /* default values of parameters */
+  int prp[7];      /* indices of parameters and states in the property of a single system */
+} _dz_sys_batch_kind[] = {
+  { &dz_sys_fol_com, 2, 2,
+    { ZTK_KEY_DZCO_SYS_TIMECONSTANT, ZTK_KEY_DZCO_SYS_GAIN, NULL, NULL, NULL }, { 1.0, 0.0 },
+    { 0, 1 } },
+  { &dz_sys_sol_com, 4, 7,
+    { ZTK_KEY_DZCO_SYS_T1, ZTK_KEY_DZCO_SYS_T2, ZTK_KEY_DZCO_SYS_DAMPING, ZTK_KEY_DZCO_SYS_GAIN, NULL }, { 1.0, 0.0, 1.0, 0.0 },
+    { 0, 1, 2, 3, 4, 5, 6 } },
+  { &dz_sys_pc_com, 3, 4,
+    { ZTK_KEY_DZCO_SYS_T1, ZTK_KEY_DZCO_SYS_T2, ZTK_KEY_DZCO_SYS_GAIN, NULL, NULL }, { 1.0, 0.0, 0.0 },
+    { 1, 2, 3, 0 } },
+  { &dz_sys_maf_com, 1, 2,
+    { ZTK_KEY_DZCO_SYS_FORGETTINGFACTOR, NULL, NULL, NULL, NULL }, { 0.0 },
+    { 0, 1 } },
+  { &dz_sys_i_com, 2, 3,
+    { ZTK_KEY_DZCO_SYS_GAIN, ZTK_KEY_DZCO_SYS_FORGETTINGFACTOR, NULL, NULL, NULL }, { 0.0, 0.0 },
+    { 1, 2, 0 } },
+  { &dz_sys_p_com, 1, 1,
+    { ZTK_KEY_DZCO_SYS_GAIN, NULL, NULL, NULL, NULL }, { 0.0 },
+    { 0 } },
+  { &dz_sys_d_com, 2, 3,
+    { ZTK_KEY_DZCO_SYS_GAIN, ZTK_KEY_DZCO_SYS_TIMECONSTANT, NULL, NULL, NULL }, { 0.0, 0.0 },
+    { 1, 2, 0 } },
+  { &dz_sys_pid_com, 5, 7,
+    { ZTK_KEY_DZCO_SYS_PGAIN, ZTK_KEY_DZCO_SYS_IGAIN, ZTK_KEY_DZCO_SYS_DGAIN, ZTK_KEY_DZCO_SYS_TIMECONSTANT, ZTK_KEY_DZCO_SYS_FORGETTINGFACTOR }, { 0.0, 0.0, 0.0, 0.0, 0.0 },
+    { 0, 4, 5, 6, 3, 1, 2 } },
+};
+
+#define __dz_sys_batch(s)       ( (_dzSysBatch *)(s)->prp )
+#define __dz_sys_batch_val(s,k) ( __dz_sys_batch(s)->val + (k)*__dz_sys_batch(s)->n )
+
+static void _dzSysBatchDestroy(dzSys *sys)
+{
+  if( sys->prp ){
+    zFree( __dz_sys_batch(sys)->val );
+    zFree( __dz_sys_batch(sys)->in );
+  }
+  dzSysDefaultDestroy( sys );
+}
+
+static void _dzSysBatchRefresh(dzSys *sys)
+{
+  _dzSysBatch *batch;
+  int i;
+
+  batch = __dz_sys_batch(sys);
+  zVecZero( dzSysOutput(sys) );
+  switch( batch->kind ){
+  case DZ_SYS_BATCH_SOL:
+    memset( __dz_sys_batch_val(sys,4), 0, sizeof(double)*batch->n*2 );
+    break;
+  case DZ_SYS_BATCH_PC:
+    memset( __dz_sys_batch_val(sys,3), 0, sizeof(double)*batch->n );
+    break;
+  case DZ_SYS_BATCH_MAF:
+    for( i=0; i<batch->n; i++ ) __dz_sys_batch_val(sys,1)[i] = 1.0;
+    break;
+  case DZ_SYS_BATCH_I:
+  case DZ_SYS_BATCH_D:
+    memset( __dz_sys_batch_val(sys,2), 0, sizeof(double)*batch->n );
+    break;
+  case DZ_SYS_BATCH_PID:
+    memset( __dz_sys_batch_val(sys,5), 0, sizeof(double)*batch->n*2 );
+    break;
+  default: ;
+  }
+}
+
+/* kernels of batch update, which are equivalent to those of single systems. */
+
+static void _dzSysBatchUpdateFOL(int n, double *val, double *u, double *y, double dt)
+{
+  double *tc, *gain, tr;
+  int i;
+
+  tc = val; gain = val + n;
+  for( i=0; i<n; i++ ){
+    tr = dt / tc[i];
+    y[i] = ( y[i] + gain[i] * u[i] * tr ) / ( 1 + tr );
+  }
+}
+
+static void _dzSysBatchUpdateSOL(int n, double *val, double *u, double *y, double dt)
+{
+  double *t1, *t2, *damp, *gain, *prevout, *previn, *trprev;
+  double tr, trp, dr, ret;
+  int i;
+
+  t1 = val; t2 = val + n; damp = val + 2*n; gain = val + 3*n;
+  prevout = val + 4*n; previn = val + 5*n; trprev = val + 6*n;
+  for( i=0; i<n; i++ ){
+    tr = t1[i] / dt;
+    trp = tr * trprev[i];
+    dr = tr * ( tr + 2*damp[i] );
+    ret = ( dr + trp ) * y[i] - trp * prevout[i]
+        + gain[i] * ( u[i] + t2[i]/dt*( u[i] - previn[i] ) );
+    prevout[i] = y[i];
+    previn[i] = u[i];
+    trprev[i] = tr;
+    y[i] = ret / ( dr + 1 );
+  }
+}
+
+static void _dzSysBatchUpdatePC(int n, double *val, double *u, double *y, double dt)
+{
+  double *t1, *t2, *gain, *prev;
+  int i;
+
+  t1 = val; t2 = val + n; gain = val + 2*n; prev = val + 3*n;
+  for( i=0; i<n; i++ ){
+    y[i] = ( t1[i] * y[i] + gain[i] * ( dt * u[i] + t2[i] * ( u[i] - prev[i] ) ) ) / ( dt + t1[i] );
+    prev[i] = u[i];
+  }
+}
+
+static void _dzSysBatchUpdateMAF(int n, double *val, double *u, double *y, double dt)
+{
+  double *ff, *iov;
+  int i;
+
+  ff = val; iov = val + n;
+  for( i=0; i<n; i++ ){
+    iov[i] = ff[i] * iov[i] + 1.0;
+    y[i] += ( u[i] - y[i] ) / iov[i];
+  }
+}
+
+static void _dzSysBatchUpdateI(int n, double *val, double *u, double *y, double dt)
+{
+  double *gain, *fgt, *prev;
+  int i;
+
+  gain = val; fgt = val + n; prev = val + 2*n;
+  for( i=0; i<n; i++ ){
+    y[i] = ( 1 - fgt[i] ) * y[i] + gain[i] * prev[i] * dt;
+    prev[i] = u[i];
+  }
+}
+
+static void _dzSysBatchUpdateP(int n, double *val, double *u, double *y, double dt)
+{
+  int i;
+
+  for( i=0; i<n; i++ )
+    y[i] = val[i] * u[i];
+}
+
+static void _dzSysBatchUpdateD(int n, double *val, double *u, double *y, double dt)
+{
+  double *gain, *tc, *prev, r;
+  int i;
+
+  gain = val; tc = val + n; prev = val + 2*n;
+  for( i=0; i<n; i++ ){
+    r = 1.0 / ( dt + tc[i] );
+    y[i] = r * ( tc[i] * y[i] + gain[i] * ( u[i] - prev[i] ) );
+    prev[i] = u[i];
+  }
+}
+
+static void _dzSysBatchUpdatePID(int n, double *val, double *u, double *y, double dt)
+{
+  double *pgain, *igain, *dgain, *tc, *fgt, *intg, *prev;
+  int i;
+
+  pgain = val; igain = val + n; dgain = val + 2*n; tc = val + 3*n;
+  fgt = val + 4*n; intg = val + 5*n; prev = val + 6*n;
+  for( i=0; i<n; i++ ){
+    intg[i] = ( 1 - fgt[i] ) * intg[i] + igain[i] * prev[i] * dt;
+    y[i] = pgain[i] * u[i] + intg[i]
+      + ( tc[i] * y[i] + dgain[i] * ( u[i] - prev[i] ) ) / ( dt + tc[i] );
+    prev[i] = u[i];
+  }
+}
+
+static void (* _dz_sys_batch_update[])(int,double*,double*,double*,double) = {
+  _dzSysBatchUpdateFOL,
+  _dzSysBatchUpdateSOL,
+  _dzSysBatchUpdatePC,
+  _dzSysBatchUpdateMAF,
+  _dzSysBatchUpdateI,
+  _dzSysBatchUpdateP,
+  _dzSysBatchUpdateD,
+  _dzSysBatchUpdatePID,
+};
+
+static zVec _dzSysBatchUpdate(dzSys *sys, double dt)
+{
+  _dzSysBatch *batch;
+  int i;
+
+  batch = __dz_sys_batch(sys);
+  for( i=0; i<batch->n; i++ )
+    batch->in[i] = dzSysInputVal(sys,i);
+  _dz_sys_batch_update[batch->kind]( batch->n, batch->val, batch->in, zVecBufNC(dzSysOutput(sys)), dt );
+  return dzSysOutput(sys);
+}
+
+static bool _dzSysBatchFeedthrough(dzSys *sys)
+{
+  return __dz_sys_batch(sys)->kind != DZ_SYS_BATCH_I;
+}
+
+/* ZTK */
+
+/* parameters of a batch in ZTK, where each list of values of a key
+ * is stored in the corresponding buffer. */
+typedef struct{
+  dzSysBatchKind kind;
+  int n;
+  double *val[5];
+  int valnum[5];
+} _dzSysBatchZTKPrm;
+
+static void *_dzSysBatchKindFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  _dzSysBatchZTKPrm *prm;
+
+  prm = (_dzSysBatchZTKPrm *)obj;
+  for( prm->kind=0; prm->kind<DZ_SYS_BATCH_INVALID; prm->kind++ )
+    if( strcmp( _dz_sys_batch_kind[prm->kind].com->typestr, ZTKVal(ztk) ) == 0 ) return obj;
+  ZRUNERROR( DZ_WARN_SYS_TYPE_UNFOUND, ZTKVal(ztk) );
+  return NULL;
+}
+static void *_dzSysBatchNumFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  ((_dzSysBatchZTKPrm *)obj)->n = ZTKInt(ztk);
+  return obj;
+}
+
+static bool _dzSysBatchKindFPrintZTK(FILE *fp, int i, void *prp){
+  fprintf( fp, "%s\n", _dz_sys_batch_kind[__dz_sys_batch((dzSys*)prp)->kind].com->typestr );
+  return true;
+}
+static bool _dzSysBatchNumFPrintZTK(FILE *fp, int i, void *prp){
+  fprintf( fp, "%d\n", __dz_sys_batch((dzSys*)prp)->n );
+  return true;
+}
+
+static const ZTKPrp __ztk_prp_dzsys_batch[] = {
+  { ZTK_KEY_DZCO_SYS_BATCH_KIND, 1, _dzSysBatchKindFromZTK, _dzSysBatchKindFPrintZTK },
+  { ZTK_KEY_DZCO_SYS_BATCH_NUM,  1, _dzSysBatchNumFromZTK, _dzSysBatchNumFPrintZTK },
+};
+
+/* read a list of values of a parameter of a batch. */
+static void *_dzSysBatchValFromZTK(_dzSysBatchZTKPrm *prm, const char *key, ZTK *ztk)
+{
+  double *val;
+  int j;
+
+  for( j=0; j<_dz_sys_batch_kind[prm->kind].prmnum; j++ )
+    if( strcmp( _dz_sys_batch_kind[prm->kind].key[j], key ) == 0 ) break;
+  if( j == _dz_sys_batch_kind[prm->kind].prmnum ) return prm; /* not a parameter of the kind */
+  while( ZTKValPtr(ztk) ){
+    if( !( val = zRealloc( prm->val[j], double, prm->valnum[j]+1 ) ) ){
+      ZALLOCERROR();
+      return NULL;
+    }
+    prm->val[j] = val;
+    prm->val[j][prm->valnum[j]++] = ZTKDouble(ztk);
+  }
+  return prm;
+}
+
+static void *_dzSysBatchTCFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return _dzSysBatchValFromZTK( (_dzSysBatchZTKPrm *)obj, ZTK_KEY_DZCO_SYS_TIMECONSTANT, ztk );
+}
+static void *_dzSysBatchT1FromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return _dzSysBatchValFromZTK( (_dzSysBatchZTKPrm *)obj, ZTK_KEY_DZCO_SYS_T1, ztk );
+}
+static void *_dzSysBatchT2FromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return _dzSysBatchValFromZTK( (_dzSysBatchZTKPrm *)obj, ZTK_KEY_DZCO_SYS_T2, ztk );
+}
+static void *_dzSysBatchDampFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return _dzSysBatchValFromZTK( (_dzSysBatchZTKPrm *)obj, ZTK_KEY_DZCO_SYS_DAMPING, ztk );
+}
+static void *_dzSysBatchGainFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return _dzSysBatchValFromZTK( (_dzSysBatchZTKPrm *)obj, ZTK_KEY_DZCO_SYS_GAIN, ztk );
+}
+static void *_dzSysBatchFFFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return _dzSysBatchValFromZTK( (_dzSysBatchZTKPrm *)obj, ZTK_KEY_DZCO_SYS_FORGETTINGFACTOR, ztk );
+}
+static void *_dzSysBatchPGainFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return _dzSysBatchValFromZTK( (_dzSysBatchZTKPrm *)obj, ZTK_KEY_DZCO_SYS_PGAIN, ztk );
+}
+static void *_dzSysBatchIGainFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return _dzSysBatchValFromZTK( (_dzSysBatchZTKPrm *)obj, ZTK_KEY_DZCO_SYS_IGAIN, ztk );
+}
+static void *_dzSysBatchDGainFromZTK(void *obj, int i, void *arg, ZTK *ztk){
+  return _dzSysBatchValFromZTK( (_dzSysBatchZTKPrm *)obj, ZTK_KEY_DZCO_SYS_DGAIN, ztk );
+}
+
+/* parameters are read after the kind is determined. */
+static const ZTKPrp __ztk_prp_dzsys_batch_val[] = {
+  { ZTK_KEY_DZCO_SYS_TIMECONSTANT,     1, _dzSysBatchTCFromZTK, NULL },
+  { ZTK_KEY_DZCO_SYS_T1,               1, _dzSysBatchT1FromZTK, NULL },
+  { ZTK_KEY_DZCO_SYS_T2,               1, _dzSysBatchT2FromZTK, NULL },
+  { ZTK_KEY_DZCO_SYS_DAMPING,          1, _dzSysBatchDampFromZTK, NULL },
+  { ZTK_KEY_DZCO_SYS_GAIN,             1, _dzSysBatchGainFromZTK, NULL },
+  { ZTK_KEY_DZCO_SYS_FORGETTINGFACTOR, 1, _dzSysBatchFFFromZTK, NULL },
+  { ZTK_KEY_DZCO_SYS_PGAIN,            1, _dzSysBatchPGainFromZTK, NULL },
+  { ZTK_KEY_DZCO_SYS_IGAIN,            1, _dzSysBatchIGainFromZTK, NULL },
+  { ZTK_KEY_DZCO_SYS_DGAIN,            1, _dzSysBatchDGainFromZTK, NULL },
+};
+
+static dzSys *_dzSysBatchFromZTK(dzSys *sys, ZTK *ztk)
+{
+  _dzSysBatchZTKPrm prm;
+  int i, j;
+
+  prm.kind = DZ_SYS_BATCH_FOL;
+  prm.n = 1;
+  for( j=0; j<5; j++ ){
+    prm.val[j] = NULL;
+    prm.valnum[j] = 0;
+  }
+  if( !_ZTKEvalKey( &prm, NULL, ztk, __ztk_prp_dzsys_batch ) ) return NULL;
+  if( !_ZTKEvalKey( &prm, NULL, ztk, __ztk_prp_dzsys_batch_val ) ||
+      !dzSysBatchCreate( sys, prm.kind, prm.n ) ){
+    sys = NULL;
+    goto TERMINATE;
+  }
+  /* a short list of values is padded with the last value */
+  for( j=0; j<_dz_sys_batch_kind[prm.kind].prmnum; j++ )
+    for( i=0; i<prm.n && prm.valnum[j]>0; i++ )
+      __dz_sys_batch_val(sys,j)[i] = prm.val[j][zMin(i,prm.valnum[j]-1)];
+  if( prm.kind == DZ_SYS_BATCH_SOL )
+    for( i=0; i<prm.n; i++ )
+      if( __dz_sys_batch_val(sys,0)[i] <= zTOL ){
+        ZRUNERROR( DZ_ERR_SYS_LAG_TOOSHORTTC );
+        dzSysDestroy( sys );
+        sys = NULL;
+        break;
+      }
+ TERMINATE:
+  for( j=0; j<5; j++ ) zFree( prm.val[j] );
+  return sys;
+}
+
+static void _dzSysBatchFPrintZTK(FILE *fp, dzSys *sys)
+{
+  _dzSysBatch *batch;
+  int i, j;
+
+  _ZTKPrpKeyFPrint( fp, sys, __ztk_prp_dzsys_batch );
+  batch = __dz_sys_batch(sys);
+  for( j=0; j<_dz_sys_batch_kind[batch->kind].prmnum; j++ ){
+    fprintf( fp, "%s:", _dz_sys_batch_kind[batch->kind].key[j] );
+    for( i=0; i<batch->n; i++ )
+      fprintf( fp, " %.10g", __dz_sys_batch_val(sys,j)[i] );
+    fprintf( fp, "\n" );
+  }
+}
+
+/* binary image */
+
+static bool _dzSysBatchEncode(dzSys *sys, dzSysBin *bin)
+{
+  _dzSysBatch *batch;
+
+  batch = __dz_sys_batch(sys);
+  return dzSysBinWriteInt( bin, batch->kind ) &&
+         dzSysBinWriteInt( bin, batch->n ) &&
+         dzSysBinWriteDoubleArray( bin, batch->val, _dz_sys_batch_kind[batch->kind].valnum*batch->n );
+}
+
+static dzSys *_dzSysBatchDecode(dzSys *sys, dzSysBin *bin)
+{
+  int kind, n;
+
+  if( !dzSysBinReadInt( bin, &kind ) || !dzSysBinReadInt( bin, &n ) ) return NULL;
+  if( kind < 0 || kind >= DZ_SYS_BATCH_INVALID ){
+    ZRUNERROR( DZ_ERR_SYS_BATCH_INVALIDKIND, kind );
+    return NULL;
+  }
+  if( n <= 0 || !dzSysBatchCreate( sys, (dzSysBatchKind)kind, n ) ) goto FAILURE;
+  if( !dzSysBinReadDoubleArray( bin, __dz_sys_batch(sys)->val, _dz_sys_batch_kind[kind].valnum*n ) ) goto FAILURE;
+  return sys;
+
+ FAILURE:
+  dzSysDestroy( sys );
+  return NULL;
+}
+
+static dzSys *_dzSysBatchClone(dzSys *src, dzSys *dest)
+{
+  _dzSysBatch *org;
+
+  org = __dz_sys_batch(src);
+  if( !dzSysBatchCreate( dest, org->kind, org->n ) ) return NULL;
+  memcpy( __dz_sys_batch(dest)->val, org->val, sizeof(double)*_dz_sys_batch_kind[org->kind].valnum*org->n );
+  return dest;
+}
+
+/* parameters are saved together with states as a flat array. */
+static int _dzSysBatchSnapshot(dzSys *sys, double *buf)
+{
+  _dzSysBatch *batch;
+
+  batch = __dz_sys_batch(sys);
+  if( buf ) memcpy( buf, batch->val, sizeof(double)*_dz_sys_batch_kind[batch->kind].valnum*batch->n );
+  return _dz_sys_batch_kind[batch->kind].valnum*batch->n;
+}
+
+static void _dzSysBatchRestore(dzSys *sys, const double *buf)
+{
+  _dzSysBatch *batch;
+
+  batch = __dz_sys_batch(sys);
+  memcpy( batch->val, buf, sizeof(double)*_dz_sys_batch_kind[batch->kind].valnum*batch->n );
+}
+
+dzSysCom dz_sys_batch_com = {
+  .typestr = "batch",
+  ._destroy = _dzSysBatchDestroy,
+  ._refresh = _dzSysBatchRefresh,
+  ._update = _dzSysBatchUpdate,
+  ._fromZTK = _dzSysBatchFromZTK,
+  ._fprintZTK = _dzSysBatchFPrintZTK,
+  ._feedthrough = _dzSysBatchFeedthrough,
+  ._encode = _dzSysBatchEncode,
+  ._decode = _dzSysBatchDecode,
+  ._clone = _dzSysBatchClone,
+  ._snapshot = _dzSysBatchSnapshot,
+  ._restore = _dzSysBatchRestore,
+};
+
+/* create a batch of homogeneous systems. */
+dzSys *dzSysBatchCreate(dzSys *sys, dzSysBatchKind kind, int n)
+{
+  _dzSysBatch *batch;
+  int i, j;
+
+  if( kind < 0 || kind >= DZ_SYS_BATCH_INVALID ){
+    ZRUNERROR( DZ_ERR_SYS_BATCH_INVALIDKIND, kind );
+    return NULL;
+  }
+  dzSysInit( sys );
+  sys->com = &dz_sys_batch_com;
+  dzSysAllocInput( sys, n );
+  if( dzSysInputNum(sys) != n ||
+      !dzSysAllocOutput( sys, n ) ||
+      !( sys->prp = ( batch = zAlloc( _dzSysBatch, 1 ) ) ) ) return NULL;
+  batch->kind = kind;
+  batch->n = n;
+  batch->val = zAlloc( double, _dz_sys_batch_kind[kind].valnum*n );
+  batch->in = zAlloc( double, n );
+  if( !batch->val || !batch->in ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  for( j=0; j<_dz_sys_batch_kind[kind].prmnum; j++ )
+    for( i=0; i<n; i++ )
+      __dz_sys_batch_val(sys,j)[i] = _dz_sys_batch_kind[kind].val[j];
+  dzSysRefresh( sys );
+  return sys;
+}
+
+void dzSysBatchSetFOL(dzSys *sys, int i, double tc, double gain)
+{
+  __dz_sys_batch_val(sys,0)[i] = tc;
+  __dz_sys_batch_val(sys,1)[i] = gain;
+}
+
+bool dzSysBatchSetSOL(dzSys *sys, int i, double t1, double t2, double damp, double gain)
+{
+  if( t1 <= zTOL ){
+    ZRUNERROR( DZ_ERR_SYS_LAG_TOOSHORTTC );
+    return false;
+  }
+  __dz_sys_batch_val(sys,0)[i] = t1;
+  __dz_sys_batch_val(sys,1)[i] = t2;
+  __dz_sys_batch_val(sys,2)[i] = damp;
+  __dz_sys_batch_val(sys,3)[i] = gain;
+  return true;
+}
+
+void dzSysBatchSetPC(dzSys *sys, int i, double t1, double t2, double gain)
+{
+  __dz_sys_batch_val(sys,0)[i] = t1;
+  __dz_sys_batch_val(sys,1)[i] = t2;
+  __dz_sys_batch_val(sys,2)[i] = gain;
+}
+
+void dzSysBatchSetMAF(dzSys *sys, int i, double ff)
+{
+  __dz_sys_batch_val(sys,0)[i] = ff;
+}
+
+void dzSysBatchSetI(dzSys *sys, int i, double gain, double fgt)
+{
+  __dz_sys_batch_val(sys,0)[i] = gain;
+  __dz_sys_batch_val(sys,1)[i] = fgt;
+}
+
+void dzSysBatchSetP(dzSys *sys, int i, double gain)
+{
+  __dz_sys_batch_val(sys,0)[i] = gain;
+}
+
+void dzSysBatchSetD(dzSys *sys, int i, double gain, double tc)
+{
+  __dz_sys_batch_val(sys,0)[i] = gain;
+  __dz_sys_batch_val(sys,1)[i] = tc;
+}
+
+void dzSysBatchSetPID(dzSys *sys, int i, double kp, double ki, double kd, double tc, double fgt)
+{
+  __dz_sys_batch_val(sys,0)[i] = kp;
+  __dz_sys_batch_val(sys,1)[i] = ki;
+  __dz_sys_batch_val(sys,2)[i] = kd;
+  __dz_sys_batch_val(sys,3)[i] = tc;
+  __dz_sys_batch_val(sys,4)[i] = fgt;
+}
+
+/* load parameters, states and the output of a single system. */
+bool dzSysBatchLoad(dzSys *sys, int i, dzSys *src)
+{
+  _dzSysBatch *batch;
+  int j;
+
+  batch = __dz_sys_batch(sys);
+  if( dzSysBatchKindOf(sys) == DZ_SYS_BATCH_INVALID ||
+      src->com != _dz_sys_batch_kind[batch->kind].com ){
+    ZRUNERROR( DZ_ERR_SYS_BATCH_UNMATCHKIND, src->com->typestr );
+    return false;
+  }
+  for( j=0; j<_dz_sys_batch_kind[batch->kind].valnum; j++ )
+    __dz_sys_batch_val(sys,j)[i] = ((double*)src->prp)[_dz_sys_batch_kind[batch->kind].prp[j]];
+  dzSysOutputVal(sys,i) = dzSysOutputVal(src,0);
+  return true;
+}
+
+dzSysBatchKind dzSysBatchKindFind(dzSysCom *com)
+{
+  dzSysBatchKind kind;
+
+  for( kind=0; kind<DZ_SYS_BATCH_INVALID; kind++ )
+    if( _dz_sys_batch_kind[kind].com == com ) break;
+  return kind;
+}
+
+dzSysBatchKind dzSysBatchKindOf(dzSys *sys)
+{
+  return sys->com == &dz_sys_batch_com ? __dz_sys_batch(sys)->kind : DZ_SYS_BATCH_INVALID;
+}
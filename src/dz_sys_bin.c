@@ -0,0 +1,385 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_bin - binary image of systems
+ */
+
+#include <dzco/dz_sys.h>
+
+/* ********************************************************** */
+/* byte stream of a binary image
+ * ********************************************************** */
+
+dzSysBin *dzSysBinInit(dzSysBin *bin)
+{
+  bin->buf = NULL;
+  bin->size = bin->capacity = bin->cur = 0;
+  return bin;
+}
+
+void dzSysBinDestroy(dzSysBin *bin)
+{
+  zFree( bin->buf );
+  dzSysBinInit( bin );
+}
+
+bool dzSysBinWrite(dzSysBin *bin, const void *data, size_t size)
+{
+  char *buf;
+  size_t capacity;
+
+  if( size == 0 ) return true;
+  if( bin->size + size > bin->capacity ){
+    for( capacity=zMax(bin->capacity,BUFSIZ); capacity<bin->size+size; capacity*=2 );
+    if( !( buf = zRealloc( bin->buf, char, capacity ) ) ){
+      ZALLOCERROR();
+      return false;
+    }
+    bin->buf = buf;
+    bin->capacity = capacity;
+  }
+  memcpy( bin->buf + bin->size, data, size );
+  bin->size += size;
+  return true;
+}
+
+bool dzSysBinRead(dzSysBin *bin, void *data, size_t size)
+{
+  if( size == 0 ) return true;
+  if( bin->cur + size > bin->size ){
+    ZRUNERROR( DZ_ERR_SYS_BIN_BROKEN );
+    return false;
+  }
+  memcpy( data, bin->buf + bin->cur, size );
+  bin->cur += size;
+  return true;
+}
+
+bool dzSysBinWriteInt(dzSysBin *bin, int val){
+  return dzSysBinWrite( bin, &val, sizeof(int) );
+}
+
+bool dzSysBinWriteDouble(dzSysBin *bin, double val){
+  return dzSysBinWrite( bin, &val, sizeof(double) );
+}
+
+bool dzSysBinWriteDoubleArray(dzSysBin *bin, const double *val, int n){
+  return dzSysBinWrite( bin, val, sizeof(double)*n );
+}
+
+bool dzSysBinWriteStr(dzSysBin *bin, const char *str)
+{
+  int len;
+
+  len = str ? strlen( str ) : 0;
+  return dzSysBinWriteInt( bin, len ) && dzSysBinWrite( bin, str, len );
+}
+
+bool dzSysBinWriteVec(dzSysBin *bin, zVec v)
+{
+  return dzSysBinWriteInt( bin, zVecSizeNC(v) ) &&
+         dzSysBinWriteDoubleArray( bin, zVecBufNC(v), zVecSizeNC(v) );
+}
+
+bool dzSysBinWriteMat(dzSysBin *bin, zMat m)
+{
+  return dzSysBinWriteInt( bin, zMatRowSizeNC(m) ) &&
+         dzSysBinWriteInt( bin, zMatColSizeNC(m) ) &&
+         dzSysBinWriteDoubleArray( bin, zMatBufNC(m), zMatRowSizeNC(m)*zMatColSizeNC(m) );
+}
+
+bool dzSysBinReadInt(dzSysBin *bin, int *val){
+  return dzSysBinRead( bin, val, sizeof(int) );
+}
+
+bool dzSysBinReadDouble(dzSysBin *bin, double *val){
+  return dzSysBinRead( bin, val, sizeof(double) );
+}
+
+bool dzSysBinReadDoubleArray(dzSysBin *bin, double *val, int n){
+  return dzSysBinRead( bin, val, sizeof(double)*n );
+}
+
+bool dzSysBinReadStr(dzSysBin *bin, char **str)
+{
+  int len;
+
+  if( !dzSysBinReadInt( bin, &len ) ) return false;
+  if( len < 0 || bin->cur + len > bin->size ){
+    ZRUNERROR( DZ_ERR_SYS_BIN_BROKEN );
+    return false;
+  }
+  if( !( *str = zAlloc( char, len+1 ) ) ){
+    ZALLOCERROR();
+    return false;
+  }
+  dzSysBinRead( bin, *str, len );
+  (*str)[len] = '\0';
+  return true;
+}
+
+bool dzSysBinReadVec(dzSysBin *bin, zVec v)
+{
+  int size;
+
+  if( !dzSysBinReadInt( bin, &size ) ) return false;
+  if( size != zVecSizeNC(v) ){
+    ZRUNERROR( DZ_ERR_SYS_BIN_BROKEN );
+    return false;
+  }
+  return dzSysBinReadDoubleArray( bin, zVecBufNC(v), size );
+}
+
+bool dzSysBinReadMat(dzSysBin *bin, zMat m)
+{
+  int row, col;
+
+  if( !dzSysBinReadInt( bin, &row ) || !dzSysBinReadInt( bin, &col ) ) return false;
+  if( row != zMatRowSizeNC(m) || col != zMatColSizeNC(m) ){
+    ZRUNERROR( DZ_ERR_SYS_BIN_BROKEN );
+    return false;
+  }
+  return dzSysBinReadDoubleArray( bin, zMatBufNC(m), row*col );
+}
+
+bool dzSysBinWriteFile(dzSysBin *bin, char filename[])
+{
+  FILE *fp;
+  bool ret;
+
+  if( !( fp = fopen( filename, "wb" ) ) ){
+    ZOPENERROR( filename );
+    return false;
+  }
+  ret = fwrite( bin->buf, sizeof(char), bin->size, fp ) == bin->size;
+  fclose( fp );
+  return ret;
+}
+
+bool dzSysBinReadFile(dzSysBin *bin, char filename[])
+{
+  FILE *fp;
+  long size;
+  bool ret = false;
+
+  dzSysBinInit( bin );
+  if( !( fp = fopen( filename, "rb" ) ) ){
+    ZOPENERROR( filename );
+    return false;
+  }
+  if( fseek( fp, 0, SEEK_END ) != 0 || ( size = ftell( fp ) ) < 0 ) goto TERMINATE;
+  rewind( fp );
+  if( !( bin->buf = zAlloc( char, size > 0 ? size : 1 ) ) ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  bin->capacity = size;
+  if( ( bin->size = fread( bin->buf, sizeof(char), size, fp ) ) == (size_t)size ) ret = true;
+ TERMINATE:
+  fclose( fp );
+  return ret;
+}
+
+/* ********************************************************** */
+/* binary image of systems
+ * ********************************************************** */
+
+#define DZ_SYS_BIN_MAGIC   "DZSYSBIN"
+#define DZ_SYS_BIN_VERSION 3
+#define DZ_SYS_BIN_BOM     0x01020304
+
+bool dzSysEncode(dzSys *sys, dzSysBin *bin)
+{
+  if( !dzSysBinWriteStr( bin, sys->com->typestr ) ||
+      !dzSysBinWriteStr( bin, zName(sys) ) ||
+      !dzSysBinWriteInt( bin, dzSysInputNum(sys) ) ||
+      !dzSysBinWriteInt( bin, dzSysOutputNum(sys) ) ||
+      !dzSysBinWriteDoubleArray( bin, &sys->period, 1 ) ||
+      !dzSysBinWriteInt( bin, sys->persistent ? 1 : 0 ) ) return false;
+  if( sys->com->_encode )
+    return sys->com->_encode( sys, bin );
+  if( sys->com->_prpnum > 0 )
+    return dzSysBinWriteDoubleArray( bin, (double *)sys->prp, sys->com->_prpnum );
+  if( sys->prp ){
+    ZRUNERROR( DZ_ERR_SYS_BIN_UNSUPPORTED, sys->com->typestr );
+    return false;
+  }
+  return true;
+}
+
+dzSys *dzSysDecode(dzSys *sys, dzSysBin *bin)
+{
+  char *typestr = NULL, *name = NULL;
+  dzSysCom *com;
+  int nin, nout, persistent;
+  double period;
+  dzSys *ret = NULL;
+
+  dzSysInit( sys );
+  if( !dzSysBinReadStr( bin, &typestr ) || !dzSysBinReadStr( bin, &name ) ||
+      !dzSysBinReadInt( bin, &nin ) || !dzSysBinReadInt( bin, &nout ) ||
+      !dzSysBinReadDoubleArray( bin, &period, 1 ) ||
+      !dzSysBinReadInt( bin, &persistent ) ) goto TERMINATE;
+  if( !( com = dzSysComFind( typestr ) ) ){
+    ZRUNERROR( DZ_WARN_SYS_TYPE_UNFOUND, typestr );
+    goto TERMINATE;
+  }
+  if( com->_decode ){
+    if( !com->_decode( sys, bin ) ){
+      dzSysInit( sys );
+      goto TERMINATE;
+    }
+  } else{
+    sys->com = com;
+    dzSysAllocInput( sys, nin );
+    if( dzSysInputNum(sys) != nin || !dzSysAllocOutput( sys, nout ) ||
+        ( com->_prpnum > 0 && !( sys->prp = zAlloc( double, com->_prpnum ) ) ) ){
+      ZALLOCERROR();
+      dzSysDefaultDestroy( sys );
+      goto TERMINATE;
+    }
+    if( !dzSysBinReadDoubleArray( bin, (double *)sys->prp, com->_prpnum ) ){
+      dzSysDefaultDestroy( sys );
+      goto TERMINATE;
+    }
+  }
+  if( dzSysInputNum(sys) != nin || dzSysOutputNum(sys) != nout ){
+    ZRUNERROR( DZ_ERR_SYS_BIN_BROKEN );
+    goto ABORT;
+  }
+  if( *name && !zNameSet( sys, name ) ){
+    ZALLOCERROR();
+    goto ABORT;
+  }
+  sys->period = period;
+  sys->persistent = persistent ? true : false;
+  ret = sys;
+  goto TERMINATE;
+ ABORT:
+  dzSysDestroy( sys );
+  dzSysInit( sys );
+ TERMINATE:
+  zFree( typestr );
+  zFree( name );
+  return ret;
+}
+
+/* index of a system in an array, or -1 if not included. */
+static int _dzSysArrayIndex(dzSysArray *arr, dzSys *sys)
+{
+  int i;
+
+  if( !sys || zArraySize(arr) == 0 ) return -1;
+  i = sys - zArrayElemNC(arr,0);
+  return i >= 0 && i < zArraySize(arr) ? i : -1;
+}
+
+bool dzSysArrayEncode(dzSysArray *arr, dzSysBin *bin, bool state)
+{
+  dzSys *sys;
+  dzSysPort *port;
+  int i, j;
+
+  if( !dzSysBinWrite( bin, DZ_SYS_BIN_MAGIC, strlen(DZ_SYS_BIN_MAGIC) ) ||
+      !dzSysBinWriteInt( bin, DZ_SYS_BIN_VERSION ) ||
+      !dzSysBinWriteInt( bin, DZ_SYS_BIN_BOM ) ||
+      !dzSysBinWriteInt( bin, sizeof(double) ) ||
+      !dzSysBinWriteInt( bin, state ? 1 : 0 ) ||
+      !dzSysBinWriteInt( bin, zArraySize(arr) ) ) return false;
+  for( i=0; i<zArraySize(arr); i++ ){
+    sys = zArrayElemNC(arr,i);
+    if( !dzSysEncode( sys, bin ) ) return false;
+    if( state && !dzSysBinWriteVec( bin, dzSysOutput(sys) ) ) return false;
+  }
+  /* connections as indices of systems and ports */
+  for( i=0; i<zArraySize(arr); i++ ){
+    sys = zArrayElemNC(arr,i);
+    for( j=0; j<dzSysInputNum(sys); j++ ){
+      port = dzSysInputElem(sys,j);
+      if( !dzSysBinWriteInt( bin, _dzSysArrayIndex( arr, port->sp ) ) ||
+          !dzSysBinWriteInt( bin, port->port ) ) return false;
+    }
+  }
+  return true;
+}
+
+/* destroy systems of an array decoded so far. */
+static void _dzSysArrayDecodeAbort(dzSysArray *arr, int n)
+{
+  int i;
+
+  for( i=0; i<n; i++ )
+    dzSysDestroy( zArrayElemNC(arr,i) );
+  zArrayFree( arr );
+}
+
+dzSysArray *dzSysArrayDecode(dzSysArray *arr, dzSysBin *bin)
+{
+  char magic[sizeof(DZ_SYS_BIN_MAGIC)];
+  dzSys *sys;
+  int version, bom, dsize, state, num, i, j, src, port;
+
+  zArrayInit( arr );
+  if( !dzSysBinRead( bin, magic, strlen(DZ_SYS_BIN_MAGIC) ) ) return NULL;
+  if( strncmp( magic, DZ_SYS_BIN_MAGIC, strlen(DZ_SYS_BIN_MAGIC) ) != 0 ||
+      !dzSysBinReadInt( bin, &version ) || version != DZ_SYS_BIN_VERSION ||
+      !dzSysBinReadInt( bin, &bom ) || bom != DZ_SYS_BIN_BOM ||
+      !dzSysBinReadInt( bin, &dsize ) || dsize != sizeof(double) ){
+    ZRUNERROR( DZ_ERR_SYS_BIN_INCOMPATIBLE );
+    return NULL;
+  }
+  if( !dzSysBinReadInt( bin, &state ) || !dzSysBinReadInt( bin, &num ) ) return NULL;
+  if( num <= 0 ){
+    ZRUNWARN( DZ_WARN_SYSARRAY_EMPTY );
+    return NULL;
+  }
+  if( !dzSysArrayAlloc( arr, num ) ) return NULL;
+  for( i=0; i<num; i++ ){
+    sys = zArrayElemNC(arr,i);
+    if( !dzSysDecode( sys, bin ) ){
+      _dzSysArrayDecodeAbort( arr, i );
+      return NULL;
+    }
+    if( state && !dzSysBinReadVec( bin, dzSysOutput(sys) ) ){
+      _dzSysArrayDecodeAbort( arr, i+1 );
+      return NULL;
+    }
+    if( !state ) dzSysRefresh( sys );
+  }
+  for( i=0; i<num; i++ ){
+    sys = zArrayElemNC(arr,i);
+    for( j=0; j<dzSysInputNum(sys); j++ ){
+      if( !dzSysBinReadInt( bin, &src ) || !dzSysBinReadInt( bin, &port ) ||
+          src >= num ||
+          ( src >= 0 && !dzSysConnect( zArrayElemNC(arr,src), port, sys, j ) ) ){
+        _dzSysArrayDecodeAbort( arr, num );
+        return NULL;
+      }
+    }
+  }
+  return arr;
+}
+
+bool dzSysArrayWriteBin(dzSysArray *arr, char filename[], bool state)
+{
+  dzSysBin bin;
+  bool ret;
+
+  dzSysBinInit( &bin );
+  ret = dzSysArrayEncode( arr, &bin, state ) && dzSysBinWriteFile( &bin, filename );
+  dzSysBinDestroy( &bin );
+  return ret;
+}
+
+dzSysArray *dzSysArrayReadBin(dzSysArray *arr, char filename[])
+{
+  dzSysBin bin;
+
+  zArrayInit( arr );
+  if( dzSysBinReadFile( &bin, filename ) )
+    arr = dzSysArrayDecode( arr, &bin );
+  else
+    arr = NULL;
+  dzSysBinDestroy( &bin );
+  return arr;
+}
@@ -0,0 +1,114 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_bus - contiguous signal bus of outputs of systems
+ */
+
+#include <dzco/dz_sys.h>
+
+/* reconnect input ports to outputs of systems of an array. */
+static void _dzSysBusResolve(dzSysArray *arr)
+{
+  dzSys *sys;
+  dzSysPort *port;
+  int i, k;
+
+  for( i=0; i<zArraySize(arr); i++ ){
+    sys = zArrayElemNC(arr,i);
+    for( k=0; k<dzSysInputNum(sys); k++ ){
+      port = zArrayElemNC(dzSysInput(sys),k);
+      if( port->sp && port->sp >= zArrayBuf(arr) && port->sp < zArrayBuf(arr) + zArraySize(arr) )
+        port->vp = &dzSysOutputVal(port->sp,port->port);
+    }
+  }
+}
+
+/* move outputs of a system to a bus. */
+static void _dzSysBusPlace(dzSysBus *bus, int i, int *size, bool *placed)
+{
+  dzSys *sys;
+
+  if( placed[i] ) return;
+  placed[i] = true;
+  sys = zArrayElemNC(bus->arr,i);
+  bus->offset[i] = *size;
+  if( !dzSysOutput(sys) ) return;
+  bus->org[i] = zVecBufNC(dzSysOutput(sys));
+  memcpy( bus->buf + *size, bus->org[i], sizeof(double)*dzSysOutputNum(sys) );
+  zVecBufNC(dzSysOutput(sys)) = bus->buf + *size;
+  *size += dzSysOutputNum(sys);
+}
+
+/* create a signal bus. */
+dzSysBus *dzSysBusCreate(dzSysBus *bus, dzSysPlan *plan)
+{
+  dzSysArray *arr;
+  bool *placed;
+  int i, k, size = 0;
+
+  dzSysBusInit( bus );
+  arr = bus->arr = plan->arr;
+  for( i=0; i<zArraySize(arr); i++ )
+    if( dzSysOutput(zArrayElemNC(arr,i)) )
+      bus->size += dzSysOutputNum(zArrayElemNC(arr,i));
+  bus->_mem = zAlloc( char, sizeof(double)*zMax(bus->size,1) + DZ_SYS_BUS_ALIGN );
+  bus->offset = zAlloc( int, zMax(zArraySize(arr),1) );
+  bus->org = zAlloc( double*, zMax(zArraySize(arr),1) );
+  placed = zAlloc( bool, zMax(zArraySize(arr),1) );
+  if( !bus->_mem || !bus->offset || !bus->org || !placed ){
+    ZALLOCERROR();
+    zFree( bus->_mem );
+    zFree( bus->offset );
+    zFree( bus->org );
+    zFree( placed );
+    dzSysBusInit( bus );
+    return NULL;
+  }
+  bus->buf = (double *)( (char *)bus->_mem +
+    ( DZ_SYS_BUS_ALIGN - (size_t)bus->_mem % DZ_SYS_BUS_ALIGN ) % DZ_SYS_BUS_ALIGN );
+  /* scheduled systems first, in the order of execution */
+  for( k=0; k<plan->num; k++ )
+    _dzSysBusPlace( bus, plan->sys[k]-zArrayBuf(arr), &size, placed );
+  for( i=0; i<zArraySize(arr); i++ )
+    _dzSysBusPlace( bus, i, &size, placed );
+  _dzSysBusResolve( arr );
+  zFree( placed );
+  return bus;
+}
+
+/* destroy a signal bus. */
+void dzSysBusDestroy(dzSysBus *bus)
+{
+  dzSys *sys;
+  int i;
+
+  if( !bus->arr ) return;
+  for( i=0; i<zArraySize(bus->arr); i++ ){
+    if( !bus->org[i] ) continue;
+    sys = zArrayElemNC(bus->arr,i);
+    memcpy( bus->org[i], zVecBufNC(dzSysOutput(sys)), sizeof(double)*dzSysOutputNum(sys) );
+    zVecBufNC(dzSysOutput(sys)) = bus->org[i];
+  }
+  _dzSysBusResolve( bus->arr );
+  zFree( bus->_mem );
+  zFree( bus->offset );
+  zFree( bus->org );
+  dzSysBusInit( bus );
+}
+
+/* copy all signals of a bus. */
+double *dzSysBusCopy(dzSysBus *bus, double *dest)
+{
+  memcpy( dest, bus->buf, sizeof(double)*bus->size );
+  return dest;
+}
+
+/* print all signals of a bus in a line. */
+void dzSysBusFPrint(FILE *fp, dzSysBus *bus)
+{
+  int i;
+
+  for( i=0; i<bus->size; i++ )
+    fprintf( fp, "%.10g ", bus->buf[i] );
+  fprintf( fp, "\n" );
+}
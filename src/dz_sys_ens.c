@@ -0,0 +1,243 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_ens - ensemble of perturbed arrays of systems
+ */
+
+#define _POSIX_C_SOURCE 200112L /* for POSIX threads and sysconf() */
+
+#include <dzco/dz_sys.h>
+#include <unistd.h>
+
+#if defined(_POSIX_THREADS) && _POSIX_THREADS > 0
+#define __DZ_SYS_ENS_THREAD
+#include <pthread.h>
+#endif
+
+/* ********************************************************** */
+/* ensemble of copies of an array of systems
+ * ********************************************************** */
+
+/* destroy instances of an ensemble created so far. */
+static void _dzSysEnsAbort(dzSysEns *ens, int n)
+{
+  int k;
+
+  for( k=0; k<n; k++ )
+    dzSysArrayDestroy( &ens->arr[k] );
+  zFree( ens->arr );
+  ens->num = 0;
+}
+
+/* create an ensemble. */
+dzSysEns *dzSysEnsCreate(dzSysEns *ens, dzSysArray *arr, int num, bool (* perturb)(dzSysArray*,int,void*), void *util)
+{
+  int k;
+
+  ens->num = 0;
+  ens->outsys = -1;
+  ens->outnum = 0;
+  ens->final = ens->peak = ens->ise = NULL;
+  if( !( ens->arr = zAlloc( dzSysArray, zMax(num,1) ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  for( k=0; k<num; k++ ){
+    if( !dzSysArrayClone( arr, &ens->arr[k] ) ){
+      _dzSysEnsAbort( ens, k );
+      return NULL;
+    }
+    if( perturb && !perturb( &ens->arr[k], k, util ) ){
+      _dzSysEnsAbort( ens, k+1 );
+      return NULL;
+    }
+  }
+  ens->num = num;
+  return ens;
+}
+
+/* destroy an ensemble. */
+void dzSysEnsDestroy(dzSysEns *ens)
+{
+  _dzSysEnsAbort( ens, ens->num );
+  zFree( ens->final );
+  zFree( ens->peak );
+  zFree( ens->ise );
+  ens->outsys = -1;
+  ens->outnum = 0;
+}
+
+/* simulate an instance of an ensemble. */
+static bool _dzSysEnsSim(dzSysEns *ens, int k, double dt, int step)
+{
+  dzSysPlan plan;
+  dzSys *sys;
+  double *final, *peak, *ise, val;
+  int i, j;
+
+  if( !dzSysPlanCreate( &plan, &ens->arr[k] ) ) return false;
+  sys = zArrayElemNC(&ens->arr[k],ens->outsys);
+  final = &dzSysEnsFinal(ens,k,0);
+  peak = &dzSysEnsPeak(ens,k,0);
+  ise = &dzSysEnsISE(ens,k,0);
+  for( i=0; i<ens->outnum; i++ ){
+    final[i] = dzSysOutputVal(sys,i);
+    peak[i] = -HUGE_VAL;
+    ise[i] = 0;
+  }
+  for( j=0; j<step; j++ ){
+    dzSysPlanUpdate( &plan, dt );
+    for( i=0; i<ens->outnum; i++ ){
+      val = dzSysOutputVal(sys,i);
+      if( val > peak[i] ) peak[i] = val;
+      ise[i] += val * val * dt;
+    }
+  }
+  for( i=0; i<ens->outnum; i++ ){
+    final[i] = dzSysOutputVal(sys,i);
+    if( step == 0 ) peak[i] = final[i];
+  }
+  dzSysPlanDestroy( &plan );
+  return true;
+}
+
+/* task shared by threads */
+typedef struct{
+  dzSysEns *ens;
+  double dt;
+  int step;
+  int next; /* index of the next instance to be simulated */
+  bool ret;
+#ifdef __DZ_SYS_ENS_THREAD
+  pthread_mutex_t mutex;
+#endif
+} _dzSysEnsTask;
+
+/* simulate instances until none is left. */
+static void *_dzSysEnsWorker(void *arg)
+{
+  _dzSysEnsTask *task;
+  int k;
+  bool ret = true;
+
+  task = (_dzSysEnsTask *)arg;
+  while( 1 ){
+#ifdef __DZ_SYS_ENS_THREAD
+    pthread_mutex_lock( &task->mutex );
+#endif
+    k = task->next++;
+    if( !ret ) task->ret = false;
+#ifdef __DZ_SYS_ENS_THREAD
+    pthread_mutex_unlock( &task->mutex );
+#endif
+    if( k >= task->ens->num ) break;
+    if( !_dzSysEnsSim( task->ens, k, task->dt, task->step ) ) ret = false;
+  }
+  return NULL;
+}
+
+/* number of online processors. */
+static int _dzSysEnsProcNum(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+  long n;
+
+  if( ( n = sysconf( _SC_NPROCESSORS_ONLN ) ) > 0 ) return (int)n;
+#endif
+  return 1;
+}
+
+/* run simulations of an ensemble. */
+bool dzSysEnsRun(dzSysEns *ens, int outsys, double dt, int step, int threadnum)
+{
+  _dzSysEnsTask task;
+#ifdef __DZ_SYS_ENS_THREAD
+  pthread_t *thread = NULL;
+  int i;
+#endif
+
+  if( ens->num == 0 ){
+    ZRUNWARN( DZ_WARN_SYSENS_EMPTY );
+    return true;
+  }
+  if( outsys < 0 || outsys >= zArraySize(&ens->arr[0]) ){
+    ZRUNERROR( DZ_ERR_SYSENS_INVALID_OUTSYS, outsys );
+    return false;
+  }
+  zFree( ens->final );
+  zFree( ens->peak );
+  zFree( ens->ise );
+  ens->outsys = outsys;
+  ens->outnum = dzSysOutputNum( zArrayElemNC(&ens->arr[0],outsys) );
+  ens->final = zAlloc( double, ens->num*zMax(ens->outnum,1) );
+  ens->peak = zAlloc( double, ens->num*zMax(ens->outnum,1) );
+  ens->ise = zAlloc( double, ens->num*zMax(ens->outnum,1) );
+  if( !ens->final || !ens->peak || !ens->ise ){
+    ZALLOCERROR();
+    return false;
+  }
+  task.ens = ens;
+  task.dt = dt;
+  task.step = step;
+  task.next = 0;
+  task.ret = true;
+  if( threadnum <= 0 ) threadnum = _dzSysEnsProcNum();
+  threadnum = zMin( threadnum, ens->num );
+#ifdef __DZ_SYS_ENS_THREAD
+  pthread_mutex_init( &task.mutex, NULL );
+  if( threadnum > 1 && !( thread = zAlloc( pthread_t, threadnum-1 ) ) )
+    threadnum = 1;
+  for( i=0; i<threadnum-1; i++ )
+    if( pthread_create( &thread[i], NULL, _dzSysEnsWorker, &task ) != 0 ) break;
+  _dzSysEnsWorker( &task ); /* the calling thread also works */
+  if( threadnum > 1 ){
+    while( --i >= 0 )
+      pthread_join( thread[i], NULL );
+    zFree( thread );
+  }
+  pthread_mutex_destroy( &task.mutex );
+#else
+  _dzSysEnsWorker( &task );
+#endif
+  return task.ret;
+}
+
+/* perturb a parameter of a system. */
+bool dzSysPerturbPrp(dzSys *sys, int i, double ratio)
+{
+  if( i < 0 || i >= sys->com->_prpnum ){
+    ZRUNERROR( DZ_ERR_SYSENS_UNPERTURBABLE, sys->com->typestr, i );
+    return false;
+  }
+  ((double *)sys->prp)[i] *= 1 + zRandF( -ratio, ratio );
+  return true;
+}
+
+/* print results of an ensemble. */
+void dzSysEnsFPrint(FILE *fp, dzSysEns *ens)
+{
+  double *val[3], mean, var;
+  const char *label[] = { "final", "peak", "ISE" };
+  int k, i, j;
+
+  val[0] = ens->final;
+  val[1] = ens->peak;
+  val[2] = ens->ise;
+  for( k=0; k<ens->num; k++ ){
+    fprintf( fp, "%d", k );
+    for( j=0; j<3; j++ )
+      for( i=0; i<ens->outnum; i++ )
+        fprintf( fp, " %.10g", val[j][k*ens->outnum+i] );
+    fprintf( fp, "\n" );
+  }
+  for( j=0; j<3; j++ )
+    for( i=0; i<ens->outnum; i++ ){
+      for( mean=0, k=0; k<ens->num; k++ )
+        mean += val[j][k*ens->outnum+i];
+      mean /= zMax( ens->num, 1 );
+      for( var=0, k=0; k<ens->num; k++ )
+        var += zSqr( val[j][k*ens->outnum+i] - mean );
+      var /= zMax( ens->num, 1 );
+      fprintf( fp, "# %s[%d]: mean=%.10g sd=%.10g\n", label[j], i, mean, sqrt( var ) );
+    }
+}
@@ -6,6 +6,12 @@
 
 #include <dzco/dz_sys.h>
 
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 /*! \brief first-order Butterworth filter */
 typedef struct{
   double out;
@@ -188,6 +194,93 @@ static void _dzSysBWFPrintZTK(FILE *fp, dzSys *sys)
   _ZTKPrpKeyFPrint( fp, sys, __ztk_prp_dzsys_bw );
 }
 
+/* binary image of a Butterworth filter */
+static bool _dzSysBWEncode(dzSys *sys, dzSysBin *bin)
+{
+  _dzBW *bw;
+  uint i;
+
+  bw = (_dzBW *)sys->prp;
+  if( !dzSysBinWriteDouble( bin, bw->cf ) ||
+      !dzSysBinWriteInt( bin, bw->dim ) ) return false;
+  if( bw->n1 > 0 && !dzSysBinWriteDouble( bin, bw->f1->out ) ) return false;
+  for( i=0; i<bw->n2; i++ )
+    if( !dzSysBinWriteDouble( bin, bw->f2[i].out ) ||
+        !dzSysBinWriteDouble( bin, bw->f2[i].prevout ) ||
+        !dzSysBinWriteDouble( bin, bw->f2[i].prevdt ) ) return false;
+  return true;
+}
+
+static dzSys *_dzSysBWDecode(dzSys *sys, dzSysBin *bin)
+{
+  _dzBW *bw;
+  double cf;
+  int dim;
+  uint i;
+
+  if( !dzSysBinReadDouble( bin, &cf ) || !dzSysBinReadInt( bin, &dim ) ) return NULL;
+  if( dim <= 0 || !dzSysBWCreate( sys, cf, dim ) ) goto FAILURE;
+  bw = (_dzBW *)sys->prp;
+  if( bw->n1 > 0 && !dzSysBinReadDouble( bin, &bw->f1->out ) ) goto FAILURE;
+  for( i=0; i<bw->n2; i++ )
+    if( !dzSysBinReadDouble( bin, &bw->f2[i].out ) ||
+        !dzSysBinReadDouble( bin, &bw->f2[i].prevout ) ||
+        !dzSysBinReadDouble( bin, &bw->f2[i].prevdt ) ) goto FAILURE;
+  return sys;
+
+ FAILURE:
+  dzSysDestroy( sys );
+  return NULL;
+}
+
+static dzSys *_dzSysBWClone(dzSys *src, dzSys *dest)
+{
+  _dzBW *org, *bw;
+
+  org = (_dzBW *)src->prp;
+  if( !dzSysBWCreate( dest, org->cf, org->dim ) ) return NULL;
+  bw = (_dzBW *)dest->prp;
+  if( org->n1 > 0 ) memcpy( bw->f1, org->f1, sizeof(_dzBW1)*org->n1 );
+  if( org->n2 > 0 ) memcpy( bw->f2, org->f2, sizeof(_dzBW2)*org->n2 );
+  return dest;
+}
+
+/* the state of each section is saved as a flat array of double-precision
+ * values. coefficients are not included since they are determined by the
+ * cutoff frequency and the dimension. */
+static int _dzSysBWSnapshot(dzSys *sys, double *buf)
+{
+  _dzBW *bw;
+  uint i;
+
+  bw = (_dzBW *)sys->prp;
+  if( buf ){
+    for( i=0; i<bw->n1; i++ )
+      *buf++ = bw->f1[i].out;
+    for( i=0; i<bw->n2; i++ ){
+      *buf++ = bw->f2[i].out;
+      *buf++ = bw->f2[i].prevout;
+      *buf++ = bw->f2[i].prevdt;
+    }
+  }
+  return bw->n1 + 3 * bw->n2;
+}
+
+static void _dzSysBWRestore(dzSys *sys, const double *buf)
+{
+  _dzBW *bw;
+  uint i;
+
+  bw = (_dzBW *)sys->prp;
+  for( i=0; i<bw->n1; i++ )
+    bw->f1[i].out = *buf++;
+  for( i=0; i<bw->n2; i++ ){
+    bw->f2[i].out = *buf++;
+    bw->f2[i].prevout = *buf++;
+    bw->f2[i].prevdt = *buf++;
+  }
+}
+
 dzSysCom dz_sys_bw_com = {
   .typestr = "butterworth",
   ._destroy = dzSysBWDestroy,
@@ -195,6 +288,11 @@ dzSysCom dz_sys_bw_com = {
   ._update = dzSysBWUpdate,
   ._fromZTK = _dzSysBWFromZTK,
   ._fprintZTK = _dzSysBWFPrintZTK,
+  ._encode = _dzSysBWEncode,
+  ._decode = _dzSysBWDecode,
+  ._clone = _dzSysBWClone,
+  ._snapshot = _dzSysBWSnapshot,
+  ._restore = _dzSysBWRestore,
 };
 
 /* create a Butterworth filter. */
@@ -208,3 +306,325 @@ dzSys *dzSysBWCreate(dzSys *sys, double cf, uint dim)
          ( sys->prp = zAlloc( _dzBW, 1 ) ) &&
          _dzBWCreate( (_dzBW *)sys->prp, cf, dim ) ? sys : NULL;
 }
+
+/* ********************************************************** */
+/* multi-channel Butterworth filter
+ * ********************************************************** */
+
+/* internal states of all channels are stored section by section,
+ * while the coefficients are shared with those of a single-channel
+ * filter.
+ */
+typedef struct{
+  _dzBW bw;       /* coefficients */
+  int n;          /* number of channels */
+  double prevdt;
+  double *in;     /* gathered inputs */
+  double *out1;   /* outputs of the first-order section */
+  double *out2;   /* outputs of second-order sections (n2 x n) */
+  double *prev2;  /* previous outputs of second-order sections (n2 x n) */
+} _dzBWMulti;
+
+#define __dz_sys_bwmulti(s) ( (_dzBWMulti *)(s)->prp )
+
+/* first-order section of all channels: out = c0 * out + c1 * x */
+static void _dzBWMulti1Update(int n, double *out, const double *x, double c0, double c1)
+{
+  int i = 0;
+#if defined(__AVX512F__)
+  __m512d vc0, vc1;
+
+  vc0 = _mm512_set1_pd( c0 ); vc1 = _mm512_set1_pd( c1 );
+  for( ; i+8<=n; i+=8 )
+    _mm512_storeu_pd( out+i, _mm512_add_pd( _mm512_mul_pd( vc0, _mm512_loadu_pd( out+i ) ), _mm512_mul_pd( vc1, _mm512_loadu_pd( x+i ) ) ) );
+#elif defined(__AVX2__)
+  __m256d vc0, vc1;
+
+  vc0 = _mm256_set1_pd( c0 ); vc1 = _mm256_set1_pd( c1 );
+  for( ; i+4<=n; i+=4 )
+    _mm256_storeu_pd( out+i, _mm256_add_pd( _mm256_mul_pd( vc0, _mm256_loadu_pd( out+i ) ), _mm256_mul_pd( vc1, _mm256_loadu_pd( x+i ) ) ) );
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  float64x2_t vc0, vc1;
+
+  vc0 = vdupq_n_f64( c0 ); vc1 = vdupq_n_f64( c1 );
+  for( ; i+2<=n; i+=2 )
+    vst1q_f64( out+i, vaddq_f64( vmulq_f64( vc0, vld1q_f64( out+i ) ), vmulq_f64( vc1, vld1q_f64( x+i ) ) ) );
+#endif
+  for( ; i<n; i++ ) /* scalar fallback and remainder */
+    out[i] = c0 * out[i] + c1 * x[i];
+}
+
+/* second-order section of all channels: out = c0 * out + c1 * prev + c2 * x */
+static void _dzBWMulti2Update(int n, double *out, double *prev, const double *x, double c0, double c1, double c2)
+{
+  double ret;
+  int i = 0;
+#if defined(__AVX512F__)
+  __m512d vc0, vc1, vc2, vout;
+
+  vc0 = _mm512_set1_pd( c0 ); vc1 = _mm512_set1_pd( c1 ); vc2 = _mm512_set1_pd( c2 );
+  for( ; i+8<=n; i+=8 ){
+    vout = _mm512_loadu_pd( out+i );
+    _mm512_storeu_pd( out+i, _mm512_add_pd( _mm512_add_pd( _mm512_mul_pd( vc0, vout ), _mm512_mul_pd( vc1, _mm512_loadu_pd( prev+i ) ) ), _mm512_mul_pd( vc2, _mm512_loadu_pd( x+i ) ) ) );
+    _mm512_storeu_pd( prev+i, vout );
+  }
+#elif defined(__AVX2__)
+  __m256d vc0, vc1, vc2, vout;
+
+  vc0 = _mm256_set1_pd( c0 ); vc1 = _mm256_set1_pd( c1 ); vc2 = _mm256_set1_pd( c2 );
+  for( ; i+4<=n; i+=4 ){
+    vout = _mm256_loadu_pd( out+i );
+    _mm256_storeu_pd( out+i, _mm256_add_pd( _mm256_add_pd( _mm256_mul_pd( vc0, vout ), _mm256_mul_pd( vc1, _mm256_loadu_pd( prev+i ) ) ), _mm256_mul_pd( vc2, _mm256_loadu_pd( x+i ) ) ) );
+    _mm256_storeu_pd( prev+i, vout );
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  float64x2_t vc0, vc1, vc2, vout;
+
+  vc0 = vdupq_n_f64( c0 ); vc1 = vdupq_n_f64( c1 ); vc2 = vdupq_n_f64( c2 );
+  for( ; i+2<=n; i+=2 ){
+    vout = vld1q_f64( out+i );
+    vst1q_f64( out+i, vaddq_f64( vaddq_f64( vmulq_f64( vc0, vout ), vmulq_f64( vc1, vld1q_f64( prev+i ) ) ), vmulq_f64( vc2, vld1q_f64( x+i ) ) ) );
+    vst1q_f64( prev+i, vout );
+  }
+#endif
+  for( ; i<n; i++ ){ /* scalar fallback and remainder */
+    ret = c0 * out[i] + c1 * prev[i] + c2 * x[i];
+    prev[i] = out[i];
+    out[i] = ret;
+  }
+}
+
+static void _dzSysBWMultiDestroy(dzSys *sys)
+{
+  _dzBWMulti *bwm;
+
+  if( ( bwm = __dz_sys_bwmulti(sys) ) ){
+    _dzBWDestroy( &bwm->bw );
+    zFree( bwm->in );
+    zFree( bwm->out1 );
+    zFree( bwm->out2 );
+    zFree( bwm->prev2 );
+  }
+  dzSysDefaultDestroy( sys );
+}
+
+static void _dzSysBWMultiRefresh(dzSys *sys)
+{
+  _dzBWMulti *bwm;
+
+  bwm = __dz_sys_bwmulti(sys);
+  bwm->prevdt = 1.0; /* dummy */
+  if( bwm->bw.n1 > 0 )
+    memset( bwm->out1, 0, sizeof(double)*bwm->n );
+  if( bwm->bw.n2 > 0 ){
+    memset( bwm->out2, 0, sizeof(double)*bwm->bw.n2*bwm->n );
+    memset( bwm->prev2, 0, sizeof(double)*bwm->bw.n2*bwm->n );
+  }
+  zVecZero( dzSysOutput(sys) );
+}
+
+/* the coefficients of each section are computed once per step and
+ * applied to all channels. */
+static zVec _dzSysBWMultiUpdate(dzSys *sys, double dt)
+{
+  _dzBWMulti *bwm;
+  double wt, tr, zwt2, den, *x;
+  uint k;
+  int i;
+
+  bwm = __dz_sys_bwmulti(sys);
+  for( i=0; i<bwm->n; i++ )
+    bwm->in[i] = dzSysInputVal(sys,i);
+  x = bwm->in;
+  wt = bwm->bw.wc * dt;
+  if( bwm->bw.n1 > 0 ){
+    _dzBWMulti1Update( bwm->n, bwm->out1, x, 1.0/(1+wt), wt/(1+wt) );
+    x = bwm->out1;
+  }
+  tr = dt / bwm->prevdt;
+  for( k=0; k<bwm->bw.n2; k++ ){
+    zwt2 = 1 + 2 * bwm->bw.f2[k].zeta * wt;
+    den = 1.0 / ( zwt2 + wt*wt );
+    _dzBWMulti2Update( bwm->n, bwm->out2+k*bwm->n, bwm->prev2+k*bwm->n, x,
+      (zwt2+tr)*den, -tr*den, wt*wt*den );
+    x = bwm->out2 + k*bwm->n;
+  }
+  bwm->prevdt = dt;
+  memcpy( zVecBufNC(dzSysOutput(sys)), x, sizeof(double)*bwm->n );
+  return dzSysOutput(sys);
+}
+
+typedef struct{
+  double cf;
+  uint dim;
+  int n;
+} _dzBWMultiParam;
+
+static void *_dzSysBWMultiCFFromZTK(void *val, int i, void *arg, ZTK *ztk){
+  ((_dzBWMultiParam*)val)->cf = ZTKDouble(ztk);
+  return val;
+}
+static void *_dzSysBWMultiDimFromZTK(void *val, int i, void *arg, ZTK *ztk){
+  ((_dzBWMultiParam*)val)->dim = ZTKInt(ztk);
+  return val;
+}
+static void *_dzSysBWMultiNumFromZTK(void *val, int i, void *arg, ZTK *ztk){
+  ((_dzBWMultiParam*)val)->n = ZTKInt(ztk);
+  return val;
+}
+
+static bool _dzSysBWMultiCFFPrintZTK(FILE *fp, int i, void *prp){
+  fprintf( fp, "%.10g\n", __dz_sys_bwmulti((dzSys*)prp)->bw.cf );
+  return true;
+}
+static bool _dzSysBWMultiDimFPrintZTK(FILE *fp, int i, void *prp){
+  fprintf( fp, "%d\n", __dz_sys_bwmulti((dzSys*)prp)->bw.dim );
+  return true;
+}
+static bool _dzSysBWMultiNumFPrintZTK(FILE *fp, int i, void *prp){
+  fprintf( fp, "%d\n", __dz_sys_bwmulti((dzSys*)prp)->n );
+  return true;
+}
+
+static const ZTKPrp __ztk_prp_dzsys_bwmulti[] = {
+  { ZTK_KEY_DZCO_SYS_CUTOFFFREQ, 1, _dzSysBWMultiCFFromZTK, _dzSysBWMultiCFFPrintZTK },
+  { ZTK_KEY_DZCO_SYS_DIM,        1, _dzSysBWMultiDimFromZTK, _dzSysBWMultiDimFPrintZTK },
+  { ZTK_KEY_DZCO_SYS_INPUTNUM,   1, _dzSysBWMultiNumFromZTK, _dzSysBWMultiNumFPrintZTK },
+};
+
+static dzSys *_dzSysBWMultiFromZTK(dzSys *sys, ZTK *ztk)
+{
+  _dzBWMultiParam prm = { 1.0, 1, 1 };
+  if( !_ZTKEvalKey( &prm, NULL, ztk, __ztk_prp_dzsys_bwmulti ) ) return NULL;
+  return dzSysBWMultiCreate( sys, prm.cf, prm.dim, prm.n );
+}
+
+static void _dzSysBWMultiFPrintZTK(FILE *fp, dzSys *sys)
+{
+  _ZTKPrpKeyFPrint( fp, sys, __ztk_prp_dzsys_bwmulti );
+}
+
+/* binary image of a multi-channel Butterworth filter */
+static bool _dzSysBWMultiEncode(dzSys *sys, dzSysBin *bin)
+{
+  _dzBWMulti *bwm;
+
+  bwm = __dz_sys_bwmulti(sys);
+  return dzSysBinWriteDouble( bin, bwm->bw.cf ) &&
+         dzSysBinWriteInt( bin, bwm->bw.dim ) &&
+         dzSysBinWriteInt( bin, bwm->n ) &&
+         dzSysBinWriteDouble( bin, bwm->prevdt ) &&
+         dzSysBinWriteDoubleArray( bin, bwm->out1, bwm->bw.n1*bwm->n ) &&
+         dzSysBinWriteDoubleArray( bin, bwm->out2, bwm->bw.n2*bwm->n ) &&
+         dzSysBinWriteDoubleArray( bin, bwm->prev2, bwm->bw.n2*bwm->n );
+}
+
+static dzSys *_dzSysBWMultiDecode(dzSys *sys, dzSysBin *bin)
+{
+  _dzBWMulti *bwm;
+  double cf;
+  int dim, n;
+
+  if( !dzSysBinReadDouble( bin, &cf ) ||
+      !dzSysBinReadInt( bin, &dim ) ||
+      !dzSysBinReadInt( bin, &n ) ) return NULL;
+  if( dim <= 0 || n <= 0 || !dzSysBWMultiCreate( sys, cf, dim, n ) ) goto FAILURE;
+  bwm = __dz_sys_bwmulti(sys);
+  if( !dzSysBinReadDouble( bin, &bwm->prevdt ) ||
+      !dzSysBinReadDoubleArray( bin, bwm->out1, bwm->bw.n1*n ) ||
+      !dzSysBinReadDoubleArray( bin, bwm->out2, bwm->bw.n2*n ) ||
+      !dzSysBinReadDoubleArray( bin, bwm->prev2, bwm->bw.n2*n ) ) goto FAILURE;
+  return sys;
+
+ FAILURE:
+  dzSysDestroy( sys );
+  return NULL;
+}
+
+static dzSys *_dzSysBWMultiClone(dzSys *src, dzSys *dest)
+{
+  _dzBWMulti *org, *bwm;
+
+  org = __dz_sys_bwmulti(src);
+  if( !dzSysBWMultiCreate( dest, org->bw.cf, org->bw.dim, org->n ) ) return NULL;
+  bwm = __dz_sys_bwmulti(dest);
+  bwm->prevdt = org->prevdt;
+  if( org->bw.n1 > 0 )
+    memcpy( bwm->out1, org->out1, sizeof(double)*org->bw.n1*org->n );
+  if( org->bw.n2 > 0 ){
+    memcpy( bwm->out2, org->out2, sizeof(double)*org->bw.n2*org->n );
+    memcpy( bwm->prev2, org->prev2, sizeof(double)*org->bw.n2*org->n );
+  }
+  return dest;
+}
+
+static int _dzSysBWMultiSnapshot(dzSys *sys, double *buf)
+{
+  _dzBWMulti *bwm;
+
+  bwm = __dz_sys_bwmulti(sys);
+  if( buf ){
+    *buf++ = bwm->prevdt;
+    if( bwm->bw.n1 > 0 ) memcpy( buf, bwm->out1, sizeof(double)*bwm->n );
+    buf += bwm->bw.n1*bwm->n;
+    if( bwm->bw.n2 > 0 ){
+      memcpy( buf, bwm->out2, sizeof(double)*bwm->bw.n2*bwm->n );
+      memcpy( buf+bwm->bw.n2*bwm->n, bwm->prev2, sizeof(double)*bwm->bw.n2*bwm->n );
+    }
+  }
+  return 1 + ( bwm->bw.n1 + 2*bwm->bw.n2 ) * bwm->n;
+}
+
+static void _dzSysBWMultiRestore(dzSys *sys, const double *buf)
+{
+  _dzBWMulti *bwm;
+
+  bwm = __dz_sys_bwmulti(sys);
+  bwm->prevdt = *buf++;
+  if( bwm->bw.n1 > 0 ) memcpy( bwm->out1, buf, sizeof(double)*bwm->n );
+  buf += bwm->bw.n1*bwm->n;
+  if( bwm->bw.n2 > 0 ){
+    memcpy( bwm->out2, buf, sizeof(double)*bwm->bw.n2*bwm->n );
+    memcpy( bwm->prev2, buf+bwm->bw.n2*bwm->n, sizeof(double)*bwm->bw.n2*bwm->n );
+  }
+}
+
+dzSysCom dz_sys_bwmulti_com = {
+  .typestr = "butterworth_multi",
+  ._destroy = _dzSysBWMultiDestroy,
+  ._refresh = _dzSysBWMultiRefresh,
+  ._update = _dzSysBWMultiUpdate,
+  ._fromZTK = _dzSysBWMultiFromZTK,
+  ._fprintZTK = _dzSysBWMultiFPrintZTK,
+  ._encode = _dzSysBWMultiEncode,
+  ._decode = _dzSysBWMultiDecode,
+  ._clone = _dzSysBWMultiClone,
+  ._snapshot = _dzSysBWMultiSnapshot,
+  ._restore = _dzSysBWMultiRestore,
+};
+
+/* create a multi-channel Butterworth filter. */
+dzSys *dzSysBWMultiCreate(dzSys *sys, double cf, uint dim, int n)
+{
+  _dzBWMulti *bwm;
+
+  dzSysInit( sys );
+  sys->com = &dz_sys_bwmulti_com;
+  dzSysAllocInput( sys, n );
+  if( dzSysInputNum(sys) != n ||
+      !dzSysAllocOutput( sys, n ) ||
+      !( sys->prp = ( bwm = zAlloc( _dzBWMulti, 1 ) ) ) ) return NULL;
+  if( !_dzBWCreate( &bwm->bw, cf, dim ) ) return NULL;
+  bwm->n = n;
+  bwm->in = zAlloc( double, n );
+  bwm->out1 = bwm->bw.n1 > 0 ? zAlloc( double, n ) : NULL;
+  bwm->out2 = bwm->bw.n2 > 0 ? zAlloc( double, bwm->bw.n2*n ) : NULL;
+  bwm->prev2 = bwm->bw.n2 > 0 ? zAlloc( double, bwm->bw.n2*n ) : NULL;
+  if( !bwm->in || ( bwm->bw.n1 > 0 && !bwm->out1 ) ||
+      ( bwm->bw.n2 > 0 && ( !bwm->out2 || !bwm->prev2 ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  dzSysRefresh( sys );
+  return sys;
+}
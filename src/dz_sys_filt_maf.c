@@ -66,6 +66,7 @@ dzSysCom dz_sys_maf_com = {
   ._update = _dzSysMAFUpdate,
   ._fromZTK = _dzSysMAFFromZTK,
   ._fprintZTK = _dzSysMAFFPrintZTK,
+  ._prpnum = 2,
 };
 
 void dzSysMAFSetCF(dzSys *sys, double cf, double dt)
@@ -0,0 +1,386 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_fuse - fusion of chains of linear systems
+ */
+
+#include <dzco/dz_sys.h>
+
+/* ********************************************************** */
+/* state-space model of a single-input-single-output system
+ * ********************************************************** */
+
+typedef struct{
+  int n;     /* dimension of the state */
+  double *a; /* system matrix in row-major order */
+  double *b; /* input coefficients */
+  double *c; /* output coefficients */
+  double d;  /* feedthrough gain */
+} _dzSysFuseSS;
+
+static void _dzSysFuseSSInit(_dzSysFuseSS *ss, double d)
+{
+  ss->n = 0;
+  ss->a = ss->b = ss->c = NULL;
+  ss->d = d;
+}
+
+static void _dzSysFuseSSFree(_dzSysFuseSS *ss)
+{
+  zFree( ss->a );
+  zFree( ss->b );
+  zFree( ss->c );
+  ss->n = 0;
+}
+
+static bool _dzSysFuseSSAlloc(_dzSysFuseSS *ss, int n)
+{
+  _dzSysFuseSSInit( ss, 0 );
+  if( ( ss->n = n ) == 0 ) return true;
+  ss->a = zAlloc( double, n*n );
+  ss->b = zAlloc( double, n );
+  ss->c = zAlloc( double, n );
+  if( !ss->a || !ss->b || !ss->c ){
+    ZALLOCERROR();
+    _dzSysFuseSSFree( ss );
+    return false;
+  }
+  return true;
+}
+
+/* copy a linear system. */
+static bool _dzSysFuseSSFromLin(_dzSysFuseSS *ss, dzLin *lin)
+{
+  int i, j;
+
+  if( !_dzSysFuseSSAlloc( ss, dzLinDim(lin) ) ) return false;
+  for( i=0; i<ss->n; i++ ){
+    for( j=0; j<ss->n; j++ )
+      ss->a[i*ss->n+j] = zMatElemNC(lin->a,i,j);
+    ss->b[i] = zVecElemNC(lin->b,i);
+    ss->c[i] = zVecElemNC(lin->c,i);
+  }
+  ss->d = lin->d;
+  return true;
+}
+
+/* controllable canonical form of a proper transfer function. */
+static bool _dzSysFuseSSFromTF(_dzSysFuseSS *ss, dzTF *tf)
+{
+  dzLin lin;
+  bool ret;
+
+  if( dzTFDenDim(tf) == 0 ){ /* static gain */
+    _dzSysFuseSSInit( ss, dzTFNumElem(tf,0) / dzTFDenElem(tf,0) );
+    return true;
+  }
+  dzLinInit( &lin );
+  if( !dzTF2LinCtrlCanon( tf, &lin ) ) return false;
+  ret = _dzSysFuseSSFromLin( ss, &lin );
+  dzLinDestroy( &lin );
+  return ret;
+}
+
+/* state-space model of a system, or the false value if it is not linear. */
+static bool _dzSysFuseSSFromSys(_dzSysFuseSS *ss, dzSys *sys)
+{
+  dzTF tf;
+  bool ret = false;
+
+  if( dzSysInputNum(sys) != 1 || dzSysOutputNum(sys) != 1 || sys->period > 0 ) return false;
+  if( sys->com == &dz_sys_lin_com ) return _dzSysFuseSSFromLin( ss, dzSysLin(sys) );
+  if( !sys->com->_tf || !sys->com->_tf( sys, &tf ) ) return false;
+  if( dzTFNumDim(&tf) <= dzTFDenDim(&tf) && !zIsTiny( dzTFDenElem(&tf,dzTFDenDim(&tf)) ) )
+    ret = _dzSysFuseSSFromTF( ss, &tf );
+  dzTFDestroy( &tf );
+  return ret;
+}
+
+/* connect two state-space models in series, the output of s1 to the input of s2. */
+static bool _dzSysFuseSSSeries(_dzSysFuseSS *s1, _dzSysFuseSS *s2, _dzSysFuseSS *ss)
+{
+  int i, j, n1;
+
+  if( !_dzSysFuseSSAlloc( ss, s1->n+s2->n ) ) return false;
+  n1 = s1->n;
+  for( i=0; i<s1->n; i++ ){
+    for( j=0; j<s1->n; j++ )
+      ss->a[i*ss->n+j] = s1->a[i*s1->n+j];
+    ss->b[i] = s1->b[i];
+    ss->c[i] = s2->d * s1->c[i];
+  }
+  for( i=0; i<s2->n; i++ ){
+    for( j=0; j<s1->n; j++ )
+      ss->a[(n1+i)*ss->n+j] = s2->b[i] * s1->c[j];
+    for( j=0; j<s2->n; j++ )
+      ss->a[(n1+i)*ss->n+n1+j] = s2->a[i*s2->n+j];
+    ss->b[n1+i] = s2->b[i] * s1->d;
+    ss->c[n1+i] = s2->c[i];
+  }
+  ss->d = s2->d * s1->d;
+  return true;
+}
+
+/* ********************************************************** */
+/* systems replaced by fused models
+ * ********************************************************** */
+
+typedef struct{
+  dzSys *sys;     /* system replaced by a fused model */
+  dzSysPort port; /* original input port */
+  void *prp;      /* original property */
+  dzSysCom *com;  /* original methods */
+} _dzSysFused;
+
+typedef struct{
+  int num;                   /* number of scheduled systems before fusion */
+  dzSys **sys;               /* original order of execution */
+  dzSysUpdateMethod *update; /* original updating methods */
+  int fusednum;
+  _dzSysFused *fused;
+} _dzSysFuse;
+
+/* replace a system with a fused model which reads a port. */
+static bool _dzSysFusedReplace(_dzSysFuse *fuse, dzSys *sys, dzSysPort *port, _dzSysFuseSS *ss)
+{
+  _dzSysFused *fused;
+  dzLin *lin = NULL;
+  double *gain = NULL;
+  int i, j;
+
+  if( ss->n == 0 ){ /* chain of static gains */
+    if( !( gain = zAlloc( double, 1 ) ) ){
+      ZALLOCERROR();
+      return false;
+    }
+    *gain = ss->d;
+  } else{
+    if( !( lin = zAlloc( dzLin, 1 ) ) ){
+      ZALLOCERROR();
+      return false;
+    }
+    if( !dzLinAlloc( lin, ss->n ) ){
+      zFree( lin );
+      return false;
+    }
+    for( i=0; i<ss->n; i++ ){
+      for( j=0; j<ss->n; j++ )
+        zMatSetElemNC( lin->a, i, j, ss->a[i*ss->n+j] );
+      zVecSetElemNC( lin->b, i, ss->b[i] );
+      zVecSetElemNC( lin->c, i, ss->c[i] );
+    }
+    lin->d = ss->d;
+    if( !dzLinSetZOH( lin ) ){
+      dzLinDestroy( lin );
+      zFree( lin );
+      return false;
+    }
+  }
+  fused = &fuse->fused[fuse->fusednum++];
+  fused->sys = sys;
+  fused->port = *zArrayElemNC(dzSysInput(sys),0);
+  fused->prp = sys->prp;
+  fused->com = sys->com;
+  *zArrayElemNC(dzSysInput(sys),0) = *port;
+  if( lin ){
+    sys->prp = lin;
+    sys->com = &dz_sys_lin_com;
+  } else{
+    sys->prp = gain;
+    sys->com = &dz_sys_p_com;
+  }
+  return true;
+}
+
+/* restore a system replaced by a fused model. */
+static void _dzSysFusedRestore(_dzSysFused *fused)
+{
+  dzSys *sys;
+
+  sys = fused->sys;
+  if( sys->com == &dz_sys_lin_com ) dzLinDestroy( dzSysLin(sys) );
+  zFree( sys->prp );
+  *zArrayElemNC(dzSysInput(sys),0) = fused->port;
+  sys->prp = fused->prp;
+  sys->com = fused->com;
+}
+
+static _dzSysFuse *_dzSysFuseAlloc(dzSysPlan *plan)
+{
+  _dzSysFuse *fuse;
+
+  if( !( fuse = zAlloc( _dzSysFuse, 1 ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  fuse->num = plan->num;
+  fuse->fusednum = 0;
+  fuse->sys = zAlloc( dzSys*, zMax(plan->num,1) );
+  fuse->update = zAlloc( dzSysUpdateMethod, zMax(plan->num,1) );
+  fuse->fused = zAlloc( _dzSysFused, zMax(plan->num,1) );
+  if( !fuse->sys || !fuse->update || !fuse->fused ){
+    ZALLOCERROR();
+    zFree( fuse->sys );
+    zFree( fuse->update );
+    zFree( fuse->fused );
+    zFree( fuse );
+    return NULL;
+  }
+  memcpy( fuse->sys, plan->sys, sizeof(dzSys*)*plan->num );
+  memcpy( fuse->update, plan->update, sizeof(dzSysUpdateMethod)*plan->num );
+  return fuse;
+}
+
+/* discard interpolation buffers of a multirate plan, which depend on
+ * the order of execution. The rates are recomputed at the next update. */
+static void _dzSysFuseResetRate(dzSysPlan *plan)
+{
+  int i;
+
+  if( plan->prev && plan->cur )
+    for( i=0; i<plan->num; i++ ){
+      zVecFree( plan->prev[i] );
+      zVecFree( plan->cur[i] );
+    }
+  zFree( plan->prev );
+  zFree( plan->cur );
+  plan->dt = 0;
+}
+
+/* ********************************************************** */
+/* fusion of chains of linear systems
+ * ********************************************************** */
+
+/* index of a system in an array, or -1 if it is out of the array. */
+static int _dzSysFuseIndex(dzSysArray *arr, dzSys *sys)
+{
+  if( !sys || sys < zArrayBuf(arr) || sys >= zArrayBuf(arr) + zArraySize(arr) ) return -1;
+  return sys - zArrayBuf(arr);
+}
+
+/* check if the output of a system is probed. */
+static bool _dzSysFuseIsProbed(dzSys *sys, int probenum, char *probe[])
+{
+  int i;
+
+  if( !zNamePtr(sys) ) return false;
+  for( i=0; i<probenum; i++ )
+    if( probe[i] && strcmp( zName(sys), probe[i] ) == 0 ) return true;
+  return false;
+}
+
+/* fuse chains of linear systems of an execution plan. */
+int dzSysPlanFuse(dzSysPlan *plan, int probenum, char *probe[])
+{
+  dzSysArray *arr;
+  _dzSysFuse *fuse;
+  _dzSysFuseSS *ss = NULL, fss, tmp;
+  int *pos = NULL, *next = NULL, *cnt = NULL;
+  bool *lin = NULL, *linked = NULL;
+  int n, i, j, k, p, head, chainnum = -1;
+
+  dzSysPlanUnfuse( plan );
+  arr = plan->arr;
+  n = zMax( zArraySize(arr), 1 );
+  pos = zAlloc( int, n );
+  next = zAlloc( int, n );
+  cnt = zAlloc( int, n );
+  lin = zAlloc( bool, n );
+  linked = zAlloc( bool, n );
+  ss = zAlloc( _dzSysFuseSS, n );
+  if( !pos || !next || !cnt || !lin || !linked || !ss ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  for( i=0; i<zArraySize(arr); i++ ){
+    pos[i] = next[i] = -1;
+    _dzSysFuseSSInit( &ss[i], 0 );
+  }
+  for( k=0; k<plan->num; k++ )
+    pos[plan->sys[k]-zArrayBuf(arr)] = k;
+  for( i=0; i<zArraySize(arr); i++ )
+    for( k=0; k<dzSysInputNum(zArrayElemNC(arr,i)); k++ )
+      if( ( j = _dzSysFuseIndex( arr, dzSysInputElem(zArrayElemNC(arr,i),k)->sp ) ) >= 0 )
+        cnt[j]++;
+  for( i=0; i<zArraySize(arr); i++ )
+    if( pos[i] >= 0 ) lin[i] = _dzSysFuseSSFromSys( &ss[i], zArrayElemNC(arr,i) );
+  /* a linear system read only by the next one updated after it is linked */
+  for( j=0; j<zArraySize(arr); j++ ){
+    if( !lin[j] ) continue;
+    if( ( i = _dzSysFuseIndex( arr, dzSysInputElem(zArrayElemNC(arr,j),0)->sp ) ) < 0 ||
+        !lin[i] || cnt[i] != 1 || pos[i] > pos[j] ||
+        _dzSysFuseIsProbed( zArrayElemNC(arr,i), probenum, probe ) ) continue;
+    next[i] = j;
+    linked[j] = true;
+  }
+  if( !( fuse = _dzSysFuseAlloc( plan ) ) ) goto TERMINATE;
+  plan->fuse = fuse;
+  _dzSysFuseResetRate( plan );
+  chainnum = 0;
+  for( k=0; k<plan->num; k++ ){
+    head = plan->sys[k] - zArrayBuf(arr);
+    if( !lin[head] || linked[head] ) continue;
+    /* a system reading a producer updated after it stays out of the
+     * chain, since the fused model is updated later. */
+    while( next[head] >= 0 &&
+           ( p = _dzSysFuseIndex( arr, dzSysInputElem(zArrayElemNC(arr,head),0)->sp ) ) >= 0 &&
+           pos[p] > pos[head] ) head = next[head];
+    if( next[head] < 0 ) continue;
+    _dzSysFuseSSInit( &fss, 1 );
+    for( j=head; ; j=next[j] ){
+      if( !_dzSysFuseSSSeries( &fss, &ss[j], &tmp ) ) goto FAILURE;
+      _dzSysFuseSSFree( &fss );
+      fss = tmp;
+      if( next[j] < 0 ) break;
+      pos[j] = -1; /* removed from the plan */
+    }
+    if( !_dzSysFusedReplace( fuse, zArrayElemNC(arr,j), dzSysInputElem(zArrayElemNC(arr,head),0), &fss ) )
+      goto FAILURE;
+    _dzSysFuseSSFree( &fss );
+    chainnum++;
+  }
+  for( i=k=0; k<fuse->num; k++ )
+    if( pos[fuse->sys[k]-zArrayBuf(arr)] >= 0 ){
+      plan->sys[i] = fuse->sys[k];
+      plan->update[i++] = fuse->sys[k]->com->_update;
+    }
+  plan->num = i;
+  plan->gen++;
+  goto TERMINATE;
+
+ FAILURE:
+  _dzSysFuseSSFree( &fss );
+  dzSysPlanUnfuse( plan );
+  chainnum = -1;
+ TERMINATE:
+  if( ss )
+    for( i=0; i<zArraySize(arr); i++ ) _dzSysFuseSSFree( &ss[i] );
+  zFree( ss );
+  zFree( pos );
+  zFree( next );
+  zFree( cnt );
+  zFree( lin );
+  zFree( linked );
+  return chainnum;
+}
+
+/* restore systems replaced by fused models. */
+void dzSysPlanUnfuse(dzSysPlan *plan)
+{
+  _dzSysFuse *fuse;
+  int i;
+
+  if( !( fuse = (_dzSysFuse *)plan->fuse ) ) return;
+  _dzSysFuseResetRate( plan );
+  for( i=fuse->fusednum-1; i>=0; i-- )
+    _dzSysFusedRestore( &fuse->fused[i] );
+  memcpy( plan->sys, fuse->sys, sizeof(dzSys*)*fuse->num );
+  memcpy( plan->update, fuse->update, sizeof(dzSysUpdateMethod)*fuse->num );
+  plan->num = fuse->num;
+  plan->gen++;
+  zFree( fuse->sys );
+  zFree( fuse->update );
+  zFree( fuse->fused );
+  zFree( fuse );
+  plan->fuse = NULL;
+}
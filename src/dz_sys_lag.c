@@ -63,6 +63,15 @@ static void _dzSysFOLFPrintZTK(FILE *fp, dzSys *sys)
   _ZTKPrpKeyFPrint( fp, sys, __ztk_prp_dzsys_fol );
 }
 
+static bool _dzSysFOLTF(dzSys *sys, dzTF *tf)
+{
+  if( !dzTFAlloc( tf, 0, 1 ) ) return false;
+  dzTFSetNumElem( tf, 0, __dz_sys_fol_gain(sys) );
+  dzTFSetDenElem( tf, 0, 1 );
+  dzTFSetDenElem( tf, 1, __dz_sys_fol_tc(sys) );
+  return true;
+}
+
 dzSysCom dz_sys_fol_com = {
   .typestr = "FOL",
   ._destroy = dzSysDefaultDestroy,
@@ -70,6 +79,8 @@ dzSysCom dz_sys_fol_com = {
   ._update = _dzSysFOLUpdate,
   ._fromZTK = _dzSysFOLFromZTK,
   ._fprintZTK = _dzSysFOLFPrintZTK,
+  ._prpnum = 2,
+  ._tf = _dzSysFOLTF,
 };
 
 /* create a first-order-lag system. */
@@ -184,6 +195,17 @@ static void _dzSysSOLFPrintZTK(FILE *fp, dzSys *sys)
   _ZTKPrpKeyFPrint( fp, sys, __ztk_prp_dzsys_sol );
 }
 
+static bool _dzSysSOLTF(dzSys *sys, dzTF *tf)
+{
+  if( !dzTFAlloc( tf, 1, 2 ) ) return false;
+  dzTFSetNumElem( tf, 0, __dz_sys_sol_gain(sys) );
+  dzTFSetNumElem( tf, 1, __dz_sys_sol_gain(sys) * __dz_sys_sol_t2(sys) );
+  dzTFSetDenElem( tf, 0, 1 );
+  dzTFSetDenElem( tf, 1, 2 * __dz_sys_sol_damp(sys) * __dz_sys_sol_t1(sys) );
+  dzTFSetDenElem( tf, 2, zSqr( __dz_sys_sol_t1(sys) ) );
+  return true;
+}
+
 dzSysCom dz_sys_sol_com = {
   .typestr = "SOL",
   ._destroy = dzSysDefaultDestroy,
@@ -191,6 +213,8 @@ dzSysCom dz_sys_sol_com = {
   ._update = _dzSysSOLUpdate,
   ._fromZTK = _dzSysSOLFromZTK,
   ._fprintZTK = _dzSysSOLFPrintZTK,
+  ._prpnum = 7,
+  ._tf = _dzSysSOLTF,
 };
 
 /* create a second-order-lag system in standard form. */
@@ -287,6 +311,16 @@ static void _dzSysPCFPrintZTK(FILE *fp, dzSys *sys)
   _ZTKPrpKeyFPrint( fp, sys, __ztk_prp_dzsys_pc );
 }
 
+static bool _dzSysPCTF(dzSys *sys, dzTF *tf)
+{
+  if( !dzTFAlloc( tf, 1, 1 ) ) return false;
+  dzTFSetNumElem( tf, 0, __dz_sys_pc_gain(sys) );
+  dzTFSetNumElem( tf, 1, __dz_sys_pc_gain(sys) * __dz_sys_pc_t2(sys) );
+  dzTFSetDenElem( tf, 0, 1 );
+  dzTFSetDenElem( tf, 1, __dz_sys_pc_t1(sys) );
+  return true;
+}
+
 dzSysCom dz_sys_pc_com = {
   .typestr = "phasecomp",
   ._destroy = dzSysDefaultDestroy,
@@ -294,6 +328,8 @@ dzSysCom dz_sys_pc_com = {
   ._update = _dzSysPCUpdate,
   ._fromZTK = _dzSysPCFromZTK,
   ._fprintZTK = _dzSysPCFPrintZTK,
+  ._prpnum = 4,
+  ._tf = _dzSysPCTF,
 };
 
 /* create a phase compensator. */
@@ -385,6 +421,7 @@ dzSysCom dz_sys_adapt_com = {
   ._update = _dzSysAdaptUpdate,
   ._fromZTK = _dzSysAdaptFromZTK,
   ._fprintZTK = _dzSysAdaptFPrintZTK,
+  ._prpnum = 3,
 };
 
 /* create an adaptive system. */
@@ -0,0 +1,265 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_lane - lane-parallel simulation of systems
+ */
+
+#include <dzco/dz_sys.h>
+
+/* ********************************************************** */
+/* lanes of a system which cannot be batched
+ * ********************************************************** */
+
+typedef struct{
+  int width;
+  dzSys *lane; /* clones of the original system */
+} _dzSysLanes;
+
+#define __dz_sys_lanes(s) ( (_dzSysLanes *)(s)->prp )
+
+static void _dzSysLanesDestroy(dzSys *sys)
+{
+  _dzSysLanes *lanes;
+  int l;
+
+  if( ( lanes = __dz_sys_lanes(sys) ) && lanes->lane ){
+    for( l=0; l<lanes->width; l++ )
+      if( lanes->lane[l].com ) dzSysDestroy( &lanes->lane[l] );
+    zFree( lanes->lane );
+  }
+  dzSysDefaultDestroy( sys );
+}
+
+static void _dzSysLanesRefresh(dzSys *sys)
+{
+  _dzSysLanes *lanes;
+  int l;
+
+  lanes = __dz_sys_lanes(sys);
+  for( l=0; l<lanes->width; l++ )
+    dzSysRefresh( &lanes->lane[l] );
+  zVecZero( dzSysOutput(sys) );
+}
+
+/* each lane reads its inputs through the ports of the lanes. */
+static zVec _dzSysLanesUpdate(dzSys *sys, double dt)
+{
+  _dzSysLanes *lanes;
+  dzSys *lane;
+  int l, i;
+
+  lanes = __dz_sys_lanes(sys);
+  for( l=0; l<lanes->width; l++ ){
+    lane = &lanes->lane[l];
+    for( i=0; i<dzSysInputNum(lane); i++ )
+      *zArrayElemNC(dzSysInput(lane),i) = *zArrayElemNC(dzSysInput(sys),i*lanes->width+l);
+    dzSysUpdate( lane, dt );
+    for( i=0; i<dzSysOutputNum(lane); i++ )
+      dzSysOutputVal(sys,i*lanes->width+l) = dzSysOutputVal(lane,i);
+  }
+  return dzSysOutput(sys);
+}
+
+static bool _dzSysLanesFeedthrough(dzSys *sys)
+{
+  return dzSysIsDirect( &__dz_sys_lanes(sys)->lane[0] );
+}
+
+static void _dzSysLanesFPrintZTK(FILE *fp, dzSys *sys)
+{
+  ZRUNERROR( DZ_ERR_SYS_LANE_NOTSERIALIZABLE );
+}
+
+static dzSys *_dzSysLanesAlloc(dzSys *sys, dzSys *src, int width)
+{
+  _dzSysLanes *lanes;
+
+  dzSysInit( sys );
+  sys->com = &dz_sys_lanes_com;
+  dzSysAllocInput( sys, dzSysInputNum(src)*width );
+  if( dzSysInputNum(sys) != dzSysInputNum(src)*width ||
+      !dzSysAllocOutput( sys, dzSysOutputNum(src)*width ) ||
+      !( sys->prp = ( lanes = zAlloc( _dzSysLanes, 1 ) ) ) ||
+      !( lanes->lane = zAlloc( dzSys, width ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  lanes->width = width;
+  return sys;
+}
+
+static dzSys *_dzSysLanesClone(dzSys *src, dzSys *dest)
+{
+  _dzSysLanes *org;
+  int l;
+
+  org = __dz_sys_lanes(src);
+  if( !_dzSysLanesAlloc( dest, &org->lane[0], org->width ) ) return NULL;
+  for( l=0; l<org->width; l++ )
+    if( !dzSysClone( &org->lane[l], &__dz_sys_lanes(dest)->lane[l] ) ) return NULL;
+  return dest;
+}
+
+static int _dzSysLanesSnapshot(dzSys *sys, double *buf)
+{
+  _dzSysLanes *lanes;
+  int l, n, size = 0;
+
+  lanes = __dz_sys_lanes(sys);
+  for( l=0; l<lanes->width; l++ ){
+    if( ( n = dzSysSnapshotSize( &lanes->lane[l] ) ) < 0 ) return -1;
+    if( buf ) dzSysSnapshot( &lanes->lane[l], buf + size );
+    size += n;
+  }
+  return size;
+}
+
+static void _dzSysLanesRestore(dzSys *sys, const double *buf)
+{
+  _dzSysLanes *lanes;
+  int l;
+
+  lanes = __dz_sys_lanes(sys);
+  for( l=0; l<lanes->width; l++ )
+    buf = dzSysRestore( &lanes->lane[l], buf );
+}
+
+dzSysCom dz_sys_lanes_com = {
+  .typestr = "lanes",
+  ._destroy = _dzSysLanesDestroy,
+  ._refresh = _dzSysLanesRefresh,
+  ._update = _dzSysLanesUpdate,
+  ._fromZTK = NULL,
+  ._fprintZTK = _dzSysLanesFPrintZTK,
+  ._feedthrough = _dzSysLanesFeedthrough,
+  ._clone = _dzSysLanesClone,
+  ._snapshot = _dzSysLanesSnapshot,
+  ._restore = _dzSysLanesRestore,
+};
+
+/* copy outputs of a system to a lane. */
+static void _dzSysLaneCopyOutput(dzSys *sys, int width, int l, dzSys *src)
+{
+  int i;
+
+  for( i=0; i<dzSysOutputNum(src); i++ )
+    dzSysOutputVal(sys,i*width+l) = dzSysOutputVal(src,i);
+}
+
+/* create lanes of a system. */
+dzSys *dzSysLaneCreate(dzSys *sys, dzSys *src, int width)
+{
+  dzSysBatchKind kind;
+  int l;
+
+  if( width <= 0 ){
+    ZRUNERROR( DZ_ERR_SYS_LANE_INVALIDWIDTH, width );
+    return NULL;
+  }
+  if( ( kind = dzSysBatchKindFind( src->com ) ) != DZ_SYS_BATCH_INVALID ){
+    if( !dzSysBatchCreate( sys, kind, width ) ) goto FAILURE;
+    for( l=0; l<width; l++ )
+      dzSysBatchLoad( sys, l, src );
+  } else{
+    if( !_dzSysLanesAlloc( sys, src, width ) ) goto FAILURE;
+    for( l=0; l<width; l++ )
+      if( !dzSysClone( src, &__dz_sys_lanes(sys)->lane[l] ) ) goto FAILURE;
+    for( l=0; l<width; l++ )
+      _dzSysLaneCopyOutput( sys, width, l, src );
+  }
+  if( zNamePtr(src) && !zNameSet( sys, zName(src) ) ){
+    ZALLOCERROR();
+    goto FAILURE;
+  }
+  sys->period = src->period;
+  sys->persistent = src->persistent;
+  return sys;
+
+ FAILURE:
+  if( sys->com ) dzSysDestroy( sys );
+  return NULL;
+}
+
+/* load a system to a lane. */
+bool dzSysLaneLoad(dzSys *sys, int l, dzSys *src)
+{
+  _dzSysLanes *lanes;
+  dzSys lane;
+
+  if( sys->com == &dz_sys_batch_com ){
+    if( l < 0 || l >= dzSysBatchNum(sys) ){
+      ZRUNERROR( DZ_ERR_SYS_LANE_OUTOFRANGE, l );
+      return false;
+    }
+    return dzSysBatchLoad( sys, l, src );
+  }
+  lanes = __dz_sys_lanes(sys);
+  if( sys->com != &dz_sys_lanes_com || src->com != lanes->lane[0].com ){
+    ZRUNERROR( DZ_ERR_SYS_LANE_UNMATCHTYPE, src->com->typestr );
+    return false;
+  }
+  if( l < 0 || l >= lanes->width ){
+    ZRUNERROR( DZ_ERR_SYS_LANE_OUTOFRANGE, l );
+    return false;
+  }
+  if( !dzSysClone( src, &lane ) ) return false;
+  dzSysDestroy( &lanes->lane[l] );
+  lanes->lane[l] = lane;
+  _dzSysLaneCopyOutput( sys, lanes->width, l, src );
+  return true;
+}
+
+/* ********************************************************** */
+/* lanes of an array of systems
+ * ********************************************************** */
+
+/* destroy systems of an array created so far. */
+static void _dzSysArrayLaneAbort(dzSysArray *arr, int n)
+{
+  int i;
+
+  for( i=0; i<n; i++ )
+    dzSysDestroy( zArrayElemNC(arr,i) );
+  zArrayFree( arr );
+}
+
+/* connect lanes of an array lane by lane. */
+static bool _dzSysArrayLaneConnect(dzSysArray *src, dzSysArray *dest, int width)
+{
+  dzSys *sys;
+  dzSysPort *port;
+  int i, j, k, l;
+
+  for( i=0; i<zArraySize(src); i++ ){
+    sys = zArrayElemNC(dest,i);
+    for( j=0; j<dzSysInputNum(zArrayElemNC(src,i)); j++ ){
+      port = zArrayElemNC(dzSysInput(zArrayElemNC(src,i)),j);
+      k = port->sp ? port->sp - zArrayElemNC(src,0) : -1;
+      for( l=0; l<width; l++ ){
+        if( k < 0 || k >= zArraySize(src) ) /* shared by all lanes */
+          *zArrayElemNC(dzSysInput(sys),j*width+l) = *port;
+        else
+        if( !dzSysConnect( zArrayElemNC(dest,k), port->port*width+l, sys, j*width+l ) ) return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* create lanes of an array of systems. */
+dzSysArray *dzSysArrayLane(dzSysArray *src, dzSysArray *dest, int width)
+{
+  int i;
+
+  if( !dzSysArrayAlloc( dest, zArraySize(src) ) ) return NULL;
+  for( i=0; i<zArraySize(src); i++ )
+    if( !dzSysLaneCreate( zArrayElemNC(dest,i), zArrayElemNC(src,i), width ) ){
+      _dzSysArrayLaneAbort( dest, i );
+      return NULL;
+    }
+  if( !_dzSysArrayLaneConnect( src, dest, width ) ){
+    _dzSysArrayLaneAbort( dest, zArraySize(dest) );
+    return NULL;
+  }
+  return dest;
+}
@@ -42,6 +42,100 @@ static dzSys *_dzSysLinFromZTK(dzSys *sys, ZTK *ztk)
   return dzSysLinCreate( sys, lin );
 }
 
+static bool _dzSysLinEncode(dzSys *sys, dzSysBin *bin)
+{
+  dzLin *lin;
+
+  lin = dzSysLin(sys);
+  return dzSysBinWriteInt( bin, dzLinDim(lin) ) &&
+         dzSysBinWriteMat( bin, lin->a ) &&
+         dzSysBinWriteVec( bin, lin->b ) &&
+         dzSysBinWriteVec( bin, lin->c ) &&
+         dzSysBinWriteDouble( bin, lin->d ) &&
+         dzSysBinWriteInt( bin, dzLinIsZOH(lin) ? 1 : 0 ) &&
+         dzSysBinWriteVec( bin, lin->x );
+}
+
+static dzSys *_dzSysLinDecode(dzSys *sys, dzSysBin *bin)
+{
+  dzLin *lin;
+  int dim, zoh;
+
+  if( !dzSysBinReadInt( bin, &dim ) ) return NULL;
+  if( !( lin = zAlloc( dzLin, 1 ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  if( !dzLinAlloc( lin, dim ) ){
+    zFree( lin );
+    return NULL;
+  }
+  if( !dzSysBinReadMat( bin, lin->a ) ||
+      !dzSysBinReadVec( bin, lin->b ) ||
+      !dzSysBinReadVec( bin, lin->c ) ||
+      !dzSysBinReadDouble( bin, &lin->d ) ||
+      !dzSysBinReadInt( bin, &zoh ) ||
+      ( zoh && !dzLinSetZOH( lin ) ) ||
+      !dzSysLinCreate( sys, lin ) ){
+    dzLinDestroy( lin );
+    zFree( lin );
+    return NULL;
+  }
+  if( !dzSysBinReadVec( bin, lin->x ) ){
+    dzSysDestroy( sys );
+    return NULL;
+  }
+  return sys;
+}
+
+static dzSys *_dzSysLinClone(dzSys *src, dzSys *dest)
+{
+  dzLin *org, *lin;
+
+  org = dzSysLin(src);
+  if( !( lin = zAlloc( dzLin, 1 ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  if( !dzLinAlloc( lin, dzLinDim(org) ) ){
+    zFree( lin );
+    return NULL;
+  }
+  zMatCopyNC( org->a, lin->a );
+  zVecCopyNC( org->b, lin->b );
+  zVecCopyNC( org->c, lin->c );
+  lin->d = org->d;
+  if( dzLinIsZOH(org) ){
+    if( !dzLinSetZOH( lin ) ) goto FAILURE;
+    /* the discretization is copied to be reused */
+    zMatCopyNC( org->_phi, lin->_phi );
+    zMatCopyNC( org->_psi, lin->_psi );
+    zVecCopyNC( org->_gamma, lin->_gamma );
+    zMatCopyNC( org->_a, lin->_a );
+    zVecCopyNC( org->_b, lin->_b );
+    lin->_dt = org->_dt;
+  }
+  if( !dzSysLinCreate( dest, lin ) ) goto FAILURE;
+  zVecCopyNC( org->x, lin->x );
+  return dest;
+
+ FAILURE:
+  dzLinDestroy( lin );
+  zFree( lin );
+  return NULL;
+}
+
+static int _dzSysLinSnapshot(dzSys *sys, double *buf)
+{
+  if( buf ) memcpy( buf, zVecBufNC(dzSysLin(sys)->x), sizeof(double)*dzLinDim(dzSysLin(sys)) );
+  return dzLinDim(dzSysLin(sys));
+}
+
+static void _dzSysLinRestore(dzSys *sys, const double *buf)
+{
+  memcpy( zVecBufNC(dzSysLin(sys)->x), buf, sizeof(double)*dzLinDim(dzSysLin(sys)) );
+}
+
 dzSysCom dz_sys_lin_com = {
   .typestr = "lin",
   ._destroy = _dzSysLinDestroy,
@@ -49,6 +143,11 @@ dzSysCom dz_sys_lin_com = {
   ._update = _dzSysLinUpdate,
   ._fromZTK = _dzSysLinFromZTK,
   ._fprintZTK = _dzSysLinFPrintZTK,
+  ._encode = _dzSysLinEncode,
+  ._decode = _dzSysLinDecode,
+  ._clone = _dzSysLinClone,
+  ._snapshot = _dzSysLinSnapshot,
+  ._restore = _dzSysLinRestore,
 };
 
 /* create a linear system. */
@@ -65,3 +164,184 @@ dzSys *dzSysLinCreate(dzSys *sys, dzLin *lin)
   dzSysRefresh( sys );
   return sys;
 }
+
+/* ********************************************************** */
+/* multi-input multi-output linear system
+ * ********************************************************** */
+
+static void _dzSysLinMIMODestroy(dzSys *sys)
+{
+  if( sys->prp ) dzLinMIMODestroy( dzSysLinMIMO(sys) );
+  dzSysDefaultDestroy( sys );
+}
+
+static void _dzSysLinMIMORefresh(dzSys *sys)
+{
+  zVecZero( dzSysLinMIMO(sys)->x );
+}
+
+static zVec _dzSysLinMIMOUpdate(dzSys *sys, double dt)
+{
+  dzLinMIMO *lin;
+  int i;
+
+  lin = dzSysLinMIMO(sys);
+  for( i=0; i<dzSysInputNum(sys); i++ )
+    zVecSetElemNC( lin->_u, i, dzSysInputVal(sys,i) );
+  /* the output is from the previous state, so that it depends on the
+   * current input only through the feedthrough term. */
+  dzLinMIMOOutput( lin, lin->_u, dzSysOutput(sys) );
+  dzLinMIMOStateUpdate( lin, lin->_u, dt );
+  return dzSysOutput(sys);
+}
+
+static bool _dzSysLinMIMOFeedthrough(dzSys *sys)
+{
+  return !zMatIsTiny( dzSysLinMIMO(sys)->d );
+}
+
+static void _dzSysLinMIMOFPrintZTK(FILE *fp, dzSys *sys)
+{
+  dzLinMIMOFPrintZTK( fp, dzSysLinMIMO(sys) );
+}
+
+static dzSys *_dzSysLinMIMOFromZTK(dzSys *sys, ZTK *ztk)
+{
+  dzLinMIMO *lin;
+
+  if( !( lin = zAlloc( dzLinMIMO, 1 ) ) ) return NULL;
+  if( !dzLinMIMOFromZTK( lin, ztk ) ){
+    zFree( lin );
+    return NULL;
+  }
+  return dzSysLinMIMOCreate( sys, lin );
+}
+
+static bool _dzSysLinMIMOEncode(dzSys *sys, dzSysBin *bin)
+{
+  dzLinMIMO *lin;
+
+  lin = dzSysLinMIMO(sys);
+  return dzSysBinWriteInt( bin, dzLinMIMODim(lin) ) &&
+         dzSysBinWriteInt( bin, dzLinMIMOInputSize(lin) ) &&
+         dzSysBinWriteInt( bin, dzLinMIMOOutputSize(lin) ) &&
+         dzSysBinWriteMat( bin, lin->a ) &&
+         dzSysBinWriteMat( bin, lin->b ) &&
+         dzSysBinWriteMat( bin, lin->c ) &&
+         dzSysBinWriteMat( bin, lin->d ) &&
+         dzSysBinWriteInt( bin, dzLinMIMOIsZOH(lin) ? 1 : 0 ) &&
+         dzSysBinWriteVec( bin, lin->x );
+}
+
+static dzSys *_dzSysLinMIMODecode(dzSys *sys, dzSysBin *bin)
+{
+  dzLinMIMO *lin;
+  int dim, m, p, zoh;
+
+  if( !dzSysBinReadInt( bin, &dim ) ||
+      !dzSysBinReadInt( bin, &m ) ||
+      !dzSysBinReadInt( bin, &p ) ) return NULL;
+  if( !( lin = zAlloc( dzLinMIMO, 1 ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  if( !dzLinMIMOAlloc( lin, dim, m, p ) ){
+    zFree( lin );
+    return NULL;
+  }
+  if( !dzSysBinReadMat( bin, lin->a ) ||
+      !dzSysBinReadMat( bin, lin->b ) ||
+      !dzSysBinReadMat( bin, lin->c ) ||
+      !dzSysBinReadMat( bin, lin->d ) ||
+      !dzSysBinReadInt( bin, &zoh ) ||
+      ( zoh && !dzLinMIMOSetZOH( lin ) ) ||
+      !dzSysLinMIMOCreate( sys, lin ) ){
+    dzLinMIMODestroy( lin );
+    zFree( lin );
+    return NULL;
+  }
+  if( !dzSysBinReadVec( bin, lin->x ) ){
+    dzSysDestroy( sys );
+    return NULL;
+  }
+  return sys;
+}
+
+static dzSys *_dzSysLinMIMOClone(dzSys *src, dzSys *dest)
+{
+  dzLinMIMO *org, *lin;
+
+  org = dzSysLinMIMO(src);
+  if( !( lin = zAlloc( dzLinMIMO, 1 ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  if( !dzLinMIMOAlloc( lin, dzLinMIMODim(org), dzLinMIMOInputSize(org), dzLinMIMOOutputSize(org) ) ){
+    zFree( lin );
+    return NULL;
+  }
+  zMatCopyNC( org->a, lin->a );
+  zMatCopyNC( org->b, lin->b );
+  zMatCopyNC( org->c, lin->c );
+  zMatCopyNC( org->d, lin->d );
+  if( dzLinMIMOIsZOH(org) ){
+    if( !dzLinMIMOSetZOH( lin ) ) goto FAILURE;
+    /* the discretization is copied to be reused */
+    zMatCopyNC( org->_phi, lin->_phi );
+    zMatCopyNC( org->_psi, lin->_psi );
+    zMatCopyNC( org->_gamma, lin->_gamma );
+    zMatCopyNC( org->_a, lin->_a );
+    zMatCopyNC( org->_b, lin->_b );
+    lin->_dt = org->_dt;
+  }
+  if( !dzSysLinMIMOCreate( dest, lin ) ) goto FAILURE;
+  zVecCopyNC( org->x, lin->x );
+  return dest;
+
+ FAILURE:
+  dzLinMIMODestroy( lin );
+  zFree( lin );
+  return NULL;
+}
+
+static int _dzSysLinMIMOSnapshot(dzSys *sys, double *buf)
+{
+  if( buf ) memcpy( buf, zVecBufNC(dzSysLinMIMO(sys)->x), sizeof(double)*dzLinMIMODim(dzSysLinMIMO(sys)) );
+  return dzLinMIMODim(dzSysLinMIMO(sys));
+}
+
+static void _dzSysLinMIMORestore(dzSys *sys, const double *buf)
+{
+  memcpy( zVecBufNC(dzSysLinMIMO(sys)->x), buf, sizeof(double)*dzLinMIMODim(dzSysLinMIMO(sys)) );
+}
+
+dzSysCom dz_sys_linmimo_com = {
+  .typestr = "linmimo",
+  ._destroy = _dzSysLinMIMODestroy,
+  ._refresh = _dzSysLinMIMORefresh,
+  ._update = _dzSysLinMIMOUpdate,
+  ._fromZTK = _dzSysLinMIMOFromZTK,
+  ._fprintZTK = _dzSysLinMIMOFPrintZTK,
+  ._feedthrough = _dzSysLinMIMOFeedthrough,
+  ._encode = _dzSysLinMIMOEncode,
+  ._decode = _dzSysLinMIMODecode,
+  ._clone = _dzSysLinMIMOClone,
+  ._snapshot = _dzSysLinMIMOSnapshot,
+  ._restore = _dzSysLinMIMORestore,
+};
+
+/* create a multi-input multi-output linear system. */
+dzSys *dzSysLinMIMOCreate(dzSys *sys, dzLinMIMO *lin)
+{
+  dzSysInit( sys );
+  dzSysAllocInput( sys, dzLinMIMOInputSize(lin) );
+  if( dzSysInputNum(sys) != dzLinMIMOInputSize(lin) ||
+      !dzSysAllocOutput( sys, dzLinMIMOOutputSize(lin) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  sys->prp = lin;
+  sys->com = &dz_sys_linmimo_com;
+  dzSysRefresh( sys );
+  return sys;
+}
@@ -25,6 +25,15 @@ static void _dzSysMIFPrintZTK(FILE *fp, dzSys *sys)
   _ZTKPrpKeyFPrint( fp, sys, __ztk_prp_dzsys_mi );
 }
 
+/* an adder or a subtractor with a single input is linear. */
+static bool _dzSysMITF(dzSys *sys, dzTF *tf)
+{
+  if( dzSysInputNum(sys) != 1 || !dzTFAlloc( tf, 0, 0 ) ) return false;
+  dzTFSetNumElem( tf, 0, 1 );
+  dzTFSetDenElem( tf, 0, 1 );
+  return true;
+}
+
 /* ********************************************************** */
 /* adder
  * ********************************************************** */
@@ -53,6 +62,7 @@ dzSysCom dz_sys_adder_com = {
   ._update = _dzSysAdderUpdate,
   ._fromZTK = _dzSysAdderFromZTK,
   ._fprintZTK = _dzSysMIFPrintZTK,
+  ._tf = _dzSysMITF,
 };
 
 /* create an adder. */
@@ -92,6 +102,7 @@ dzSysCom dz_sys_subtr_com = {
   ._update = _dzSysSubtrUpdate,
   ._fromZTK = _dzSysSubtrFromZTK,
   ._fprintZTK = _dzSysMIFPrintZTK,
+  ._tf = _dzSysMITF,
 };
 
 /* create a subtractor. */
@@ -159,6 +170,7 @@ dzSysCom dz_sys_limit_com = {
   ._update = _dzSysLimitUpdate,
   ._fromZTK = _dzSysLimitFromZTK,
   ._fprintZTK = _dzSysLimitFPrintZTK,
+  ._prpnum = 2,
 };
 
 /* create a saturater. */
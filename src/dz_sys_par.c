@@ -0,0 +1,343 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_par - level-parallel execution of an array of systems
+ */
+
+#define _POSIX_C_SOURCE 200112L /* for POSIX threads and sysconf() */
+
+#include <dzco/dz_sys.h>
+#include <unistd.h>
+
+#if defined(_POSIX_THREADS) && _POSIX_THREADS > 0
+#define __DZ_SYS_PAR_THREAD
+#include <pthread.h>
+#endif
+
+/* number of systems updated by a thread at once */
+#define DZ_SYS_PAR_CHUNK 32
+
+/* ********************************************************** */
+/* levels of an execution plan
+ * ********************************************************** */
+
+/* index of a producer of an input of a system in the order of a plan,
+ * or -1 if it is out of the array or not scheduled. */
+static int _dzSysParProducer(dzSysPlan *plan, int *pos, dzSys *sys, int i)
+{
+  dzSys *sp;
+
+  sp = zArrayElemNC(dzSysInput(sys),i)->sp;
+  if( !sp || sp < zArrayBuf(plan->arr) || sp >= zArrayBuf(plan->arr) + zArraySize(plan->arr) ) return -1;
+  return pos[sp-zArrayBuf(plan->arr)];
+}
+
+/* level of each system in the order of a plan. A system is above
+ * the producers updated before it, and below the producers updated
+ * after it, which have to be read before their updates. */
+static bool _dzSysParLevel(dzSysPlan *plan, int *level, int *levelnum)
+{
+  int *pos, i, k, p;
+
+  if( !( pos = zAlloc( int, zMax(zArraySize(plan->arr),1) ) ) ){
+    ZALLOCERROR();
+    return false;
+  }
+  for( i=0; i<zArraySize(plan->arr); i++ )
+    pos[i] = -1; /* not scheduled, e.g. fused */
+  for( k=0; k<plan->num; k++ ){
+    pos[plan->sys[k]-zArrayBuf(plan->arr)] = k;
+    level[k] = 0;
+  }
+  *levelnum = 0;
+  for( k=0; k<plan->num; k++ ){
+    for( i=0; i<dzSysInputNum(plan->sys[k]); i++ )
+      if( ( p = _dzSysParProducer( plan, pos, plan->sys[k], i ) ) >= 0 && p < k &&
+          level[p] >= level[k] ) level[k] = level[p] + 1;
+    for( i=0; i<dzSysInputNum(plan->sys[k]); i++ )
+      if( ( p = _dzSysParProducer( plan, pos, plan->sys[k], i ) ) > k &&
+          level[p] <= level[k] ) level[p] = level[k] + 1;
+    if( level[k] >= *levelnum ) *levelnum = level[k] + 1;
+  }
+  zFree( pos );
+  return true;
+}
+
+/* sort systems of a plan by level, keeping the order in each level. */
+static bool _dzSysParSort(dzSysPar *par)
+{
+  int *level, *cur, k;
+  bool ret = false;
+
+  cur = NULL;
+  if( !( level = zAlloc( int, zMax(par->plan->num,1) ) ) ){
+    ZALLOCERROR();
+    return false;
+  }
+  if( !_dzSysParLevel( par->plan, level, &par->levelnum ) ) goto TERMINATE;
+  par->head = zAlloc( int, par->levelnum+1 );
+  cur = zAlloc( int, zMax(par->levelnum,1) );
+  par->sys = zAlloc( dzSys*, zMax(par->plan->num,1) );
+  par->update = zAlloc( dzSysUpdateMethod, zMax(par->plan->num,1) );
+  if( !par->head || !cur || !par->sys || !par->update ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  for( k=0; k<par->plan->num; k++ )
+    par->head[level[k]+1]++;
+  for( k=0; k<par->levelnum; k++ ){
+    par->head[k+1] += par->head[k];
+    cur[k] = par->head[k];
+  }
+  for( k=0; k<par->plan->num; k++ ){
+    par->sys[cur[level[k]]] = par->plan->sys[k];
+    par->update[cur[level[k]]++] = par->plan->update[k];
+  }
+  par->num = par->plan->num;
+  par->gen = par->plan->gen;
+  ret = true;
+ TERMINATE:
+  zFree( level );
+  zFree( cur );
+  return ret;
+}
+
+/* make levels again for a modified plan. */
+static bool _dzSysParResort(dzSysPar *par)
+{
+  zFree( par->head );
+  zFree( par->sys );
+  zFree( par->update );
+  par->levelnum = 0;
+  return _dzSysParSort( par );
+}
+
+/* ********************************************************** */
+/* pool of worker threads
+ * ********************************************************** */
+
+typedef struct{
+  dzSysPar *par;
+  int level;   /* level being updated */
+  int next;    /* next system to be updated in the level */
+  double dt;
+#ifdef __DZ_SYS_PAR_THREAD
+  pthread_mutex_t mutex;
+  pthread_cond_t start; /* signaled when a level is dispatched */
+  pthread_cond_t done;  /* signaled when workers finish a level */
+  uint gen;    /* count of dispatched levels, which may wrap */
+  int busy;    /* number of workers updating systems */
+  bool quit;
+  int workernum;
+  pthread_t *worker;
+#endif
+} _dzSysParPool;
+
+/* update systems of the dispatched level until none is left. */
+static void _dzSysParRunLevel(_dzSysParPool *pool)
+{
+  dzSysPar *par;
+  double dt;
+  int i, end;
+
+  par = pool->par;
+  while( 1 ){
+#ifdef __DZ_SYS_PAR_THREAD
+    pthread_mutex_lock( &pool->mutex );
+#endif
+    i = pool->next;
+    end = par->head[pool->level+1];
+    pool->next += DZ_SYS_PAR_CHUNK;
+    dt = pool->dt;
+#ifdef __DZ_SYS_PAR_THREAD
+    pthread_mutex_unlock( &pool->mutex );
+#endif
+    if( i >= end ) break;
+    for( end=zMin(i+DZ_SYS_PAR_CHUNK,end); i<end; i++ )
+      par->update[i]( par->sys[i], dt );
+  }
+}
+
+#ifdef __DZ_SYS_PAR_THREAD
+/* worker thread waiting for levels to be dispatched. */
+static void *_dzSysParWorker(void *arg)
+{
+  _dzSysParPool *pool;
+  uint gen = 0;
+
+  pool = (_dzSysParPool *)arg;
+  pthread_mutex_lock( &pool->mutex );
+  while( 1 ){
+    while( pool->gen == gen && !pool->quit )
+      pthread_cond_wait( &pool->start, &pool->mutex );
+    if( pool->quit ) break;
+    gen = pool->gen;
+    pool->busy++;
+    pthread_mutex_unlock( &pool->mutex );
+    _dzSysParRunLevel( pool );
+    pthread_mutex_lock( &pool->mutex );
+    if( --pool->busy == 0 ) pthread_cond_signal( &pool->done );
+  }
+  pthread_mutex_unlock( &pool->mutex );
+  return NULL;
+}
+#endif
+
+/* number of online processors. */
+static int _dzSysParProcNum(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+  long n;
+
+  if( ( n = sysconf( _SC_NPROCESSORS_ONLN ) ) > 0 ) return (int)n;
+#endif
+  return 1;
+}
+
+/* start worker threads. */
+static bool _dzSysParPoolCreate(dzSysPar *par)
+{
+  _dzSysParPool *pool;
+
+  if( !( pool = zAlloc( _dzSysParPool, 1 ) ) ){
+    ZALLOCERROR();
+    return false;
+  }
+  pool->par = par;
+  pool->level = 0;
+  pool->next = 0;
+  pool->dt = 0;
+  par->pool = pool;
+#ifdef __DZ_SYS_PAR_THREAD
+  pthread_mutex_init( &pool->mutex, NULL );
+  pthread_cond_init( &pool->start, NULL );
+  pthread_cond_init( &pool->done, NULL );
+  pool->gen = pool->busy = 0;
+  pool->quit = false;
+  pool->workernum = 0;
+  if( par->threadnum > 1 && !( pool->worker = zAlloc( pthread_t, par->threadnum-1 ) ) ){
+    ZALLOCERROR();
+    par->threadnum = 1;
+  }
+  for( ; pool->workernum<par->threadnum-1; pool->workernum++ )
+    if( pthread_create( &pool->worker[pool->workernum], NULL, _dzSysParWorker, pool ) != 0 ) break;
+  par->threadnum = pool->workernum + 1;
+#else
+  par->threadnum = 1;
+#endif
+  return true;
+}
+
+/* stop worker threads. */
+static void _dzSysParPoolDestroy(dzSysPar *par)
+{
+  _dzSysParPool *pool;
+#ifdef __DZ_SYS_PAR_THREAD
+  int i;
+#endif
+
+  if( !( pool = (_dzSysParPool *)par->pool ) ) return;
+#ifdef __DZ_SYS_PAR_THREAD
+  pthread_mutex_lock( &pool->mutex );
+  pool->quit = true;
+  pthread_cond_broadcast( &pool->start );
+  pthread_mutex_unlock( &pool->mutex );
+  for( i=0; i<pool->workernum; i++ )
+    pthread_join( pool->worker[i], NULL );
+  zFree( pool->worker );
+  pthread_cond_destroy( &pool->start );
+  pthread_cond_destroy( &pool->done );
+  pthread_mutex_destroy( &pool->mutex );
+#endif
+  zFree( par->pool );
+}
+
+/* ********************************************************** */
+/* \class dzSysPar
+ * ********************************************************** */
+
+/* create a parallel executor. */
+dzSysPar *dzSysParCreate(dzSysPar *par, dzSysPlan *plan, int threadnum)
+{
+  par->plan = plan;
+  par->num = par->gen = 0;
+  par->levelnum = 0;
+  par->head = NULL;
+  par->sys = NULL;
+  par->update = NULL;
+  par->pool = NULL;
+  par->threadnum = threadnum > 0 ? threadnum : _dzSysParProcNum();
+  if( !_dzSysParSort( par ) || !_dzSysParPoolCreate( par ) ){
+    dzSysParDestroy( par );
+    return NULL;
+  }
+  return par;
+}
+
+/* destroy a parallel executor. */
+void dzSysParDestroy(dzSysPar *par)
+{
+  _dzSysParPoolDestroy( par );
+  zFree( par->head );
+  zFree( par->sys );
+  zFree( par->update );
+  par->levelnum = 0;
+  par->threadnum = 0;
+}
+
+/* update all systems level by level. */
+void dzSysParUpdate(dzSysPar *par, double dt)
+{
+#ifdef __DZ_SYS_PAR_THREAD
+  _dzSysParPool *pool;
+#endif
+  int l, i;
+
+  if( dzSysPlanIsMultirate(par->plan) || dzSysPlanIsLazy(par->plan) ){
+    dzSysPlanUpdate( par->plan, dt );
+    return;
+  }
+  if( ( par->num != par->plan->num || par->gen != par->plan->gen ) &&
+      !_dzSysParResort( par ) ){
+    dzSysPlanUpdate( par->plan, dt );
+    return;
+  }
+#ifdef __DZ_SYS_PAR_THREAD
+  pool = (_dzSysParPool *)par->pool;
+#endif
+  for( l=0; l<par->levelnum; l++ ){
+    if( par->threadnum <= 1 || dzSysParLevelSize(par,l) < 2*DZ_SYS_PAR_CHUNK ){
+      for( i=par->head[l]; i<par->head[l+1]; i++ )
+        par->update[i]( par->sys[i], dt );
+      continue;
+    }
+#ifdef __DZ_SYS_PAR_THREAD
+    pthread_mutex_lock( &pool->mutex );
+    pool->level = l;
+    pool->next = par->head[l];
+    pool->dt = dt;
+    pool->gen++;
+    pthread_cond_broadcast( &pool->start );
+    pthread_mutex_unlock( &pool->mutex );
+    _dzSysParRunLevel( pool ); /* the calling thread also works */
+    pthread_mutex_lock( &pool->mutex );
+    while( pool->busy > 0 )
+      pthread_cond_wait( &pool->done, &pool->mutex );
+    pthread_mutex_unlock( &pool->mutex );
+#endif
+  }
+}
+
+/* print levels of a parallel executor. */
+void dzSysParFPrint(FILE *fp, dzSysPar *par)
+{
+  int l, i;
+
+  for( l=0; l<par->levelnum; l++ ){
+    fprintf( fp, "level %d (%d):", l, dzSysParLevelSize(par,l) );
+    for( i=par->head[l]; i<par->head[l+1]; i++ )
+      fprintf( fp, " %s", zName(par->sys[i]) );
+    fprintf( fp, "\n" );
+  }
+  fprintf( fp, "(%d thread(s))\n", par->threadnum );
+}
@@ -44,6 +44,14 @@ static void _dzSysPFPrintZTK(FILE *fp, dzSys *sys)
   _ZTKPrpKeyFPrint( fp, sys, __ztk_prp_dzsys_p );
 }
 
+static bool _dzSysPTF(dzSys *sys, dzTF *tf)
+{
+  if( !dzTFAlloc( tf, 0, 0 ) ) return false;
+  dzTFSetNumElem( tf, 0, __dz_sys_p_gain(sys) );
+  dzTFSetDenElem( tf, 0, 1 );
+  return true;
+}
+
 dzSysCom dz_sys_p_com = {
   .typestr = "amplifier",
   ._destroy = dzSysDefaultDestroy,
@@ -51,6 +59,8 @@ dzSysCom dz_sys_p_com = {
   ._update = _dzSysPUpdate,
   ._fromZTK = _dzSysPFromZTK,
   ._fprintZTK = _dzSysPFPrintZTK,
+  ._prpnum = 1,
+  ._tf = _dzSysPTF,
 };
 
 /* create a proportional amplifier. */
@@ -134,6 +144,8 @@ dzSysCom dz_sys_i_com = {
   ._update = _dzSysIUpdate,
   ._fromZTK = _dzSysIFromZTK,
   ._fprintZTK = _dzSysIFPrintZTK,
+  ._feedthrough = dzSysNoFeedthrough,
+  ._prpnum = 3,
 };
 
 /* create an integrator. */
@@ -234,6 +246,7 @@ dzSysCom dz_sys_d_com = {
   ._update = _dzSysDUpdate,
   ._fromZTK = _dzSysDFromZTK,
   ._fprintZTK = _dzSysDFPrintZTK,
+  ._prpnum = 3,
 };
 
 /* create a differentiator. */
@@ -361,6 +374,7 @@ dzSysCom dz_sys_pid_com = {
   ._update = _dzSysPIDUpdate,
   ._fromZTK = _dzSysPIDFromZTK,
   ._fprintZTK = _dzSysPIDFPrintZTK,
+  ._prpnum = 7,
 };
 
 /* create a PID controller. */
@@ -501,6 +515,7 @@ dzSysCom dz_sys_qpd_com = {
   ._update = _dzSysQPDUpdate,
   ._fromZTK = _dzSysQPDFromZTK,
   ._fprintZTK = _dzSysQPDFPrintZTK,
+  ._prpnum = 8,
 };
 
 /* create a QPD controller. */
@@ -0,0 +1,530 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_plan - execution plan of an array of systems
+ */
+
+#include <dzco/dz_sys.h>
+
+/* ********************************************************** */
+/* connection graph of an array of systems
+ * ********************************************************** */
+
+typedef struct{
+  int num;    /* number of systems */
+  int *head;  /* head of consumers of each system (num+1) */
+  int *dst;   /* consumers */
+  int *indeg; /* number of input connections */
+} _dzSysGraph;
+
+static void _dzSysGraphDestroy(_dzSysGraph *graph)
+{
+  zFree( graph->head );
+  zFree( graph->dst );
+  zFree( graph->indeg );
+}
+
+/* index of a system in an array, or -1 if it is out of the array. */
+static int _dzSysArrayIndex(dzSysArray *arr, dzSys *sys)
+{
+  if( !sys || sys < zArrayBuf(arr) || sys >= zArrayBuf(arr) + zArraySize(arr) ) return -1;
+  return sys - zArrayBuf(arr);
+}
+
+/* create a connection graph of an array of systems. */
+static bool _dzSysGraphCreate(_dzSysGraph *graph, dzSysArray *arr)
+{
+  dzSys *sys;
+  int i, j, k, n = 0;
+
+  graph->num = zArraySize(arr);
+  graph->head = zAlloc( int, graph->num+1 );
+  graph->indeg = zAlloc( int, graph->num );
+  for( i=0; i<graph->num; i++ )
+    n += dzSysInputNum( zArrayElemNC(arr,i) );
+  graph->dst = zAlloc( int, n > 0 ? n : 1 );
+  if( !graph->head || !graph->indeg || !graph->dst ){
+    ZALLOCERROR();
+    _dzSysGraphDestroy( graph );
+    return false;
+  }
+  for( i=0; i<graph->num; i++ ){
+    sys = zArrayElemNC(arr,i);
+    for( k=0; k<dzSysInputNum(sys); k++ )
+      if( ( j = _dzSysArrayIndex( arr, dzSysInputElem(sys,k)->sp ) ) >= 0 )
+        graph->head[j+1]++;
+  }
+  for( i=0; i<graph->num; i++ )
+    graph->head[i+1] += graph->head[i];
+  for( i=0; i<graph->num; i++ ){ /* head[j] is temporarily used as a cursor */
+    sys = zArrayElemNC(arr,i);
+    for( k=0; k<dzSysInputNum(sys); k++ )
+      if( ( j = _dzSysArrayIndex( arr, dzSysInputElem(sys,k)->sp ) ) >= 0 ){
+        graph->dst[graph->head[j]++] = i;
+        graph->indeg[i]++;
+      }
+  }
+  for( i=graph->num; i>0; i-- )
+    graph->head[i] = graph->head[i-1];
+  graph->head[0] = 0;
+  return true;
+}
+
+/* ********************************************************** */
+/* \class dzSysPlan
+ * ********************************************************** */
+
+/* initialize an execution plan. */
+dzSysPlan *dzSysPlanInit(dzSysPlan *plan)
+{
+  plan->arr = NULL;
+  plan->num = 0;
+  plan->sys = NULL;
+  plan->update = NULL;
+  plan->loopnum = 0;
+  plan->gen = 0;
+  plan->dt = 0;
+  plan->div = plan->cnt = NULL;
+  plan->transition = DZ_SYS_RATE_HOLD;
+  plan->prev = plan->cur = NULL;
+  plan->fuse = NULL;
+  plan->lazy = false;
+  plan->tick = 0;
+  plan->stamp = NULL;
+  plan->pos = plan->stack = NULL;
+  return plan;
+}
+
+/* free buffers of interpolated outputs. */
+static void _dzSysPlanInterpFree(dzSysPlan *plan)
+{
+  int i;
+
+  if( plan->prev && plan->cur )
+    for( i=0; i<plan->num; i++ ){
+      zVecFree( plan->prev[i] );
+      zVecFree( plan->cur[i] );
+    }
+  zFree( plan->prev );
+  zFree( plan->cur );
+}
+
+/* destroy an execution plan. */
+void dzSysPlanDestroy(dzSysPlan *plan)
+{
+  dzSysPlanUnfuse( plan );
+  _dzSysPlanInterpFree( plan );
+  zFree( plan->sys );
+  zFree( plan->update );
+  zFree( plan->div );
+  zFree( plan->cnt );
+  zFree( plan->stamp );
+  zFree( plan->pos );
+  zFree( plan->stack );
+  dzSysPlanInit( plan );
+}
+
+/* schedule a system and release its consumers. */
+static void _dzSysPlanPush(dzSysPlan *plan, _dzSysGraph *graph, int i, bool *done, int *queue, int *tail)
+{
+  int j;
+
+  done[i] = true;
+  plan->sys[plan->num++] = zArrayElemNC(plan->arr,i);
+  for( j=graph->head[i]; j<graph->head[i+1]; j++ )
+    if( --graph->indeg[graph->dst[j]] == 0 && !done[graph->dst[j]] )
+      queue[(*tail)++] = graph->dst[j];
+}
+
+/* an unscheduled producer of an unscheduled system, which blocks it. */
+static int _dzSysPlanBlocker(dzSysPlan *plan, bool *done, int i)
+{
+  dzSys *sys;
+  int j, k;
+
+  sys = zArrayElemNC(plan->arr,i);
+  for( k=0; k<dzSysInputNum(sys); k++ )
+    if( ( j = _dzSysArrayIndex( plan->arr, dzSysInputElem(sys,k)->sp ) ) >= 0 && !done[j] ) return j;
+  return -1;
+}
+
+/* choose a system to break a closed loop. Since every unscheduled
+ * system is blocked by an unscheduled producer, walking back along
+ * them from any unscheduled system reaches a loop. */
+static int _dzSysPlanBreakLoop(dzSysPlan *plan, bool *done, bool *visit)
+{
+  int i, j, first = -1, brk = -1;
+
+  for( i=0; i<zArraySize(plan->arr); i++ ){
+    visit[i] = false;
+    if( first < 0 && !done[i] ) first = i;
+  }
+  for( i=first; !visit[i]; i=j ){
+    visit[i] = true;
+    if( ( j = _dzSysPlanBlocker( plan, done, i ) ) < 0 ) return i;
+  }
+  first = j = i; /* i is in the loop */
+  do{
+    if( !dzSysIsDirect( zArrayElemNC(plan->arr,j) ) && ( brk < 0 || j < brk ) ) brk = j;
+    if( j < first ) first = j;
+  } while( ( j = _dzSysPlanBlocker( plan, done, j ) ) != i );
+  if( brk >= 0 ) return brk;
+  ZRUNWARN( DZ_WARN_SYSPLAN_ALGEBRAICLOOP, zName(zArrayElemNC(plan->arr,first)) );
+  plan->loopnum++;
+  return first;
+}
+
+/* topologically sort systems. */
+static void _dzSysPlanSort(dzSysPlan *plan, _dzSysGraph *graph, bool *done, int *queue, bool *visit)
+{
+  int i, head = 0, tail = 0;
+
+  for( i=0; i<graph->num; i++ )
+    if( graph->indeg[i] == 0 ) queue[tail++] = i;
+  while( plan->num < graph->num ){
+    while( head < tail )
+      if( !done[( i = queue[head++] )] )
+        _dzSysPlanPush( plan, graph, i, done, queue, &tail );
+    if( plan->num < graph->num )
+      _dzSysPlanPush( plan, graph, _dzSysPlanBreakLoop( plan, done, visit ), done, queue, &tail );
+  }
+}
+
+/* create an execution plan of an array of systems. */
+dzSysPlan *dzSysPlanCreate(dzSysPlan *plan, dzSysArray *arr)
+{
+  _dzSysGraph graph;
+  bool *done, *visit;
+  int *queue, i;
+
+  dzSysPlanInit( plan );
+  plan->arr = arr;
+  if( !_dzSysGraphCreate( &graph, arr ) ) return NULL;
+  plan->sys = zAlloc( dzSys*, graph.num );
+  plan->update = zAlloc( dzSysUpdateMethod, graph.num );
+  done = zAlloc( bool, graph.num );
+  queue = zAlloc( int, graph.num );
+  visit = zAlloc( bool, graph.num );
+  if( graph.num > 0 && ( !plan->sys || !plan->update || !done || !queue || !visit ) ){
+    ZALLOCERROR();
+    dzSysPlanDestroy( plan );
+    plan = NULL;
+    goto TERMINATE;
+  }
+  _dzSysPlanSort( plan, &graph, done, queue, visit );
+  for( i=0; i<plan->num; i++ )
+    plan->update[i] = plan->sys[i]->com->_update;
+  for( i=0; i<plan->num; i++ )
+    if( plan->sys[i]->period > 0 ) break;
+  if( i < plan->num ){ /* multirate */
+    plan->div = zAlloc( int, plan->num );
+    plan->cnt = zAlloc( int, plan->num );
+    if( !plan->div || !plan->cnt ){
+      ZALLOCERROR();
+      dzSysPlanDestroy( plan );
+      plan = NULL;
+    }
+  }
+
+ TERMINATE:
+  zFree( done );
+  zFree( queue );
+  zFree( visit );
+  _dzSysGraphDestroy( &graph );
+  return plan;
+}
+
+/* check if a system of a plan is read by a faster system. */
+static bool _dzSysPlanFeedsFaster(dzSysPlan *plan, int i)
+{
+  dzSys *sys;
+  int j, k;
+
+  for( j=0; j<plan->num; j++ ){
+    if( plan->div[j] >= plan->div[i] ) continue;
+    sys = plan->sys[j];
+    for( k=0; k<dzSysInputNum(sys); k++ )
+      if( zArrayElemNC(dzSysInput(sys),k)->sp == plan->sys[i] ) return true;
+  }
+  return false;
+}
+
+/* prepare buffers to interpolate outputs of slow systems. */
+static bool _dzSysPlanInterpAlloc(dzSysPlan *plan)
+{
+  int i;
+
+  if( !( plan->prev = zAlloc( zVec, plan->num ) ) ||
+      !( plan->cur = zAlloc( zVec, plan->num ) ) ){
+    ZALLOCERROR();
+    return false;
+  }
+  for( i=0; i<plan->num; i++ ){
+    if( plan->div[i] <= 1 || !_dzSysPlanFeedsFaster( plan, i ) ) continue;
+    if( !( plan->prev[i] = zVecClone( dzSysOutput(plan->sys[i]) ) ) ||
+        !( plan->cur[i] = zVecClone( dzSysOutput(plan->sys[i]) ) ) ){
+      ZALLOCERROR();
+      return false;
+    }
+  }
+  return true;
+}
+
+/* compute numbers of base steps in sampling periods of systems. */
+static void _dzSysPlanSetRate(dzSysPlan *plan, double dt)
+{
+  double period;
+  int i;
+
+  _dzSysPlanInterpFree( plan );
+  for( i=0; i<plan->num; i++ ){
+    period = plan->sys[i]->period;
+    plan->div[i] = period > 0 ? (int)( period / dt + 0.5 ) : 1;
+    if( plan->div[i] < 1 ) plan->div[i] = 1;
+    if( period > 0 && !zIsTiny( plan->div[i] * dt - period ) )
+      ZRUNWARN( DZ_WARN_SYSPLAN_PERIODMISMATCH, zName(plan->sys[i]), period, dt );
+    plan->cnt[i] = 0;
+  }
+  plan->dt = dt;
+  if( plan->transition == DZ_SYS_RATE_INTERP && !_dzSysPlanInterpAlloc( plan ) ){
+    _dzSysPlanInterpFree( plan );
+    ZRUNWARN( DZ_WARN_SYSPLAN_INTERP_DISABLED );
+  }
+}
+
+/* update a system of a multirate plan. */
+static void _dzSysPlanUpdateMultirate(dzSysPlan *plan, int i, double dt)
+{
+  double phase;
+  int k;
+
+  if( plan->cur && plan->cur[i] ){ /* interpolated */
+    if( plan->cnt[i] == 0 ){
+      zVecCopyNC( plan->cur[i], dzSysOutput(plan->sys[i]) );
+      zVecCopyNC( plan->cur[i], plan->prev[i] );
+      plan->update[i]( plan->sys[i], dt*plan->div[i] );
+      zVecCopyNC( dzSysOutput(plan->sys[i]), plan->cur[i] );
+    }
+    phase = (double)plan->cnt[i] / plan->div[i];
+    for( k=0; k<dzSysOutputNum(plan->sys[i]); k++ )
+      dzSysOutputVal(plan->sys[i],k) = zVecElemNC(plan->prev[i],k)
+        + phase * ( zVecElemNC(plan->cur[i],k) - zVecElemNC(plan->prev[i],k) );
+  } else
+  if( plan->cnt[i] == 0 )
+    plan->update[i]( plan->sys[i], dt*plan->div[i] );
+  if( ++plan->cnt[i] == plan->div[i] ) plan->cnt[i] = 0;
+}
+
+/* index systems of the array of a lazy plan in the order of execution. */
+static void _dzSysPlanLazyIndex(dzSysPlan *plan)
+{
+  int i;
+
+  for( i=0; i<zArraySize(plan->arr); i++ )
+    plan->pos[i] = -1;
+  for( i=0; i<plan->num; i++ )
+    plan->pos[plan->sys[i]-zArrayBuf(plan->arr)] = i;
+}
+
+/* update a system of a lazy plan after the systems which feed it,
+ * where the producers are traced depth-first on an explicit stack of
+ * pairs of a system and the next input to be checked. */
+static void _dzSysPlanDemand(dzSysPlan *plan, int k)
+{
+  dzSys *sys;
+  int *stack, *next, i, j = -1, top = 0;
+
+  if( plan->stamp[plan->sys[k]-zArrayBuf(plan->arr)] == plan->tick ) return;
+  plan->stamp[plan->sys[k]-zArrayBuf(plan->arr)] = plan->tick;
+  stack = plan->stack;
+  next = plan->stack + zArraySize(plan->arr);
+  stack[top] = k;
+  next[top++] = 0;
+  while( top > 0 ){
+    sys = plan->sys[( k = stack[top-1] )];
+    for( i=next[top-1]; i<dzSysInputNum(sys); i++ )
+      if( ( j = _dzSysArrayIndex( plan->arr, dzSysInputElem(sys,i)->sp ) ) >= 0 &&
+          plan->pos[j] >= 0 && plan->pos[j] < k && plan->stamp[j] != plan->tick ) break;
+    if( i < dzSysInputNum(sys) ){ /* a producer not updated yet */
+      next[top-1] = i + 1;
+      plan->stamp[j] = plan->tick;
+      stack[top] = plan->pos[j];
+      next[top++] = 0;
+      continue;
+    }
+    plan->update[k]( sys, plan->dt );
+    top--;
+  }
+}
+
+/* update persistent and stateful systems of a lazy plan. */
+static void _dzSysPlanUpdateLazy(dzSysPlan *plan, double dt)
+{
+  int i;
+
+  if( dt != plan->dt ){
+    _dzSysPlanLazyIndex( plan );
+    plan->dt = dt;
+  }
+  if( ++plan->tick == 0 ){ /* no system is regarded as updated after wrapping */
+    memset( plan->stamp, 0, sizeof(unsigned long)*zMax(zArraySize(plan->arr),1) );
+    plan->tick = 1;
+  }
+  for( i=0; i<plan->num; i++ )
+    if( plan->sys[i]->persistent || dzSysIsStateful(plan->sys[i]) ) _dzSysPlanDemand( plan, i );
+}
+
+/* update all systems along an execution plan. */
+void dzSysPlanUpdate(dzSysPlan *plan, double dt)
+{
+  int i;
+
+  if( !plan->div ){
+    if( plan->lazy ){
+      _dzSysPlanUpdateLazy( plan, dt );
+      return;
+    }
+    for( i=0; i<plan->num; i++ )
+      plan->update[i]( plan->sys[i], dt );
+    return;
+  }
+  dzSysPlanUpdateBegin( plan, dt );
+  for( i=0; i<plan->num; i++ )
+    _dzSysPlanUpdateMultirate( plan, i, dt );
+}
+
+/* prepare an execution plan for a step. */
+void dzSysPlanUpdateBegin(dzSysPlan *plan, double dt)
+{
+  if( plan->div && dt != plan->dt ) _dzSysPlanSetRate( plan, dt );
+}
+
+/* update a system of an execution plan in a step. */
+bool dzSysPlanUpdateSys(dzSysPlan *plan, int i, double dt)
+{
+  bool fire;
+
+  if( !plan->div ){
+    plan->update[i]( plan->sys[i], dt );
+    return true;
+  }
+  fire = plan->cnt[i] == 0;
+  _dzSysPlanUpdateMultirate( plan, i, dt );
+  return fire;
+}
+
+/* set handling of rate transitions. */
+void dzSysPlanSetTransition(dzSysPlan *plan, dzSysRateTransition transition)
+{
+  plan->transition = transition;
+  plan->dt = 0; /* rates are recomputed at the next update */
+}
+
+/* mark a system and the systems which feed it. */
+static void _dzSysPlanMark(dzSysArray *arr, int i, bool *mark, int *stack)
+{
+  dzSys *sys;
+  int j, k, top = 0;
+
+  if( mark[i] ) return;
+  mark[i] = true;
+  stack[top++] = i;
+  while( top > 0 ){
+    sys = zArrayElemNC(arr,stack[--top]);
+    for( k=0; k<dzSysInputNum(sys); k++ )
+      if( ( j = _dzSysArrayIndex( arr, dzSysInputElem(sys,k)->sp ) ) >= 0 && !mark[j] ){
+        mark[j] = true;
+        stack[top++] = j;
+      }
+  }
+}
+
+/* prune systems not upstream of required systems from a plan. */
+int dzSysPlanPrune(dzSysPlan *plan, int reqnum, char *req[])
+{
+  bool *mark;
+  int *stack, i, k, num = -1;
+
+  mark = zAlloc( bool, zMax(zArraySize(plan->arr),1) );
+  stack = zAlloc( int, zMax(zArraySize(plan->arr),1) );
+  if( !mark || !stack ){
+    ZALLOCERROR();
+    goto TERMINATE;
+  }
+  for( i=0; i<reqnum; i++ ){
+    for( k=0; k<plan->num; k++ )
+      if( zNamePtr(plan->sys[k]) && strcmp( zName(plan->sys[k]), req[i] ) == 0 ) break;
+    if( k == plan->num ){
+      ZRUNWARN( DZ_WARN_SYSPLAN_REQUNFOUND, req[i] );
+      continue;
+    }
+    _dzSysPlanMark( plan->arr, plan->sys[k]-zArrayBuf(plan->arr), mark, stack );
+  }
+  for( k=0; k<plan->num; k++ )
+    if( plan->sys[k]->persistent )
+      _dzSysPlanMark( plan->arr, plan->sys[k]-zArrayBuf(plan->arr), mark, stack );
+  _dzSysPlanInterpFree( plan );
+  for( i=k=0; k<plan->num; k++ )
+    if( mark[plan->sys[k]-zArrayBuf(plan->arr)] ){
+      plan->sys[i] = plan->sys[k];
+      plan->update[i++] = plan->update[k];
+    }
+  num = plan->num - i;
+  plan->num = i;
+  plan->gen++;
+  plan->dt = 0; /* rates and indices are recomputed at the next update */
+ TERMINATE:
+  zFree( mark );
+  zFree( stack );
+  return num;
+}
+
+/* switch a plan to demand-driven evaluation. */
+bool dzSysPlanSetLazy(dzSysPlan *plan, bool lazy)
+{
+  zFree( plan->stamp );
+  zFree( plan->pos );
+  zFree( plan->stack );
+  plan->lazy = false;
+  plan->tick = 0;
+  plan->dt = 0;
+  if( !lazy ) return true;
+  plan->stamp = zAlloc( unsigned long, zMax(zArraySize(plan->arr),1) );
+  plan->pos = zAlloc( int, zMax(zArraySize(plan->arr),1) );
+  plan->stack = zAlloc( int, zMax(zArraySize(plan->arr),1)*2 );
+  if( !plan->stamp || !plan->pos || !plan->stack ){
+    ZALLOCERROR();
+    zFree( plan->stamp );
+    zFree( plan->pos );
+    zFree( plan->stack );
+    return false;
+  }
+  plan->lazy = true;
+  return true;
+}
+
+/* update a system of a lazy plan on demand. */
+zVec dzSysPlanDemand(dzSysPlan *plan, dzSys *sys)
+{
+  int i;
+
+  if( plan->lazy && !plan->div && plan->tick > 0 && plan->dt != 0 &&
+      ( i = _dzSysArrayIndex( plan->arr, sys ) ) >= 0 && plan->pos[i] >= 0 )
+    _dzSysPlanDemand( plan, plan->pos[i] );
+  return dzSysOutput(sys);
+}
+
+/* print the order of execution of a plan. */
+void dzSysPlanFPrint(FILE *fp, dzSysPlan *plan)
+{
+  int i;
+
+  for( i=0; i<plan->num; i++ ){
+    fprintf( fp, "%d: %s (%s)", i, zName(plan->sys[i]), plan->sys[i]->com->typestr );
+    if( plan->sys[i]->period > 0 )
+      fprintf( fp, " every %g", plan->sys[i]->period );
+    fprintf( fp, "\n" );
+  }
+  if( plan->loopnum > 0 )
+    fprintf( fp, "(%d algebraic loop(s) broken)\n", plan->loopnum );
+}
@@ -0,0 +1,306 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_prof - profiler of an array of systems
+ */
+
+#define _POSIX_C_SOURCE 199309L /* for clock_gettime() */
+#undef DZ_SYS_NOPROF
+
+#include <dzco/dz_sys.h>
+#include <time.h>
+
+/* ********************************************************** */
+/* log-linear histogram of durations
+ * ********************************************************** */
+
+#define DZ_SYS_HIST_SUBNUM ( 1 << DZ_SYS_HIST_SUBBIT )
+
+/* index of a bucket which a value belongs to. */
+static int _dzSysHistIndex(double val)
+{
+  unsigned long v;
+  int e;
+
+  if( val < DZ_SYS_HIST_SUBNUM ) return val > 0 ? (int)val : 0;
+  if( val >= (double)( 1UL << DZ_SYS_HIST_MAXBIT ) * 2 ) return DZ_SYS_HIST_SIZE - 1;
+  v = (unsigned long)val;
+  for( e=DZ_SYS_HIST_SUBBIT; v>>(e+1); e++ ); /* position of the most significant bit */
+  return ( ( e - DZ_SYS_HIST_SUBBIT + 1 ) << DZ_SYS_HIST_SUBBIT ) + (int)( v >> ( e - DZ_SYS_HIST_SUBBIT ) ) - DZ_SYS_HIST_SUBNUM;
+}
+
+/* the highest value equivalent to a bucket. */
+static double _dzSysHistUpper(int i)
+{
+  int k, sub;
+
+  if( i < DZ_SYS_HIST_SUBNUM ) return i + 1;
+  k = i >> DZ_SYS_HIST_SUBBIT;
+  sub = i & ( DZ_SYS_HIST_SUBNUM - 1 );
+  return (double)( DZ_SYS_HIST_SUBNUM + sub + 1 ) * ( 1UL << ( k - 1 ) );
+}
+
+/* initialize a histogram. */
+dzSysHist *dzSysHistInit(dzSysHist *hist)
+{
+  hist->count = 0;
+  hist->sum = hist->min = hist->max = 0;
+  memset( hist->bucket, 0, sizeof(uint)*DZ_SYS_HIST_SIZE );
+  return hist;
+}
+
+/* add a value to a histogram. */
+void dzSysHistAdd(dzSysHist *hist, double val)
+{
+  if( hist->count++ == 0 )
+    hist->min = hist->max = val;
+  else if( val < hist->min )
+    hist->min = val;
+  else if( val > hist->max )
+    hist->max = val;
+  hist->sum += val;
+  hist->bucket[_dzSysHistIndex(val)]++;
+}
+
+/* percentile of values recorded in a histogram. */
+double dzSysHistPercentile(dzSysHist *hist, double q)
+{
+  double target, cum = 0;
+  int i;
+
+  if( hist->count == 0 ) return 0;
+  target = zLimit( q, 0, 100 ) * 0.01 * hist->count;
+  for( i=0; i<DZ_SYS_HIST_SIZE; i++ )
+    if( ( cum += hist->bucket[i] ) >= target && cum > 0 ) break;
+  return i < DZ_SYS_HIST_SIZE ? zMin( _dzSysHistUpper(i), hist->max ) : hist->max;
+}
+
+/* ********************************************************** */
+/* profiler of an array of systems
+ * ********************************************************** */
+
+/* current time in nanoseconds. */
+static double _dzSysProfNow(void)
+{
+#if defined(CLOCK_MONOTONIC)
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec * 1.0e9 + ts.tv_nsec;
+#else
+  return (double)clock() / CLOCKS_PER_SEC * 1.0e9;
+#endif
+}
+
+/* size of a record of a tick in the trace (start and duration of the
+ * tick, followed by those of each system) */
+#define __dz_sys_prof_trace_size(p) ( 2 + 2*zArraySize((p)->arr) )
+
+/* create a profiler. */
+dzSysProf *dzSysProfCreate(dzSysProf *prof, dzSysArray *arr, int tracenum)
+{
+  prof->arr = arr;
+  prof->tracenum = zMax( tracenum, 0 );
+  prof->block = zAlloc( dzSysHist, zArraySize(arr) );
+  prof->blame = zAlloc( unsigned long, zArraySize(arr) );
+  prof->trace = prof->tracenum > 0 ? zAlloc( double, __dz_sys_prof_trace_size(prof)*prof->tracenum ) : NULL;
+  if( !prof->block || !prof->blame || ( prof->tracenum > 0 && !prof->trace ) ){
+    ZALLOCERROR();
+    dzSysProfDestroy( prof );
+    return NULL;
+  }
+  prof->budget = 0;
+  dzSysProfReset( prof );
+  return prof;
+}
+
+/* clear records of a profiler. */
+void dzSysProfReset(dzSysProf *prof)
+{
+  int i;
+
+  for( i=0; i<zArraySize(prof->arr); i++ ){
+    dzSysHistInit( &prof->block[i] );
+    prof->blame[i] = 0;
+  }
+  dzSysHistInit( &prof->tick );
+  prof->overrun = 0;
+  prof->tracecount = 0;
+  prof->_origin = _dzSysProfNow();
+}
+
+/* destroy a profiler. */
+void dzSysProfDestroy(dzSysProf *prof)
+{
+  zFree( prof->block );
+  zFree( prof->blame );
+  zFree( prof->trace );
+  prof->arr = NULL;
+  prof->tracenum = 0;
+}
+
+/* record of the next tick in the trace. */
+static double *_dzSysProfTraceNext(dzSysProf *prof)
+{
+  double *trace;
+  int i;
+
+  if( prof->tracenum == 0 ) return NULL;
+  trace = prof->trace + __dz_sys_prof_trace_size(prof) * ( prof->tracecount++ % prof->tracenum );
+  for( i=0; i<zArraySize(prof->arr); i++ )
+    trace[3+2*i] = -1; /* not updated */
+  return trace;
+}
+
+/* record updating time of a system, and find the one which took
+ * the longest time in a tick. */
+static void _dzSysProfRecord(dzSysProf *prof, double *trace, int i, double t, double d, int *worst, double *dmax)
+{
+  dzSysHistAdd( &prof->block[i], d );
+  if( trace ){
+    trace[2+2*i] = t - prof->_origin;
+    trace[3+2*i] = d;
+  }
+  if( d > *dmax ){
+    *dmax = d;
+    *worst = i;
+  }
+}
+
+/* record latency of a tick. */
+static void _dzSysProfTick(dzSysProf *prof, double *trace, double t0, double t, int worst)
+{
+  dzSysHistAdd( &prof->tick, t - t0 );
+  if( trace ){
+    trace[0] = t0 - prof->_origin;
+    trace[1] = t - t0;
+  }
+  if( prof->budget > 0 && t - t0 > prof->budget ){
+    prof->overrun++;
+    if( worst >= 0 ) prof->blame[worst]++;
+  }
+}
+
+/* update all systems of an array with profiling. */
+void dzSysProfArrayUpdate(dzSysProf *prof, dzSysArray *arr, double dt)
+{
+  double *trace, t0, t, t1, dmax = 0;
+  int i, worst = -1;
+
+  trace = _dzSysProfTraceNext( prof );
+  t0 = t = _dzSysProfNow();
+  for( i=0; i<zArraySize(arr); i++ ){
+    dzSysUpdate( zArrayElemNC(arr,i), dt );
+    t1 = _dzSysProfNow();
+    _dzSysProfRecord( prof, trace, i, t, t1 - t, &worst, &dmax );
+    t = t1;
+  }
+  _dzSysProfTick( prof, trace, t0, t, worst );
+}
+
+/* update all systems along an execution plan with profiling. */
+void dzSysProfPlanUpdate(dzSysProf *prof, dzSysPlan *plan, double dt)
+{
+  double *trace, t0, t, t1, dmax = 0;
+  int i, worst = -1;
+  bool fire;
+
+  trace = _dzSysProfTraceNext( prof );
+  if( dzSysPlanIsLazy(plan) ){ /* only the latency of the tick is timed */
+    t0 = _dzSysProfNow();
+    dzSysPlanUpdate( plan, dt );
+    _dzSysProfTick( prof, trace, t0, _dzSysProfNow(), worst );
+    return;
+  }
+  dzSysPlanUpdateBegin( plan, dt );
+  t0 = t = _dzSysProfNow();
+  for( i=0; i<plan->num; i++ ){
+    fire = dzSysPlanUpdateSys( plan, i, dt );
+    t1 = _dzSysProfNow();
+    /* only systems due at the step are timed in multirate plans */
+    if( fire )
+      _dzSysProfRecord( prof, trace, plan->sys[i] - zArrayElemNC(prof->arr,0), t, t1 - t, &worst, &dmax );
+    t = t1;
+  }
+  _dzSysProfTick( prof, trace, t0, t, worst );
+}
+
+/* print results of profiling. */
+void dzSysProfFPrint(FILE *fp, dzSysProf *prof)
+{
+  dzSysHist *hist;
+  dzSys *sys;
+  int i;
+
+  hist = &prof->tick;
+  fprintf( fp, "tick: count=%lu mean=%.0f min=%.0f p99=%.0f max=%.0f [ns]\n",
+    dzSysHistCount(hist), dzSysHistMean(hist), dzSysHistMin(hist), dzSysHistPercentile(hist,99), dzSysHistMax(hist) );
+  if( prof->budget > 0 )
+    fprintf( fp, "budget: %.0f [ns], overrun=%lu\n", prof->budget, prof->overrun );
+  fprintf( fp, "%5s %-16s %-16s %10s %10s %10s %10s\n", "#", "name", "type", "mean", "p99", "max", "blame" );
+  for( i=0; i<zArraySize(prof->arr); i++ ){
+    sys = zArrayElemNC(prof->arr,i);
+    hist = &prof->block[i];
+    fprintf( fp, "%5d %-16s %-16s %10.0f %10.0f %10.0f %10lu\n", i,
+      zNamePtr(sys) ? zName(sys) : "-", sys->com ? sys->com->typestr : "-",
+      dzSysHistMean(hist), dzSysHistPercentile(hist,99), dzSysHistMax(hist), prof->blame[i] );
+  }
+}
+
+/* print a string as a JSON string. */
+static void _dzSysProfFPrintJSONStr(FILE *fp, const char *str)
+{
+  fputc( '"', fp );
+  for( ; *str; str++ ){
+    if( *str == '"' || *str == '\\' ) fputc( '\\', fp );
+    fputc( *str, fp );
+  }
+  fputc( '"', fp );
+}
+
+/* print a trace in the trace event format of Chrome. */
+void dzSysProfFPrintTrace(FILE *fp, dzSysProf *prof)
+{
+  double *trace;
+  unsigned long k, n;
+  dzSys *sys;
+  int i;
+  bool first = true;
+
+  fprintf( fp, "{\"traceEvents\":[\n" );
+  n = zMin( prof->tracecount, (unsigned long)prof->tracenum );
+  for( k=prof->tracecount-n; k<prof->tracecount; k++ ){
+    trace = prof->trace + __dz_sys_prof_trace_size(prof) * ( k % prof->tracenum );
+    fprintf( fp, "%s{\"name\":\"tick\",\"cat\":\"tick\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"tick\":%lu}}",
+      first ? "" : ",\n", trace[0]*1.0e-3, trace[1]*1.0e-3, k );
+    first = false;
+    for( i=0; i<zArraySize(prof->arr); i++ ){
+      if( trace[3+2*i] < 0 ) continue;
+      sys = zArrayElemNC(prof->arr,i);
+      fprintf( fp, ",\n{\"name\":" );
+      if( zNamePtr(sys) )
+        _dzSysProfFPrintJSONStr( fp, zName(sys) );
+      else
+        fprintf( fp, "\"#%d\"", i );
+      fprintf( fp, ",\"cat\":" );
+      _dzSysProfFPrintJSONStr( fp, sys->com ? sys->com->typestr : "-" );
+      fprintf( fp, ",\"ph\":\"X\",\"pid\":0,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"index\":%d}}",
+        trace[2+2*i]*1.0e-3, trace[3+2*i]*1.0e-3, i );
+    }
+  }
+  fprintf( fp, "\n],\"displayTimeUnit\":\"ns\"}\n" );
+}
+
+/* write a trace to a file. */
+bool dzSysProfWriteTrace(dzSysProf *prof, char filename[])
+{
+  FILE *fp;
+
+  if( !( fp = fopen( filename, "w" ) ) ){
+    ZOPENERROR( filename );
+    return false;
+  }
+  dzSysProfFPrintTrace( fp, prof );
+  fclose( fp );
+  return true;
+}
@@ -0,0 +1,121 @@
+/* DZco - digital control library
+ * Copyright (C) 2000 Tomomichi Sugihara (Zhidao)
+ *
+ * dz_sys_snap - snapshot of internal states of systems
+ */
+
+#include <dzco/dz_sys.h>
+
+/* number of values of internal states of a system. */
+static int _dzSysStateSize(dzSys *sys)
+{
+  if( sys->com->_snapshot ) return sys->com->_snapshot( sys, NULL );
+  if( sys->com->_prpnum > 0 ) return sys->com->_prpnum;
+  return sys->prp ? -1 : 0;
+}
+
+int dzSysSnapshotSize(dzSys *sys)
+{
+  int size;
+
+  if( ( size = _dzSysStateSize( sys ) ) < 0 ){
+    ZRUNERROR( DZ_ERR_SYS_SNAPSHOT_UNSUPPORTED, sys->com->typestr );
+    return -1;
+  }
+  return dzSysOutputNum(sys) + size;
+}
+
+double *dzSysSnapshot(dzSys *sys, double *buf)
+{
+  memcpy( buf, zVecBufNC(dzSysOutput(sys)), sizeof(double)*dzSysOutputNum(sys) );
+  buf += dzSysOutputNum(sys);
+  if( sys->com->_snapshot )
+    return buf + sys->com->_snapshot( sys, buf );
+  if( sys->com->_prpnum > 0 )
+    memcpy( buf, sys->prp, sizeof(double)*sys->com->_prpnum );
+  return buf + sys->com->_prpnum;
+}
+
+const double *dzSysRestore(dzSys *sys, const double *buf)
+{
+  memcpy( zVecBufNC(dzSysOutput(sys)), buf, sizeof(double)*dzSysOutputNum(sys) );
+  buf += dzSysOutputNum(sys);
+  if( sys->com->_snapshot ){
+    sys->com->_restore( sys, buf );
+    return buf + sys->com->_snapshot( sys, NULL );
+  }
+  if( sys->com->_prpnum > 0 )
+    memcpy( sys->prp, buf, sizeof(double)*sys->com->_prpnum );
+  return buf + sys->com->_prpnum;
+}
+
+/* ********************************************************** */
+/* internal states of an array of systems
+ * ********************************************************** */
+
+/* number of values of internal states of an array of systems. */
+static int _dzSysArrayStateSize(dzSysArray *arr)
+{
+  int i, size, total = 0;
+
+  for( i=0; i<zArraySize(arr); i++ ){
+    if( ( size = dzSysSnapshotSize( zArrayElemNC(arr,i) ) ) < 0 ) return -1;
+    total += size;
+  }
+  return total;
+}
+
+dzSysState *dzSysStateAlloc(dzSysState *state, dzSysArray *arr)
+{
+  dzSysStateInit( state );
+  if( ( state->size = _dzSysArrayStateSize( arr ) ) < 0 ){
+    state->size = 0;
+    return NULL;
+  }
+  if( !( state->buf = zAlloc( double, zMax(state->size,1) ) ) ){
+    ZALLOCERROR();
+    state->size = 0;
+    return NULL;
+  }
+  return state;
+}
+
+void dzSysStateFree(dzSysState *state)
+{
+  zFree( state->buf );
+  state->size = 0;
+}
+
+bool dzSysArraySnapshot(dzSysArray *arr, dzSysState *state)
+{
+  double *buf;
+  int i, size;
+
+  buf = state->buf;
+  for( i=0; i<zArraySize(arr); i++ ){
+    if( ( size = dzSysSnapshotSize( zArrayElemNC(arr,i) ) ) < 0 ||
+        buf - state->buf + size > state->size ) goto FAILURE;
+    buf = dzSysSnapshot( zArrayElemNC(arr,i), buf );
+  }
+  if( buf - state->buf == state->size ) return true;
+ FAILURE:
+  ZRUNERROR( DZ_ERR_SYS_SNAPSHOT_SIZMIS );
+  return false;
+}
+
+bool dzSysArrayRestore(dzSysArray *arr, dzSysState *state)
+{
+  const double *buf;
+  int i, size;
+
+  buf = state->buf;
+  for( i=0; i<zArraySize(arr); i++ ){
+    if( ( size = dzSysSnapshotSize( zArrayElemNC(arr,i) ) ) < 0 ||
+        buf - state->buf + size > state->size ) goto FAILURE;
+    buf = dzSysRestore( zArrayElemNC(arr,i), buf );
+  }
+  if( buf - state->buf == state->size ) return true;
+ FAILURE:
+  ZRUNERROR( DZ_ERR_SYS_SNAPSHOT_SIZMIS );
+  return false;
+}
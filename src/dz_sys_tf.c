@@ -71,6 +71,11 @@ static zVec _dzSysTFUpdate(dzSys *sys, double dt)
   return dzSysOutput(sys);
 }
 
+static bool _dzSysTFFeedthrough(dzSys *sys)
+{
+  return !zIsTiny( ((dzSysTFPrm*)sys->prp)->d );
+}
+
 static void dzSysTFFPrintZTK(FILE *fp, dzSys *sys)
 {
   dzTFFPrintZTK( fp, ((dzSysTFPrm*)sys->prp)->tf );
@@ -85,6 +90,127 @@ static dzSys *_dzSysTFFromZTK(dzSys *sys, ZTK *ztk)
   return dzSysTFCreate( sys, tf );
 }
 
+static bool _dzSysTFEncode(dzSys *sys, dzSysBin *bin)
+{
+  dzSysTFPrm *prm;
+  int i;
+
+  prm = (dzSysTFPrm *)sys->prp;
+  if( !dzSysBinWriteInt( bin, dzTFNumDim(prm->tf) ) ||
+      !dzSysBinWriteInt( bin, dzTFDenDim(prm->tf) ) ) return false;
+  for( i=0; i<=dzTFNumDim(prm->tf); i++ )
+    if( !dzSysBinWriteDouble( bin, dzTFNumElem(prm->tf,i) ) ) return false;
+  for( i=0; i<=dzTFDenDim(prm->tf); i++ )
+    if( !dzSysBinWriteDouble( bin, dzTFDenElem(prm->tf,i) ) ) return false;
+  return dzSysBinWriteInt( bin, prm->n ) &&
+         dzSysBinWriteDoubleArray( bin, prm->z, prm->n );
+}
+
+static dzSys *_dzSysTFDecode(dzSys *sys, dzSysBin *bin)
+{
+  dzTF *tf;
+  double val;
+  int nn, nd, n, i;
+
+  if( !dzSysBinReadInt( bin, &nn ) || !dzSysBinReadInt( bin, &nd ) ) return NULL;
+  if( !( tf = zAlloc( dzTF, 1 ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  if( !dzTFAlloc( tf, nn, nd ) ){
+    zFree( tf );
+    return NULL;
+  }
+  for( i=0; i<=nn; i++ ){
+    if( !dzSysBinReadDouble( bin, &val ) ) goto FAILURE;
+    dzTFSetNumElem( tf, i, val );
+  }
+  for( i=0; i<=nd; i++ ){
+    if( !dzSysBinReadDouble( bin, &val ) ) goto FAILURE;
+    dzTFSetDenElem( tf, i, val );
+  }
+  if( !dzSysTFCreate( sys, tf ) || !sys->prp ) goto FAILURE;
+  if( !dzSysBinReadInt( bin, &n ) || n != ((dzSysTFPrm*)sys->prp)->n ||
+      !dzSysBinReadDoubleArray( bin, ((dzSysTFPrm*)sys->prp)->z, n ) ){
+    dzSysDestroy( sys );
+    return NULL;
+  }
+  return sys;
+
+ FAILURE:
+  dzTFDestroy( tf );
+  zFree( tf );
+  return NULL;
+}
+
+/* copy a polynomial rational expression. */
+static bool _dzSysTFCopyTF(dzTF *src, dzTF *dest)
+{
+  int i;
+
+  if( !dzTFAlloc( dest, dzTFNumDim(src), dzTFDenDim(src) ) ) return false;
+  for( i=0; i<=dzTFNumDim(src); i++ )
+    dzTFSetNumElem( dest, i, dzTFNumElem(src,i) );
+  for( i=0; i<=dzTFDenDim(src); i++ )
+    dzTFSetDenElem( dest, i, dzTFDenElem(src,i) );
+  return true;
+}
+
+static dzSys *_dzSysTFClone(dzSys *src, dzSys *dest)
+{
+  dzSysTFPrm *org, *prm;
+  dzTF *tf;
+
+  org = (dzSysTFPrm *)src->prp;
+  if( !( tf = zAlloc( dzTF, 1 ) ) ){
+    ZALLOCERROR();
+    return NULL;
+  }
+  if( !_dzSysTFCopyTF( org->tf, tf ) ){
+    zFree( tf );
+    return NULL;
+  }
+  dzSysInit( dest );
+  dzSysAllocInput( dest, 1 );
+  if( dzSysInputNum(dest) == 0 || !dzSysAllocOutput( dest, 1 ) ||
+      !( prm = _dzSysTFPrmAlloc( org->n ) ) ){
+    ZALLOCERROR();
+    zArrayFree( dzSysInput(dest) );
+    zVecFree( dzSysOutput(dest) );
+    dzTFDestroy( tf );
+    zFree( tf );
+    return NULL;
+  }
+  /* the realization is copied without conversion */
+  memcpy( prm->z, org->z, sizeof(double)*org->n );
+  memcpy( prm->a, org->a, sizeof(double)*org->n );
+  memcpy( prm->c, org->c, sizeof(double)*org->n );
+  prm->d = org->d;
+  prm->tf = tf;
+  dest->prp = prm;
+  dest->com = &dz_sys_tf_com;
+  return dest;
+}
+
+static int _dzSysTFSnapshot(dzSys *sys, double *buf)
+{
+  dzSysTFPrm *prm;
+
+  prm = (dzSysTFPrm *)sys->prp;
+  if( buf ) memcpy( buf, prm->z, sizeof(double)*prm->n );
+  return prm->n;
+}
+
+static void _dzSysTFRestore(dzSys *sys, const double *buf)
+{
+  memcpy( ((dzSysTFPrm*)sys->prp)->z, buf, sizeof(double)*((dzSysTFPrm*)sys->prp)->n );
+}
+
+static bool _dzSysTFTF(dzSys *sys, dzTF *tf)
+{
+  return _dzSysTFCopyTF( ((dzSysTFPrm *)sys->prp)->tf, tf );
+}
+
 dzSysCom dz_sys_tf_com = {
   .typestr = "tf",
   ._destroy = _dzSysTFDestroy,
@@ -92,6 +218,13 @@ dzSysCom dz_sys_tf_com = {
   ._update = _dzSysTFUpdate,
   ._fromZTK = _dzSysTFFromZTK,
   ._fprintZTK = dzSysTFFPrintZTK,
+  ._feedthrough = _dzSysTFFeedthrough,
+  ._encode = _dzSysTFEncode,
+  ._decode = _dzSysTFDecode,
+  ._clone = _dzSysTFClone,
+  ._snapshot = _dzSysTFSnapshot,
+  ._restore = _dzSysTFRestore,
+  ._tf = _dzSysTFTF,
 };
 
 /* create a transfer function from a polynomial rational expression
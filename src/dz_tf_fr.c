@@ -6,6 +6,12 @@
 
 #include <dzco/dz_tf.h>
 
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 /* ********************************************************** */
 /* frequency response
  * ********************************************************** */
@@ -25,16 +31,6 @@ dzFreqRes *dzFreqResFromComplex(dzFreqRes *fr, zComplex *c, double af)
   return fr;
 }
 
-static dzFreqRes *_dzFreqResMul(dzFreqRes *fr1, dzFreqRes *fr2, dzFreqRes *fr)
-{
-  if( !zEqual( fr1->f, fr2->f, zTOL ) )
-    ZRUNWARN( DZ_WARN_TF_FR_NOTCORRESPOND, fr1->f, fr2->f );
-  fr->f = fr1->f;
-  fr->g = fr1->g + fr2->g;
-  fr->p = fr1->p + fr2->p;
-  return fr;
-}
-
 static dzFreqRes *_dzFreqResDiv(dzFreqRes *fr1, dzFreqRes *fr2, dzFreqRes *fr)
 {
   if( !zEqual( fr1->f, fr2->f, zTOL ) )
@@ -108,18 +104,478 @@ zComplex *dzTFToComplex(dzTF *tf, double af, zComplex *c)
   return dzFreqResToComplex( &fr, c, &af );
 }
 
+/* frequency responses on a grid of angular frequencies */
+
+#define DZ_FREQRES_GRID_BLOCK 256 /* number of frequencies processed at once */
+#define DZ_FREQRES_GRID_NORM    4 /* number of factors between renormalizations */
+
+/* multiply (re + j im) by (-z + j af) for all frequencies */
+static void _dzFreqResGridMul(int n, double *re, double *im, const double *af, zComplex *z)
+{
+  double a, b, r;
+  int i = 0;
+#if defined(__AVX512F__)
+  __m512d va, vzi, vb, vre, vim;
+
+  va = _mm512_set1_pd( -z->re ); vzi = _mm512_set1_pd( z->im );
+  for( ; i+8<=n; i+=8 ){
+    vb = _mm512_sub_pd( _mm512_loadu_pd( af+i ), vzi );
+    vre = _mm512_loadu_pd( re+i ); vim = _mm512_loadu_pd( im+i );
+    _mm512_storeu_pd( re+i, _mm512_sub_pd( _mm512_mul_pd( vre, va ), _mm512_mul_pd( vim, vb ) ) );
+    _mm512_storeu_pd( im+i, _mm512_add_pd( _mm512_mul_pd( vre, vb ), _mm512_mul_pd( vim, va ) ) );
+  }
+#elif defined(__AVX2__)
+  __m256d va, vzi, vb, vre, vim;
+
+  va = _mm256_set1_pd( -z->re ); vzi = _mm256_set1_pd( z->im );
+  for( ; i+4<=n; i+=4 ){
+    vb = _mm256_sub_pd( _mm256_loadu_pd( af+i ), vzi );
+    vre = _mm256_loadu_pd( re+i ); vim = _mm256_loadu_pd( im+i );
+    _mm256_storeu_pd( re+i, _mm256_sub_pd( _mm256_mul_pd( vre, va ), _mm256_mul_pd( vim, vb ) ) );
+    _mm256_storeu_pd( im+i, _mm256_add_pd( _mm256_mul_pd( vre, vb ), _mm256_mul_pd( vim, va ) ) );
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  float64x2_t va, vzi, vb, vre, vim;
+
+  va = vdupq_n_f64( -z->re ); vzi = vdupq_n_f64( z->im );
+  for( ; i+2<=n; i+=2 ){
+    vb = vsubq_f64( vld1q_f64( af+i ), vzi );
+    vre = vld1q_f64( re+i ); vim = vld1q_f64( im+i );
+    vst1q_f64( re+i, vsubq_f64( vmulq_f64( vre, va ), vmulq_f64( vim, vb ) ) );
+    vst1q_f64( im+i, vaddq_f64( vmulq_f64( vre, vb ), vmulq_f64( vim, va ) ) );
+  }
+#endif
+  for( a=-z->re; i<n; i++ ){ /* scalar fallback and remainder */
+    b = af[i] - z->im;
+    r = re[i] * a - im[i] * b;
+    im[i] = re[i] * b + im[i] * a;
+    re[i] = r;
+  }
+}
+
+/* split (re + j im) into a mantissa and a binary exponent to avoid overflow and underflow */
+static void _dzFreqResGridNormalize(int n, double *re, double *im, double *ex)
+{
+  int i, e;
+
+  for( i=0; i<n; i++ ){
+    if( re[i] == 0 && im[i] == 0 ) continue;
+    frexp( fabs( re[i] ) + fabs( im[i] ), &e );
+    re[i] = ldexp( re[i], -e );
+    im[i] = ldexp( im[i], -e );
+    ex[i] += e;
+  }
+}
+
+/* product of factors (-z + j af) over a set of zeros or poles */
+static void _dzFreqResGridProd(int n, double *re, double *im, double *ex, const double *af, zCVec z)
+{
+  int i;
+
+  for( i=0; i<n; i++ ){
+    re[i] = 1; im[i] = 0; ex[i] = 0;
+  }
+  if( !z ) return;
+  for( i=0; i<zCVecSizeNC(z); i++ ){
+    _dzFreqResGridMul( n, re, im, af, zCVecElemNC(z,i) );
+    if( ( i + 1 ) % DZ_FREQRES_GRID_NORM == 0 )
+      _dzFreqResGridNormalize( n, re, im, ex );
+  }
+  _dzFreqResGridNormalize( n, re, im, ex );
+}
+
+/* frequency responses on a grid, where the phase lags are unwrapped
+ * from a phase lag \a anchor at the previous frequency if given, or
+ * from that at the first frequency computed by dzFreqResFromTF(). */
+static bool _dzFreqResGridFromTF(dzTF *tf, const double af[], int n, double g[], double p[], double *anchor)
+{
+  double nre[DZ_FREQRES_GRID_BLOCK], nim[DZ_FREQRES_GRID_BLOCK], nex[DZ_FREQRES_GRID_BLOCK];
+  double dre[DZ_FREQRES_GRID_BLOCK], dim[DZ_FREQRES_GRID_BLOCK], dex[DZ_FREQRES_GRID_BLOCK];
+  double g0, dp;
+  dzFreqRes fr;
+  int i, j, m;
+
+  if( n <= 0 ) return true;
+  if( !dzTFZero(tf) && !dzTFPole(tf) && !dzTFZeroPole( tf ) ) return false;
+  g0 = log10( dzTFNumElem(tf,dzTFNumDim(tf)) / dzTFDenElem(tf,dzTFDenDim(tf)) );
+  for( i=0; i<n; i+=m ){
+    m = zMin( n - i, DZ_FREQRES_GRID_BLOCK );
+    _dzFreqResGridProd( m, nre, nim, nex, af+i, dzTFZero(tf) );
+    _dzFreqResGridProd( m, dre, dim, dex, af+i, dzTFPole(tf) );
+    for( j=0; j<m; j++ ){ /* one logarithm and one arctangent per frequency */
+      g[i+j] = 20 * ( g0 + 0.5 * log10( ( zSqr(nre[j]) + zSqr(nim[j]) ) / ( zSqr(dre[j]) + zSqr(dim[j]) ) ) + ( nex[j] - dex[j] ) * log10( 2.0 ) );
+      p[i+j] = atan2( nim[j]*dre[j] - nre[j]*dim[j], nre[j]*dre[j] + nim[j]*dim[j] );
+    }
+  }
+  /* phase unwrapping, where the offset is found from the anchor */
+  if( anchor ){
+    dp = zRad2Deg( p[0] ) - *anchor;
+    p[0] = *anchor + dp - 360 * floor( dp / 360 + 0.5 );
+  } else{
+    dzFreqResFromTF( &fr, tf, af[0] );
+    p[0] = zRad2Deg( p[0] );
+    p[0] += 360 * floor( ( fr.p - p[0] ) / 360 + 0.5 );
+  }
+  for( i=1; i<n; i++ ){
+    dp = zRad2Deg( p[i] ) - p[i-1];
+    p[i] = p[i-1] + dp - 360 * floor( dp / 360 + 0.5 );
+  }
+  return true;
+}
+
+bool dzFreqResGridFromTF(dzTF *tf, const double af[], int n, double g[], double p[])
+{
+  return _dzFreqResGridFromTF( tf, af, n, g, p, NULL );
+}
+
+/* ********************************************************** */
+/* contiguous table of sampled frequency responses
+ * ********************************************************** */
+
+dzFreqResArray *dzFreqResArrayInit(dzFreqResArray *arr)
+{
+  arr->size = arr->capacity = 0;
+  arr->f = arr->g = arr->p = NULL;
+  arr->_slice = false;
+  return arr;
+}
+
+bool dzFreqResArrayReserve(dzFreqResArray *arr, int capacity)
+{
+  double *f, *g, *p;
+
+  if( arr->_slice ){
+    ZRUNERROR( DZ_ERR_TF_FR_SLICE );
+    return false;
+  }
+  if( capacity <= arr->capacity ) return true;
+  if( ( f = zRealloc( arr->f, double, capacity ) ) ) arr->f = f;
+  if( ( g = zRealloc( arr->g, double, capacity ) ) ) arr->g = g;
+  if( ( p = zRealloc( arr->p, double, capacity ) ) ) arr->p = p;
+  if( !f || !g || !p ){
+    ZALLOCERROR();
+    return false;
+  }
+  arr->capacity = capacity;
+  return true;
+}
+
+void dzFreqResArrayDestroy(dzFreqResArray *arr)
+{
+  if( !arr->_slice ){
+    zFree( arr->f );
+    zFree( arr->g );
+    zFree( arr->p );
+  }
+  dzFreqResArrayInit( arr );
+}
+
+bool dzFreqResArrayAdd(dzFreqResArray *arr, double f, double g, double p)
+{
+  if( arr->size == arr->capacity &&
+      !dzFreqResArrayReserve( arr, arr->capacity > 0 ? 2*arr->capacity : 16 ) ) return false;
+  arr->f[arr->size] = f;
+  arr->g[arr->size] = g;
+  arr->p[arr->size] = p;
+  arr->size++;
+  return true;
+}
+
+dzFreqResArray *dzFreqResArraySlice(dzFreqResArray *arr, int from, int to, dzFreqResArray *slice)
+{
+  from = zLimit( from, 0, arr->size );
+  to = zLimit( to, from, arr->size );
+  slice->size = slice->capacity = to - from;
+  slice->f = arr->f + from;
+  slice->g = arr->g + from;
+  slice->p = arr->p + from;
+  slice->_slice = true;
+  return slice;
+}
+
+/* the first index of which frequency is not less (or, more if upper is true) than f */
+static int _dzFreqResArrayBound(dzFreqResArray *arr, double f, bool upper)
+{
+  int lo = 0, hi = arr->size, mid;
+
+  while( lo < hi ){
+    mid = ( lo + hi ) / 2;
+    if( upper ? arr->f[mid] <= f : arr->f[mid] < f ) lo = mid + 1; else hi = mid;
+  }
+  return lo;
+}
+
+dzFreqResArray *dzFreqResArraySliceFreq(dzFreqResArray *arr, double fmin, double fmax, dzFreqResArray *slice)
+{
+  return dzFreqResArraySlice( arr, _dzFreqResArrayBound( arr, fmin, false ), _dzFreqResArrayBound( arr, fmax, true ), slice );
+}
+
+/* G / ( 1 + s G ) for closed-loop (s = 1) and open-loop (s = -1) conversions */
+static dzFreqResArray *_dzFreqResArrayFeedback(dzFreqResArray *arr, double s)
+{
+  double mag, phase, re, im;
+  int i;
+
+  for( i=0; i<arr->size; i++ ){
+    mag = pow( 10, 0.05*arr->g[i] );
+    phase = zDeg2Rad( arr->p[i] );
+    re = 1 + s * mag * cos( phase );
+    im = s * mag * sin( phase );
+    arr->g[i] -= 10 * log10( re*re + im*im );
+    arr->p[i] -= zRad2Deg( atan2( im, re ) );
+  }
+  return arr;
+}
+
+dzFreqResArray *dzFreqResArray2Closed(dzFreqResArray *arr)
+{
+  return _dzFreqResArrayFeedback( arr, 1 );
+}
+
+dzFreqResArray *dzFreqResArray2Open(dzFreqResArray *arr)
+{
+  return _dzFreqResArrayFeedback( arr, -1 );
+}
+
+/* connect a transfer function in series to a frequency response. */
 static dzFreqRes *_dzFreqResConnectTF(dzFreqRes *frin, dzTF *tf, dzFreqRes *frout)
 {
   dzFreqRes fr;
 
   dzFreqResFromTF( &fr, tf, zPIx2 * frin->f );
-  return _dzFreqResMul( frin, &fr, frout );
+  frout->f = frin->f;
+  frout->g = frin->g + fr.g;
+  frout->p = frin->p + fr.p;
+  return frout;
+}
+
+dzFreqResArray *dzFreqResArrayConnectTF(dzFreqResArray *arr, dzTF *tf)
+{
+  double af[DZ_FREQRES_GRID_BLOCK], g[DZ_FREQRES_GRID_BLOCK], p[DZ_FREQRES_GRID_BLOCK], anchor = 0;
+  dzFreqRes fr;
+  int i, j, m;
+
+  /* phase lags on a grid are unwrapped along ascending frequencies,
+   * so that unsorted samples are evaluated one by one. */
+  for( i=1; i<arr->size; i++ )
+    if( arr->f[i] < arr->f[i-1] ) break;
+  if( i < arr->size ){
+    for( i=0; i<arr->size; i++ ){
+      fr.f = arr->f[i]; fr.g = arr->g[i]; fr.p = arr->p[i];
+      _dzFreqResConnectTF( &fr, tf, &fr );
+      arr->g[i] = fr.g;
+      arr->p[i] = fr.p;
+    }
+    return arr;
+  }
+  for( i=0; i<arr->size; i+=m ){
+    m = zMin( arr->size - i, DZ_FREQRES_GRID_BLOCK );
+    for( j=0; j<m; j++ ) af[j] = zPIx2 * arr->f[i+j];
+    /* blocks are unwrapped continuously from the last phase lag */
+    if( !_dzFreqResGridFromTF( tf, af, m, g, p, i > 0 ? &anchor : NULL ) ) return NULL;
+    anchor = p[m-1];
+    for( j=0; j<m; j++ ){
+      arr->g[i+j] += g[j];
+      arr->p[i+j] += p[j];
+    }
+  }
+  return arr;
+}
+
+/* streaming scan of frequency responses */
+
+#define DZ_FREQRES_SCAN_BUFSIZ 65536
+
+#define _dzFreqResScanIsSpace(c) ( (c) == ' ' || (c) == '\t' || (c) == '\n' || (c) == '\r' || (c) == '\v' || (c) == '\f' )
+
+/* powers of ten exactly representable in double precision */
+static const double _dz_freqres_scan_pow10[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/* scan a decimal number. The result is correctly rounded if the mantissa
+ * has at most 15 digits and the decimal exponent is within +-22.
+ * Otherwise, including hexadecimal numbers, strtod() is called. */
+static bool _dzFreqResScanNum(char **str, double *val)
+{
+  char *p, *q;
+  double mant = 0;
+  int digits = 0, e = 0, ee = 0, esign = 1;
+  bool neg = false;
+
+  p = *str;
+  if( *p == '+' || *p == '-' ) neg = ( *p++ == '-' );
+  if( p[0] == '0' && ( p[1] == 'x' || p[1] == 'X' ) ) goto FALLBACK; /* hexadecimal */
+  for( ; *p >= '0' && *p <= '9'; p++, digits++ )
+    mant = mant * 10 + ( *p - '0' );
+  if( *p == '.' )
+    for( p++; *p >= '0' && *p <= '9'; p++, digits++, e-- )
+      mant = mant * 10 + ( *p - '0' );
+  if( digits == 0 ) goto FALLBACK; /* inf, nan, etc. */
+  if( *p == 'e' || *p == 'E' ){
+    p++;
+    if( *p == '+' || *p == '-' ) esign = ( *p++ == '-' ) ? -1 : 1;
+    if( !( *p >= '0' && *p <= '9' ) ) goto FALLBACK;
+    for( ; *p >= '0' && *p <= '9' && ee < 10000; p++ )
+      ee = ee * 10 + ( *p - '0' );
+    if( ee >= 10000 ) goto FALLBACK;
+    e += esign * ee;
+  }
+  if( *p != '\0' && !_dzFreqResScanIsSpace( *p ) ) return false;
+  if( digits > 15 || e < -22 || e > 22 ) goto FALLBACK;
+  *val = e < 0 ? mant / _dz_freqres_scan_pow10[-e] : mant * _dz_freqres_scan_pow10[e];
+  if( neg ) *val = -*val;
+  *str = p;
+  return true;
+
+ FALLBACK:
+  *val = strtod( *str, &q );
+  if( q == *str || ( *q != '\0' && !_dzFreqResScanIsSpace( *q ) ) ) return false;
+  *str = q;
+  return true;
+}
+
+int dzFreqResFScanStream(FILE *fp, double fmin, double fmax, bool (* callback)(dzFreqRes*,void*), void *util)
+{
+  char *buf, *cur, *last;
+  size_t len = 0;
+  double val[3];
+  dzFreqRes fr;
+  int k = 0, count = 0;
+  bool eof = false;
+
+  if( !( buf = zAlloc( char, DZ_FREQRES_SCAN_BUFSIZ+1 ) ) ){
+    ZALLOCERROR();
+    return 0;
+  }
+  while( !eof ){
+    len += fread( buf+len, sizeof(char), DZ_FREQRES_SCAN_BUFSIZ-len, fp );
+    if( len < DZ_FREQRES_SCAN_BUFSIZ ) eof = true;
+    buf[len] = '\0';
+    /* tokens before the last white space are complete */
+    if( eof ) last = buf + len;
+    else{
+      for( last=buf+len; last>buf && !_dzFreqResScanIsSpace( last[-1] ); last-- );
+      if( last == buf ){
+        ZRUNERROR( DZ_ERR_TF_FR_TOOLONGTOKEN );
+        break;
+      }
+    }
+    for( cur=buf; ; ){
+      while( cur < last && _dzFreqResScanIsSpace( *cur ) ) cur++;
+      if( cur >= last ) break;
+      if( !_dzFreqResScanNum( &cur, &val[k] ) ) goto TERMINATE;
+      if( ++k < 3 ) continue;
+      k = 0;
+      if( val[0] < fmin || val[0] > fmax ) continue;
+      fr.f = val[0]; fr.g = val[1]; fr.p = val[2];
+      if( !callback( &fr, util ) ) goto TERMINATE;
+      count++;
+    }
+    len = buf + len - last;
+    memmove( buf, last, len );
+  }
+ TERMINATE:
+  zFree( buf );
+  return count;
+}
+
+int dzFreqResScanFileStream(char filename[], double fmin, double fmax, bool (* callback)(dzFreqRes*,void*), void *util)
+{
+  FILE *fp;
+  int count;
+
+  if( !( fp = fopen( filename, "r" ) ) ){
+    ZOPENERROR( filename );
+    return 0;
+  }
+  count = dzFreqResFScanStream( fp, fmin, fmax, callback, util );
+  fclose( fp );
+  return count;
+}
+
+static bool _dzFreqResArrayScanCallback(dzFreqRes *fr, void *arr)
+{
+  return dzFreqResArrayAdd( (dzFreqResArray *)arr, fr->f, fr->g, fr->p );
+}
+
+int dzFreqResArrayFScan(FILE *fp, dzFreqResArray *arr, double fmin, double fmax)
+{
+  dzFreqResFScanStream( fp, fmin, fmax, _dzFreqResArrayScanCallback, arr );
+  return arr->size;
+}
+
+int dzFreqResArrayFPrint(FILE *fp, dzFreqResArray *arr, double fmin, double fmax)
+{
+  int i, count = 0;
+
+  for( i=0; i<arr->size; i++ ){
+    if( arr->f[i] < fmin || arr->f[i] > fmax ) continue;
+    fprintf( fp, "%.10g %.10g %.10g\n", arr->f[i], arr->g[i], arr->p[i] );
+    count++;
+  }
+  return count;
+}
+
+int dzFreqResArrayScanFile(dzFreqResArray *arr, char filename[], double fmin, double fmax)
+{
+  FILE *fp;
+
+  if( !( fp = fopen( filename, "r" ) ) ){
+    ZOPENERROR( filename );
+    return 0;
+  }
+  dzFreqResArrayFScan( fp, arr, fmin, fmax );
+  fclose( fp );
+  return arr->size;
+}
+
+int dzFreqResArrayPrintFile(dzFreqResArray *arr, char filename[], double fmin, double fmax)
+{
+  FILE *fp;
+  int count;
+
+  if( !( fp = fopen( filename, "w" ) ) ){
+    ZOPENERROR( filename );
+    return 0;
+  }
+  count = dzFreqResArrayFPrint( fp, arr, fmin, fmax );
+  fclose( fp );
+  return count;
 }
 
 /* ********************************************************** */
 /* list of sampled frequency responses
  * ********************************************************** */
 
+int dzFreqResArrayFromList(dzFreqResArray *arr, dzFreqResList *list)
+{
+  dzFreqResListCell *cp;
+
+  if( !dzFreqResArrayReserve( arr, arr->size + zListSize(list) ) ) return arr->size;
+  zListForEach( list, cp )
+    dzFreqResArrayAdd( arr, cp->data.f, cp->data.g, cp->data.p );
+  return arr->size;
+}
+
+int dzFreqResArrayToList(dzFreqResArray *arr, dzFreqResList *list)
+{
+  dzFreqResListCell *cp;
+  int i;
+
+  zListInit( list );
+  for( i=0; i<arr->size; i++ ){
+    if( !( cp = zAlloc( dzFreqResListCell, 1 ) ) ) break;
+    cp->data.f = arr->f[i];
+    cp->data.g = arr->g[i];
+    cp->data.p = arr->p[i];
+    zListInsertHead( list, cp );
+  }
+  return zListSize( list );
+}
+
+/* the list conversions are done cell by cell */
 #define DZ_FREQRESLIST_CONV( __conv ) \
   dzFreqResListCell *cpin, *cpout;\
   zListInit( outlist );\
@@ -140,24 +596,47 @@ int dzFreqResList2Open(dzFreqResList *inlist, dzFreqResList *outlist)
   DZ_FREQRESLIST_CONV( dzFreqRes2Open( &cpin->data, &cpout->data ) );
 }
 
-int dzFreqResListConnectTF(dzFreqResList *inlist, dzTF *tf, dzFreqResList *outlist)
+/* connect a transfer function to unsorted samples one by one */
+static int _dzFreqResListConnectTFEach(dzFreqResList *inlist, dzTF *tf, dzFreqResList *outlist)
 {
   DZ_FREQRESLIST_CONV( _dzFreqResConnectTF( &cpin->data, tf, &cpout->data ) );
 }
 
+int dzFreqResListConnectTF(dzFreqResList *inlist, dzTF *tf, dzFreqResList *outlist)
+{
+  double af[DZ_FREQRES_GRID_BLOCK], g[DZ_FREQRES_GRID_BLOCK], p[DZ_FREQRES_GRID_BLOCK], anchor = 0;
+  dzFreqResListCell *cpin, *cp, *cpout;
+  int j, m;
+
+  zListForEach( inlist, cp )
+    if( cp->next != zListRoot(inlist) && cp->next->data.f < cp->data.f )
+      return _dzFreqResListConnectTFEach( inlist, tf, outlist );
+  zListInit( outlist );
+  /* frequencies are gathered from the list block by block */
+  for( cpin=zListTail(inlist); cpin!=zListRoot(inlist); ){
+    for( m=0, cp=cpin; m<DZ_FREQRES_GRID_BLOCK && cp!=zListRoot(inlist); m++, cp=cp->next )
+      af[m] = zPIx2 * cp->data.f;
+    if( !_dzFreqResGridFromTF( tf, af, m, g, p, cpin != zListTail(inlist) ? &anchor : NULL ) ) break;
+    anchor = p[m-1];
+    for( j=0; j<m; j++, cpin=cpin->next ){
+      if( !( cpout = zAlloc( dzFreqResListCell, 1 ) ) ) return zListSize(outlist);
+      cpout->data.f = cpin->data.f;
+      cpout->data.g = cpin->data.g + g[j];
+      cpout->data.p = cpin->data.p + p[j];
+      zListInsertHead( outlist, cpout );
+    }
+  }
+  return zListSize(outlist);
+}
+
 int dzFreqResListFScan(FILE *fp, dzFreqResList *list, double fmin, double fmax)
 {
-  dzFreqRes fr;
-  dzFreqResListCell *cp;
+  dzFreqResArray arr;
 
-  zListInit( list );
-  while( !feof( fp ) ){
-    if( fscanf( fp, "%lf %lf %lf", &fr.f, &fr.g, &fr.p ) != 3 ) break;
-    if( fr.f < fmin || fr.f > fmax ) continue;
-    if( !( cp = zAlloc( dzFreqResListCell, 1 ) ) ) break;
-    memcpy( &cp->data, &fr, sizeof(dzFreqRes) );
-    zListInsertHead( list, cp );
-  }
+  dzFreqResArrayInit( &arr );
+  dzFreqResArrayFScan( fp, &arr, fmin, fmax );
+  dzFreqResArrayToList( &arr, list );
+  dzFreqResArrayDestroy( &arr );
   return zListSize( list );
 }
 
@@ -276,16 +755,19 @@ static void _dzFreqResIdentDataLSMFree(dzFreqResIdentData *fri)
   zVecFree( fri->xi );
 }
 
-static int _dzFreqResIdentDataRead(dzFreqResIdentData *fri, dzFreqResList *list, int nn, int nd)
+static int _dzFreqResIdentDataRead(dzFreqResIdentData *fri, dzFreqResArray *arr, int nn, int nd)
 {
-  dzFreqResListCell *cp;
+  dzFreqRes fr;
   double omega, omegaj;
   zComplex iomegaj, c;
-  int j, k = 0;
+  int j, k;
 
-  if( !_dzFreqResIdentDataAlloc( fri, nn, nd, zListSize(list) ) ) return 0;
-  zListForEach( list, cp ){
-    dzFreqResToComplex( &cp->data, zCVecElemNC(fri->freq_res,k), &omega );
+  if( !_dzFreqResIdentDataAlloc( fri, nn, nd, arr->size ) ) return 0;
+  for( k=0; k<arr->size; k++ ){
+    fr.f = arr->f[k];
+    fr.g = arr->g[k];
+    fr.p = arr->p[k];
+    dzFreqResToComplex( &fr, zCVecElemNC(fri->freq_res,k), &omega );
     zVecSetElemNC( fri->ang_freq, k, omega );
     zVecSetElemNC( fri->mag, k, 1.0 );
     for( j=0; j<=fri->ndim; j++ ){
@@ -300,7 +782,6 @@ static int _dzFreqResIdentDataRead(dzFreqResIdentData *fri, dzFreqResList *list,
       zVecArrayElem(&fri->fr_re,k,j) = c.re;
       zVecArrayElem(&fri->fr_im,k,j) = c.im;
     }
-    k++;
   }
   return fri->ns;
 }
@@ -346,12 +827,12 @@ static void _dzFreqResIdentDataUpdateMag(dzFreqResIdentData *fri)
   }
 }
 
-static bool _dzFreqResIdent(dzFreqResIdentData *fri, dzFreqResList *list, int nn, int nd, int iter)
+static bool _dzFreqResIdent(dzFreqResIdentData *fri, dzFreqResArray *arr, int nn, int nd, int iter)
 {
   double dist, dist_prev;
   int i;
 
-  if( _dzFreqResIdentDataRead( fri, list, nn, nd ) == 0 ) return false;
+  if( _dzFreqResIdentDataRead( fri, arr, nn, nd ) == 0 ) return false;
   if( !_dzFreqResIdentDataLSMAlloc( fri ) ) return false;
   ZITERINIT( iter );
   zVecSetAll( fri->phi_prev, HUGE_VAL );
@@ -368,12 +849,12 @@ static bool _dzFreqResIdent(dzFreqResIdentData *fri, dzFreqResList *list, int nn
   return true;
 }
 
-dzTF *dzTFIdentFromFreqRes(dzTF *tf, dzFreqResList *list, int nn, int nd, int iter)
+dzTF *dzTFIdentFromFreqResArray(dzTF *tf, dzFreqResArray *arr, int nn, int nd, int iter)
 {
   dzFreqResIdentData fri;
   int i;
 
-  if( !_dzFreqResIdent( &fri, list, nn, nd, iter ) ) return NULL;
+  if( !_dzFreqResIdent( &fri, arr, nn, nd, iter ) ) return NULL;
   if( !dzTFAlloc( tf, nn, nd ) ) return NULL;
   for( i=0; i<=fri.nn; i++ )
     zPexSetCoeff( dzTFNum(tf), i, zVecElemNC(fri.phi,i) );
@@ -383,3 +864,14 @@ dzTF *dzTFIdentFromFreqRes(dzTF *tf, dzFreqResList *list, int nn, int nd, int it
   _dzFreqResIdentDataFree( &fri );
   return tf;
 }
+
+dzTF *dzTFIdentFromFreqRes(dzTF *tf, dzFreqResList *list, int nn, int nd, int iter)
+{
+  dzFreqResArray arr;
+
+  dzFreqResArrayInit( &arr );
+  dzFreqResArrayFromList( &arr, list );
+  tf = dzTFIdentFromFreqResArray( tf, &arr, nn, nd, iter );
+  dzFreqResArrayDestroy( &arr );
+  return tf;
+}
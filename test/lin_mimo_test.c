@@ -0,0 +1,136 @@
+#include <dzco/dz_sys.h>
+
+#define N 10
+
+void assert_lqr(void)
+{
+  dzLin siso;
+  dzLinMIMO mimo;
+  zVec q, r, f_siso;
+  zMat f_mimo, p, e;
+  int i;
+  bool result = true;
+
+  /* single-input case compared with dzLinLQR */
+  dzLinAlloc( &siso, 2 );
+  zMatSetElem( siso.a, 0, 1, 1 );
+  zVecSetElem( siso.b, 1, 1 );
+  zVecSetElem( siso.c, 0, 1 );
+  dzLin2LinMIMO( &siso, &mimo );
+  q = zVecAlloc( 2 );
+  r = zVecAlloc( 1 );
+  f_siso = zVecAlloc( 2 );
+  f_mimo = zMatAlloc( 1, 2 );
+  for( i=0; i<N; i++ ){
+    zVecSetElemList( q, 1.0, zRandF(zTOL,10) );
+    zVecSetElem( r, 0, zRandF(zTOL,10) );
+    if( !dzLinLQR( &siso, q, zVecElem(r,0), f_siso ) ||
+        !dzLinMIMOLQR( &mimo, q, r, f_mimo ) ||
+        !zIsTol( zMatElemNC(f_mimo,0,0) - zVecElemNC(f_siso,0), zTOL*10 ) ||
+        !zIsTol( zMatElemNC(f_mimo,0,1) - zVecElemNC(f_siso,1), zTOL*10 ) ) result = false;
+  }
+  dzLinDestroy( &siso );
+  dzLinMIMODestroy( &mimo );
+  zVecFree( q );
+  zVecFree( r );
+  zVecFree( f_siso );
+  zMatFree( f_mimo );
+  /* multi-input case */
+  dzLinMIMOAlloc( &mimo, 4, 2, 2 );
+  zMatSetElem( mimo.a, 0, 1, 1 );
+  zMatSetElem( mimo.a, 2, 3, 1 );
+  zMatSetElem( mimo.a, 1, 2, 0.5 );
+  zMatSetElem( mimo.b, 1, 0, 1 );
+  zMatSetElem( mimo.b, 3, 1, 1 );
+  q = zVecCreateList( 4, 1.0, 0.5, 2.0, 0.1 );
+  r = zVecCreateList( 2, 0.5, 2.0 );
+  f_mimo = zMatAlloc( 2, 4 );
+  p = zMatAllocSqr( 4 );
+  e = zMatAllocSqr( 4 );
+  zMatDiag( e, q );
+  if( !dzLinMIMORiccatiSolveKleinman( p, f_mimo, &mimo, e, r, zTOL, 0 ) ||
+      dzLinMIMORiccatiError( p, &mimo, e, r, NULL ) > zTOL*100 ) result = false;
+  zAssert( dzLinMIMOLQR, result );
+  dzLinMIMODestroy( &mimo );
+  zVecFree( q );
+  zVecFree( r );
+  zMatFreeAtOnce( 3, f_mimo, p, e );
+}
+
+void assert_obs(void)
+{
+  dzLinMIMO mimo;
+  zVec pole;
+  zMat k, akc;
+  bool result = true;
+
+  dzLinMIMOAlloc( &mimo, 2, 1, 2 );
+  zMatSetElemList( mimo.a, 0.0, 1.0, -2.0, -0.5 );
+  zMatSetElem( mimo.b, 1, 0, 1 );
+  zMatSetElemList( mimo.c, 1.0, 0.0, 0.0, 1.0 );
+  pole = zVecCreateList( 2, -3.0, -4.0 );
+  k = zMatAlloc( 2, 2 );
+  akc = zMatAllocSqr( 2 );
+  if( !dzLinMIMOCreateObs( &mimo, pole, k ) ) result = false;
+  /* the characteristic polynomial of A - K C is s^2 + 7 s + 12 */
+  zMulMatMat( k, mimo.c, akc );
+  zMatSub( mimo.a, akc, akc );
+  if( !zIsTol( zMatTrace(akc) + 7, zTOL*10 ) || !zIsTol( zMatDet(akc) - 12, zTOL*10 ) ) result = false;
+  zAssert( dzLinMIMOCreateObs, result );
+  dzLinMIMODestroy( &mimo );
+  zVecFree( pole );
+  zMatFreeAtOnce( 2, k, akc );
+}
+
+#define DT   0.001
+#define STEP 1000
+
+void assert_sys(void)
+{
+  dzSys sys;
+  dzLinMIMO *mimo;
+  dzLin siso[2];
+  double u[2], y;
+  int i, j;
+  bool result = true;
+
+  /* two decoupled single-input single-output systems */
+  for( j=0; j<2; j++ ){
+    dzLinAlloc( &siso[j], 1 );
+    zMatSetElem( siso[j].a, 0, 0, -(j+1) );
+    zVecSetElem( siso[j].b, 0, j+1 );
+    zVecSetElem( siso[j].c, 0, 2 );
+    siso[j].d = 0.5*(j+1);
+  }
+  mimo = zAlloc( dzLinMIMO, 1 );
+  dzLinMIMOAlloc( mimo, 2, 2, 2 );
+  for( j=0; j<2; j++ ){
+    zMatSetElem( mimo->a, j, j, -(j+1) );
+    zMatSetElem( mimo->b, j, j, j+1 );
+    zMatSetElem( mimo->c, j, j, 2 );
+    zMatSetElem( mimo->d, j, j, 0.5*(j+1) );
+  }
+  dzSysLinMIMOCreate( &sys, mimo );
+  for( j=0; j<2; j++ ) dzSysInputPtr(&sys,j) = &u[j];
+  for( i=0; i<STEP; i++ ){
+    for( j=0; j<2; j++ ) u[j] = zRandF(-1,1);
+    dzSysUpdate( &sys, DT );
+    for( j=0; j<2; j++ ){
+      dzLinStateUpdate( &siso[j], u[j], DT );
+      y = dzLinOutput( &siso[j], u[j] );
+      if( !zIsTiny( dzSysOutputVal(&sys,j) - y ) ) result = false;
+    }
+  }
+  zAssert( dzSysLinMIMOCreate, result );
+  dzSysDestroy( &sys );
+  for( j=0; j<2; j++ ) dzLinDestroy( &siso[j] );
+}
+
+int main(void)
+{
+  zRandInit();
+  assert_lqr();
+  assert_obs();
+  assert_sys();
+  return EXIT_SUCCESS;
+}
@@ -103,16 +103,121 @@ void assert_lqr(void)
     }
   }
   zAssert( dzLinLQR, result );
+  for( i=0; i<N; i++ ){
+    q2 = zRandF( zTOL, 10 );
+    r = zRandF( zTOL, 10 );
+    zVecSetElemList( q, 1.0, q2 );
+    if( !dzLinLQRMethod( dzSysLin(&sys), q, r, opt_gain, DZ_RICCATI_SIGN ) ) exit( 1 );
+    if( !zIsTol( zVecElemNC(opt_gain,0) - 1.0/sqrt(r), zTOL*100 ) ||
+        !zIsTol( zVecElemNC(opt_gain,1) - sqrt(2*sqrt(r)+q2)/sqrt(r), zTOL*100 ) ){
+      result = false;
+      break;
+    }
+  }
+  zAssert( dzLinLQRMethod (sign function), result );
 
   zVecFree( q );
   zVecFree( opt_gain );
   dzSysDestroy( &sys );
 }
 
+#define DT 0.001
+
+void assert_zoh(void)
+{
+  dzLin lin_rkg, lin_zoh;
+  double u;
+  int i;
+  bool result = true;
+
+  dzLinAlloc( &lin_rkg, 2 );
+  zMatSetElemList( lin_rkg.a, 0.0, 1.0, -4.0, -0.4 );
+  zVecSetElemList( lin_rkg.b, 0.0, 1.0 );
+  zVecSetElemList( lin_rkg.c, 1.0, 0.0 );
+  dzLinAlloc( &lin_zoh, 2 );
+  zMatCopy( lin_rkg.a, lin_zoh.a );
+  zVecCopy( lin_rkg.b, lin_zoh.b );
+  zVecCopy( lin_rkg.c, lin_zoh.c );
+  dzLinSetZOH( &lin_zoh );
+  for( i=0; i<N*10; i++ ){
+    u = zRandF(-1,1);
+    dzLinStateUpdate( &lin_rkg, u, DT );
+    dzLinStateUpdate( &lin_zoh, u, DT );
+    if( !zVecIsEqual( lin_rkg.x, lin_zoh.x, 1e-10 ) ) result = false;
+  }
+  /* step response of a first-order system */
+  zMatSetElemList( lin_zoh.a, -2.0, 0.0, 0.0, -2.0 );
+  zVecZero( lin_zoh.x );
+  for( i=1; i<=N; i++ ){
+    dzLinStateUpdate( &lin_zoh, 1.0, DT );
+    if( !zIsTiny( zVecElemNC(lin_zoh.x,1) - 0.5*( 1 - exp(-2*DT*i) ) ) ) result = false;
+  }
+  zAssert( dzLinSetZOH, result );
+  dzLinDestroy( &lin_rkg );
+  dzLinDestroy( &lin_zoh );
+}
+
+zVec gain_linear(double s, void *util, zVec f)
+{
+  return zVecSetElemList( f, s, 2*s*s );
+}
+
+void assert_dlqr(void)
+{
+  dzLin lin;
+  dzLinGainTable tab;
+  zVec q, f;
+  double a, r, dt, phi, gamma, b, p;
+  int i;
+  bool result = true;
+
+  dzLinAlloc( &lin, 1 );
+  q = zVecAlloc( 1 );
+  f = zVecAlloc( 1 );
+  for( i=0; i<N; i++ ){
+    a = zRandF(-2,2);
+    dt = zRandF(0.001,0.1);
+    r = zRandF(0.1,10);
+    zMatSetElem( lin.a, 0, 0, a );
+    zVecSetElem( lin.b, 0, 1 );
+    zVecSetElem( q, 0, zRandF(0.1,10) );
+    if( !dzLinDLQR( &lin, q, r, dt, f ) ){
+      result = false;
+      break;
+    }
+    /* analytical solution of scalar discrete-time Riccati equation */
+    phi = exp( a*dt );
+    gamma = ( phi - 1 ) / a;
+    b = r - zVecElem(q,0)*gamma*gamma - phi*phi*r;
+    p = ( -b + sqrt( b*b + 4*gamma*gamma*zVecElem(q,0)*r ) ) / ( 2*gamma*gamma );
+    if( !zIsTol( zVecElemNC(f,0) - gamma*p*phi/( r + gamma*gamma*p ), zTOL*100 ) ) result = false;
+  }
+  zAssert( dzLinDLQR, result );
+  dzLinDestroy( &lin );
+  zVecFree( q );
+  zVecFree( f );
+
+  result = true;
+  f = zVecAlloc( 2 );
+  dzLinGainTableCreate( &tab, -1, 1, 201, 2, gain_linear, NULL );
+  for( i=0; i<N; i++ ){
+    a = zRandF(-1,1);
+    dzLinGainTableInterp( &tab, a, f );
+    if( !zIsTiny( zVecElemNC(f,0) - a ) || !zIsTol( zVecElemNC(f,1) - 2*a*a, 1.0e-4 ) ) result = false;
+  }
+  dzLinGainTableInterp( &tab, 2, f );
+  if( !zIsTiny( zVecElemNC(f,0) - 1 ) ) result = false;
+  zAssert( dzLinGainTableInterp, result );
+  dzLinGainTableDestroy( &tab );
+  zVecFree( f );
+}
+
 int main(void)
 {
   zRandInit();
   assert_co();
   assert_lqr();
+  assert_zoh();
+  assert_dlqr();
   return EXIT_SUCCESS;
 }
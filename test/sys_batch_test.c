@@ -0,0 +1,77 @@
+#include <dzco/dz_sys.h>
+
+#define DT     0.01
+#define STEP 200
+#define N      5
+
+bool assert_batch(dzSysBatchKind kind)
+{
+  double u[N];
+  dzSys batch, single[N];
+  int i, j;
+  bool result = true;
+
+  dzSysBatchCreate( &batch, kind, N );
+  for( j=0; j<N; j++ ){
+    switch( kind ){
+    case DZ_SYS_BATCH_FOL:
+      dzSysBatchSetFOL( &batch, j, 0.1*(j+1), j+1 );
+      dzSysFOLCreate( &single[j], 0.1*(j+1), j+1 );
+      break;
+    case DZ_SYS_BATCH_SOL:
+      dzSysBatchSetSOL( &batch, j, 0.1*(j+1), 0.01*j, 0.2*(j+1), j+1 );
+      dzSysSOLCreate( &single[j], 0.1*(j+1), 0.01*j, 0.2*(j+1), j+1 );
+      break;
+    case DZ_SYS_BATCH_PC:
+      dzSysBatchSetPC( &batch, j, 0.1*(j+1), 0.05*j, j+1 );
+      dzSysPCCreate( &single[j], 0.1*(j+1), 0.05*j, j+1 );
+      break;
+    case DZ_SYS_BATCH_MAF:
+      dzSysBatchSetMAF( &batch, j, 0.1*(j+1) );
+      dzSysMAFCreate( &single[j], 0.1*(j+1) );
+      break;
+    case DZ_SYS_BATCH_I:
+      dzSysBatchSetI( &batch, j, j+1, 0.01*j );
+      dzSysICreate( &single[j], j+1, 0.01*j );
+      break;
+    case DZ_SYS_BATCH_P:
+      dzSysBatchSetP( &batch, j, j+1 );
+      dzSysPCreate( &single[j], j+1 );
+      break;
+    case DZ_SYS_BATCH_D:
+      dzSysBatchSetD( &batch, j, j+1, 0.01*(j+1) );
+      dzSysDCreate( &single[j], j+1, 0.01*(j+1) );
+      break;
+    case DZ_SYS_BATCH_PID:
+      dzSysBatchSetPID( &batch, j, j+1, 0.5*j, 0.1*j, 0.01*(j+1), 0.01*j );
+      dzSysPIDCreate( &single[j], j+1, 0.5*j, 0.1*j, 0.01*(j+1), 0.01*j );
+      break;
+    default: ;
+    }
+    dzSysInputPtr(&batch,j) = &u[j];
+    dzSysInputPtr(&single[j],0) = &u[j];
+  }
+  for( i=0; i<=STEP; i++ ){
+    for( j=0; j<N; j++ ) u[j] = zRandF(-10,10);
+    dzSysUpdate( &batch, DT );
+    for( j=0; j<N; j++ )
+      if( !zIsTiny( dzSysOutputVal(&batch,j) - zVecElem(dzSysUpdate(&single[j],DT),0) ) ) result = false;
+  }
+  dzSysDestroy( &batch );
+  for( j=0; j<N; j++ ) dzSysDestroy( &single[j] );
+  return result;
+}
+
+int main(void)
+{
+  zRandInit();
+  zAssert( dzSysBatchCreate (first-order-lag), assert_batch( DZ_SYS_BATCH_FOL ) );
+  zAssert( dzSysBatchCreate (second-order-lag), assert_batch( DZ_SYS_BATCH_SOL ) );
+  zAssert( dzSysBatchCreate (phase compensator), assert_batch( DZ_SYS_BATCH_PC ) );
+  zAssert( dzSysBatchCreate (moving-average filter), assert_batch( DZ_SYS_BATCH_MAF ) );
+  zAssert( dzSysBatchCreate (integrator), assert_batch( DZ_SYS_BATCH_I ) );
+  zAssert( dzSysBatchCreate (amplifier), assert_batch( DZ_SYS_BATCH_P ) );
+  zAssert( dzSysBatchCreate (differentiator), assert_batch( DZ_SYS_BATCH_D ) );
+  zAssert( dzSysBatchCreate (PID controller), assert_batch( DZ_SYS_BATCH_PID ) );
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+#include <dzco/dz_sys.h>
+
+#define DT   0.001
+#define STEP 500
+
+void create_sys(dzSysArray *arr)
+{
+  dzTF *tf;
+
+  dzSysArrayAlloc( arr, 5 );
+  dzSysSineCreate( zArrayElemNC(arr,0), 1, 0, 0.1 );
+  dzSysFOLCreate( zArrayElemNC(arr,1), 0.05, 2 );
+  tf = zAlloc( dzTF, 1 );
+  dzTFAlloc( tf, 1, 2 );
+  dzTFSetNumElem( tf, 0, 1 ); dzTFSetNumElem( tf, 1, 0.1 );
+  dzTFSetDenElem( tf, 0, 1 ); dzTFSetDenElem( tf, 1, 0.4 ); dzTFSetDenElem( tf, 2, 0.02 );
+  dzSysTFCreate( zArrayElemNC(arr,2), tf );
+  dzSysBWCreate( zArrayElemNC(arr,3), 10, 3 );
+  dzSysBatchCreate( zArrayElemNC(arr,4), DZ_SYS_BATCH_FOL, 2 );
+  dzSysBatchSetFOL( zArrayElemNC(arr,4), 0, 0.1, 1 );
+  dzSysBatchSetFOL( zArrayElemNC(arr,4), 1, 0.2, 3 );
+  zNameSet( zArrayElemNC(arr,0), "input" );
+  zNameSet( zArrayElemNC(arr,4), "output" );
+  dzSysConnect( zArrayElemNC(arr,0), 0, zArrayElemNC(arr,1), 0 );
+  dzSysConnect( zArrayElemNC(arr,1), 0, zArrayElemNC(arr,2), 0 );
+  dzSysConnect( zArrayElemNC(arr,2), 0, zArrayElemNC(arr,3), 0 );
+  dzSysConnect( zArrayElemNC(arr,0), 0, zArrayElemNC(arr,4), 0 );
+  dzSysConnect( zArrayElemNC(arr,3), 0, zArrayElemNC(arr,4), 1 );
+}
+
+bool check_sys(dzSysArray *arr1, dzSysArray *arr2)
+{
+  dzSysPlan plan1, plan2;
+  int i, j, k;
+  bool result = true;
+
+  if( zArraySize(arr1) != zArraySize(arr2) ) return false;
+  dzSysPlanCreate( &plan1, arr1 );
+  dzSysPlanCreate( &plan2, arr2 );
+  for( i=0; i<STEP; i++ ){
+    dzSysPlanUpdate( &plan1, DT );
+    dzSysPlanUpdate( &plan2, DT );
+    for( j=0; j<zArraySize(arr1); j++ )
+      for( k=0; k<dzSysOutputNum(zArrayElemNC(arr1,j)); k++ )
+        if( dzSysOutputVal(zArrayElemNC(arr1,j),k) != dzSysOutputVal(zArrayElemNC(arr2,j),k) ) result = false;
+  }
+  dzSysPlanDestroy( &plan1 );
+  dzSysPlanDestroy( &plan2 );
+  return result;
+}
+
+void assert_encode(void)
+{
+  dzSysArray arr1, arr2;
+  dzSysPlan plan;
+  dzSysBin bin;
+  int i;
+  bool result;
+
+  create_sys( &arr1 );
+  dzSysBinInit( &bin );
+  /* initial state */
+  result = dzSysArrayEncode( &arr1, &bin, false ) && dzSysArrayDecode( &arr2, &bin ) &&
+    strcmp( zName(zArrayElemNC(&arr2,4)), "output" ) == 0 &&
+    check_sys( &arr1, &arr2 );
+  zAssert( dzSysArrayEncode + dzSysArrayDecode, result );
+  dzSysArrayDestroy( &arr2 );
+  dzSysBinDestroy( &bin );
+  /* intermediate state */
+  dzSysPlanCreate( &plan, &arr1 );
+  for( i=0; i<STEP; i++ )
+    dzSysPlanUpdate( &plan, DT );
+  dzSysPlanDestroy( &plan );
+  result = dzSysArrayEncode( &arr1, &bin, true ) && dzSysArrayDecode( &arr2, &bin ) &&
+    check_sys( &arr1, &arr2 );
+  zAssert( dzSysArrayEncode (state), result );
+  dzSysArrayDestroy( &arr2 );
+  dzSysBinDestroy( &bin );
+  /* broken image */
+  dzSysArrayEncode( &arr1, &bin, true );
+  bin.size /= 2;
+  zAssert( dzSysArrayDecode (broken), !dzSysArrayDecode( &arr2, &bin ) );
+  dzSysBinDestroy( &bin );
+  dzSysArrayDestroy( &arr1 );
+}
+
+int main(void)
+{
+  assert_encode();
+  return EXIT_SUCCESS;
+}
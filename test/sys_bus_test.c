@@ -0,0 +1,86 @@
+#include <dzco/dz_sys.h>
+
+#define DT   0.001
+#define STEP 500
+
+/* systems declared in the reverse order of signal flow */
+void create_sys(dzSysArray *arr)
+{
+  dzSysArrayAlloc( arr, 5 );
+  dzSysFOLCreate( zArrayElemNC(arr,0), 0.1, 1 );
+  dzSysPIDCreate( zArrayElemNC(arr,1), 2, 1, 0.1, 0.01, 1 );
+  dzSysBWMultiCreate( zArrayElemNC(arr,2), 20, 3, 2 );
+  dzSysSineCreate( zArrayElemNC(arr,3), 1, 0, 0.1 );
+  dzSysStepCreate( zArrayElemNC(arr,4), 1, 0.1, HUGE_VAL );
+  dzSysConnect( zArrayElemNC(arr,3), 0, zArrayElemNC(arr,2), 0 );
+  dzSysConnect( zArrayElemNC(arr,4), 0, zArrayElemNC(arr,2), 1 );
+  dzSysConnect( zArrayElemNC(arr,2), 0, zArrayElemNC(arr,0), 0 );
+  dzSysConnect( zArrayElemNC(arr,2), 1, zArrayElemNC(arr,1), 0 );
+}
+
+bool check_layout(dzSysBus *bus, dzSysPlan *plan, dzSysArray *arr)
+{
+  dzSys *sys;
+  int k, offset = 0;
+
+  if( (size_t)dzSysBusBuf(bus) % DZ_SYS_BUS_ALIGN != 0 || dzSysBusSize(bus) != 6 ) return false;
+  for( k=0; k<dzSysPlanNum(plan); k++ ){
+    sys = dzSysPlanSys(plan,k);
+    if( dzSysBusOffset(bus,sys-zArrayBuf(arr)) != offset ||
+        zVecBufNC(dzSysOutput(sys)) != dzSysBusBuf(bus) + offset ) return false;
+    offset += dzSysOutputNum(sys);
+  }
+  return true;
+}
+
+bool check_port(dzSysArray *arr)
+{
+  dzSys *sys;
+  int i, k;
+
+  for( i=0; i<zArraySize(arr); i++ ){
+    sys = zArrayElemNC(arr,i);
+    for( k=0; k<dzSysInputNum(sys); k++ )
+      if( dzSysInputPtr(sys,k) != &dzSysOutputVal(dzSysInputElem(sys,k)->sp,dzSysInputElem(sys,k)->port) ) return false;
+  }
+  return true;
+}
+
+int main(void)
+{
+  dzSysArray arr, ref;
+  dzSysPlan plan, refplan;
+  dzSysBus bus;
+  double sig[6];
+  int i, j, k;
+  bool result = true, result_copy = true;
+
+  create_sys( &arr );
+  create_sys( &ref );
+  dzSysPlanCreate( &plan, &arr );
+  dzSysPlanCreate( &refplan, &ref );
+  dzSysBusCreate( &bus, &plan );
+  zAssert( dzSysBusCreate, check_layout( &bus, &plan, &arr ) && check_port( &arr ) );
+  for( i=0; i<STEP; i++ ){
+    dzSysPlanUpdate( &plan, DT );
+    dzSysPlanUpdate( &refplan, DT );
+    dzSysBusCopy( &bus, sig );
+    for( j=0; j<zArraySize(&arr); j++ )
+      for( k=0; k<dzSysOutputNum(zArrayElemNC(&arr,j)); k++ ){
+        if( dzSysOutputVal(zArrayElemNC(&arr,j),k) != dzSysOutputVal(zArrayElemNC(&ref,j),k) ) result = false;
+        if( sig[dzSysBusOffset(&bus,j)+k] != dzSysOutputVal(zArrayElemNC(&ref,j),k) ) result_copy = false;
+      }
+  }
+  zAssert( dzSysPlanUpdate (on bus), result );
+  zAssert( dzSysBusCopy, result_copy );
+  dzSysBusDestroy( &bus );
+  for( j=0; j<zArraySize(&arr); j++ )
+    for( k=0; k<dzSysOutputNum(zArrayElemNC(&arr,j)); k++ )
+      if( dzSysOutputVal(zArrayElemNC(&arr,j),k) != dzSysOutputVal(zArrayElemNC(&ref,j),k) ) result = false;
+  zAssert( dzSysBusDestroy, result && check_port( &arr ) );
+  dzSysPlanDestroy( &plan );
+  dzSysPlanDestroy( &refplan );
+  dzSysArrayDestroy( &arr );
+  dzSysArrayDestroy( &ref );
+  return EXIT_SUCCESS;
+}
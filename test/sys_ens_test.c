@@ -0,0 +1,56 @@
+#include <dzco/dz_sys.h>
+
+#define N    100
+#define STEP 1000
+#define DT   0.01
+
+bool perturb_gain(dzSysArray *arr, int k, void *util)
+{
+  return dzSysPerturbPrp( zArrayElemNC(arr,1), 1, *(double*)util );
+}
+
+bool perturb_tc(dzSysArray *arr, int k, void *util)
+{
+  ((double*)zArrayElemNC(arr,1)->prp)[0] *= 1 + 0.01*k;
+  return true;
+}
+
+int main(void)
+{
+  dzSysArray arr;
+  dzSysEns ens, ens2;
+  double ratio = 0.2;
+  int k;
+  bool result = true;
+
+  zRandInit();
+  dzSysArrayAlloc( &arr, 2 );
+  dzSysStepCreate( zArrayElemNC(&arr,0), 1, 0, HUGE_VAL );
+  dzSysFOLCreate( zArrayElemNC(&arr,1), 0.1, 1 );
+  dzSysConnect( zArrayElemNC(&arr,0), 0, zArrayElemNC(&arr,1), 0 );
+  dzSysEnsCreate( &ens, &arr, N, perturb_gain, &ratio );
+  /* the first-order lag converges to its own perturbed gain */
+  dzSysEnsRun( &ens, 1, DT, STEP, 1 );
+  for( k=0; k<N; k++ ){
+    if( !zIsTol( dzSysEnsFinal(&ens,k,0) - ((double*)zArrayElemNC(dzSysEnsInstance(&ens,k),1)->prp)[1], zTOL ) ||
+        !zIsTiny( dzSysEnsPeak(&ens,k,0) - dzSysEnsFinal(&ens,k,0) ) ||
+        dzSysEnsISE(&ens,k,0) <= 0 ) result = false;
+  }
+  if( !zIsTiny( ((double*)zArrayElemNC(&arr,1)->prp)[1] - 1 ) ) result = false;
+  zAssert( dzSysEnsRun, result );
+  dzSysEnsDestroy( &ens );
+  /* multithreading does not change the results */
+  dzSysEnsCreate( &ens, &arr, N, perturb_tc, NULL );
+  dzSysEnsCreate( &ens2, &arr, N, perturb_tc, NULL );
+  dzSysEnsRun( &ens, 1, DT, STEP/10, 1 );
+  dzSysEnsRun( &ens2, 1, DT, STEP/10, 0 );
+  for( result=true, k=0; k<N; k++ )
+    if( dzSysEnsFinal(&ens,k,0) != dzSysEnsFinal(&ens2,k,0) ||
+        dzSysEnsPeak(&ens,k,0) != dzSysEnsPeak(&ens2,k,0) ||
+        dzSysEnsISE(&ens,k,0) != dzSysEnsISE(&ens2,k,0) ) result = false;
+  zAssert( dzSysEnsRun (multithread), result );
+  dzSysEnsDestroy( &ens );
+  dzSysEnsDestroy( &ens2 );
+  dzSysArrayDestroy( &arr );
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,41 @@
+#include <dzco/dz_sys.h>
+
+#define DT     0.001
+#define STEP 500
+#define N     11
+/* tolerance of vectorized channels relative to one plus the output */
+#define TOL  1.0e-10
+
+bool assert_bw_multi(uint dim)
+{
+  double u[N], y;
+  dzSys multi, single[N];
+  int i, j;
+  bool result = true;
+
+  dzSysBWMultiCreate( &multi, 20, dim, N );
+  for( j=0; j<N; j++ ){
+    dzSysBWCreate( &single[j], 20, dim );
+    dzSysInputPtr(&multi,j) = &u[j];
+    dzSysInputPtr(&single[j],0) = &u[j];
+  }
+  for( i=0; i<=STEP; i++ ){
+    for( j=0; j<N; j++ ) u[j] = zRandF(-10,10);
+    dzSysUpdate( &multi, DT );
+    for( j=0; j<N; j++ ){
+      y = zVecElem( dzSysUpdate(&single[j],DT), 0 );
+      if( fabs( dzSysOutputVal(&multi,j) - y ) > TOL * ( 1 + fabs( y ) ) ) result = false;
+    }
+  }
+  dzSysDestroy( &multi );
+  for( j=0; j<N; j++ ) dzSysDestroy( &single[j] );
+  return result;
+}
+
+int main(void)
+{
+  zRandInit();
+  zAssert( dzSysBWMultiCreate (odd order), assert_bw_multi( 3 ) );
+  zAssert( dzSysBWMultiCreate (even order), assert_bw_multi( 4 ) );
+  return EXIT_SUCCESS;
+}
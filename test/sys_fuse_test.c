@@ -0,0 +1,69 @@
+#include <dzco/dz_sys.h>
+
+#define DT   0.0001
+#define STEP 10000
+#define TOL  1.0e-2
+
+void create_sys(dzSysArray *arr)
+{
+  dzLin *lin;
+  dzTF *tf;
+
+  dzSysArrayAlloc( arr, 7 );
+  dzSysStepCreate( zArrayElemNC(arr,0), 1, 0, 0 );
+  dzSysPCreate( zArrayElemNC(arr,1), 2 );
+  dzSysFOLCreate( zArrayElemNC(arr,2), 0.1, 1 );
+  zNameSet( zArrayElemNC(arr,2), "probe" );
+  dzSysSOLCreate( zArrayElemNC(arr,3), 0.05, 0.01, 0.7, 1 );
+  lin = zAlloc( dzLin, 1 );
+  dzLinAlloc( lin, 2 );
+  zMatSetElemNC( lin->a, 0, 1, 1 );
+  zMatSetElemNC( lin->a, 1, 0, -100 ); zMatSetElemNC( lin->a, 1, 1, -10 );
+  zVecSetElemNC( lin->b, 1, 100 );
+  zVecSetElemNC( lin->c, 0, 1 );
+  dzSysLinCreate( zArrayElemNC(arr,4), lin );
+  tf = zAlloc( dzTF, 1 );
+  dzTFAlloc( tf, 0, 2 );
+  dzTFSetNumElem( tf, 0, 1 );
+  dzTFSetDenElem( tf, 0, 1 ); dzTFSetDenElem( tf, 1, 0.4 ); dzTFSetDenElem( tf, 2, 0.02 );
+  dzSysTFCreate( zArrayElemNC(arr,5), tf );
+  dzSysAdderCreate( zArrayElemNC(arr,6), 2 );
+  dzSysChain( 6, zArrayElemNC(arr,0), zArrayElemNC(arr,1), zArrayElemNC(arr,2), zArrayElemNC(arr,3), zArrayElemNC(arr,4), zArrayElemNC(arr,5) );
+  dzSysConnect( zArrayElemNC(arr,0), 0, zArrayElemNC(arr,6), 0 );
+  dzSysConnect( zArrayElemNC(arr,5), 0, zArrayElemNC(arr,6), 1 );
+}
+
+int main(void)
+{
+  dzSysArray arr, arr2;
+  dzSysPlan plan, plan2;
+  char *probe[] = { "probe" };
+  int i;
+  bool result = true;
+
+  create_sys( &arr );
+  create_sys( &arr2 );
+  dzSysPlanCreate( &plan, &arr );
+  dzSysPlanCreate( &plan2, &arr2 );
+  /* amplifier to first-order lag, and second-order lag to transfer function */
+  zAssert( dzSysPlanFuse, dzSysPlanFuse( &plan, 1, probe ) == 2 && dzSysPlanNum(&plan) == 4 );
+  for( i=0; i<STEP; i++ ){
+    dzSysPlanUpdate( &plan, DT );
+    dzSysPlanUpdate( &plan2, DT );
+    if( fabs( dzSysOutputVal(zArrayElemNC(&arr,2),0) - dzSysOutputVal(zArrayElemNC(&arr2,2),0) ) > TOL ||
+        fabs( dzSysOutputVal(zArrayElemNC(&arr,6),0) - dzSysOutputVal(zArrayElemNC(&arr2,6),0) ) > TOL )
+      result = false;
+  }
+  zAssert( dzSysPlanFuse (outputs), result );
+  dzSysPlanUnfuse( &plan );
+  zAssert( dzSysPlanUnfuse,
+    dzSysPlanNum(&plan) == 7 &&
+    zArrayElemNC(&arr,2)->com == &dz_sys_fol_com &&
+    zArrayElemNC(&arr,5)->com == &dz_sys_tf_com &&
+    dzSysInputElem(zArrayElemNC(&arr,5),0)->sp == zArrayElemNC(&arr,4) );
+  dzSysPlanDestroy( &plan );
+  dzSysPlanDestroy( &plan2 );
+  dzSysArrayDestroy( &arr );
+  dzSysArrayDestroy( &arr2 );
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#include <dzco/dz_sys.h>
+
+#define W    8
+#define DT   0.001
+#define STEP 500
+
+/* a feedback loop of a PID controller and a plant */
+void create_loop(dzSysArray *arr)
+{
+  dzSysArrayAlloc( arr, 5 );
+  dzSysStepCreate( zArrayElemNC(arr,0), 1, 0, HUGE_VAL );
+  dzSysSubtrCreate( zArrayElemNC(arr,1), 2 );
+  dzSysPIDCreate( zArrayElemNC(arr,2), 1, 0.5, 0.01, 0.01, 0 );
+  dzSysSOLCreate( zArrayElemNC(arr,3), 0.1, 0, 0.5, 1 );
+  dzSysICreate( zArrayElemNC(arr,4), 10, 0 );
+  dzSysChain( 4, zArrayElemNC(arr,0), zArrayElemNC(arr,1), zArrayElemNC(arr,2), zArrayElemNC(arr,3) );
+  dzSysConnect( zArrayElemNC(arr,3), 0, zArrayElemNC(arr,4), 0 );
+  dzSysConnect( zArrayElemNC(arr,4), 0, zArrayElemNC(arr,1), 1 );
+}
+
+int main(void)
+{
+  dzSysArray arr, lanes, single[W];
+  dzSysPlan plan, plan_single[W];
+  int i, j, l;
+  bool result = true;
+
+  create_loop( &arr );
+  dzSysArrayLane( &arr, &lanes, W );
+  /* sweep proportional gains */
+  for( l=0; l<W; l++ ){
+    dzSysArrayClone( &arr, &single[l] );
+    dzSysPIDSetPGain( zArrayElemNC(&single[l],2), 1+l );
+    dzSysLaneLoad( zArrayElemNC(&lanes,2), l, zArrayElemNC(&single[l],2) );
+    dzSysPlanCreate( &plan_single[l], &single[l] );
+  }
+  zAssert( dzSysArrayLane (batched),
+    dzSysBatchKindOf( zArrayElemNC(&lanes,2) ) == DZ_SYS_BATCH_PID &&
+    dzSysBatchKindOf( zArrayElemNC(&lanes,3) ) == DZ_SYS_BATCH_SOL &&
+    zArrayElemNC(&lanes,1)->com == &dz_sys_lanes_com &&
+    dzSysInputNum(zArrayElemNC(&lanes,1)) == 2*W && dzSysOutputNum(zArrayElemNC(&lanes,1)) == W );
+  dzSysPlanCreate( &plan, &lanes );
+  for( i=0; i<STEP; i++ ){
+    dzSysPlanUpdate( &plan, DT );
+    for( l=0; l<W; l++ ){
+      dzSysPlanUpdate( &plan_single[l], DT );
+      for( j=0; j<zArraySize(&arr); j++ )
+        if( !zIsTiny( dzSysLaneOutputVal(zArrayElemNC(&lanes,j),W,0,l) - dzSysOutputVal(zArrayElemNC(&single[l],j),0) ) ) result = false;
+    }
+  }
+  zAssert( dzSysArrayLane, result );
+  for( l=0; l<W; l++ ){
+    dzSysPlanDestroy( &plan_single[l] );
+    dzSysArrayDestroy( &single[l] );
+  }
+  dzSysPlanDestroy( &plan );
+  dzSysArrayDestroy( &lanes );
+  dzSysArrayDestroy( &arr );
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,77 @@
+#include <dzco/dz_sys.h>
+
+#define WIDTH 256
+#define DEPTH 8
+#define DT    0.001
+#define STEP  100
+
+#define sys_at(arr,l,k) zArrayElemNC(arr,(l)*WIDTH+(k))
+
+/* layers of systems randomly connected, closed through integrators */
+void create_graph(dzSysArray *arr)
+{
+  int l, k;
+
+  dzSysArrayAlloc( arr, (DEPTH+2)*WIDTH );
+  for( k=0; k<WIDTH; k++ ){
+    dzSysSineCreate( sys_at(arr,0,k), 1, 0, 0.01*(k+1) );
+    dzSysICreate( sys_at(arr,DEPTH+1,k), 1, 0 );
+  }
+  for( l=1; l<=DEPTH; l++ )
+    for( k=0; k<WIDTH; k++ ){
+      if( l == 1 ){
+        dzSysAdderCreate( sys_at(arr,l,k), 2 );
+        dzSysConnect( sys_at(arr,0,k), 0, sys_at(arr,l,k), 0 );
+        dzSysConnect( sys_at(arr,DEPTH+1,zRandI(0,WIDTH-1)), 0, sys_at(arr,l,k), 1 );
+      } else{
+        dzSysFOLCreate( sys_at(arr,l,k), zRandF(0.01,0.1), zRandF(-1,1) );
+        dzSysConnect( sys_at(arr,l-1,zRandI(0,WIDTH-1)), 0, sys_at(arr,l,k), 0 );
+      }
+    }
+  for( k=0; k<WIDTH; k++ )
+    dzSysConnect( sys_at(arr,DEPTH,k), 0, sys_at(arr,DEPTH+1,k), 0 );
+}
+
+int main(void)
+{
+  dzSysArray arr, arr2;
+  dzSysPlan plan, plan2;
+  dzSysPar par;
+  char *req[] = { "out" };
+  int i, j;
+  bool result = true;
+
+  zRandInit();
+  create_graph( &arr );
+  dzSysArrayClone( &arr, &arr2 );
+  dzSysPlanCreate( &plan, &arr );
+  dzSysPlanCreate( &plan2, &arr2 );
+  dzSysParCreate( &par, &plan2, 4 );
+  zAssert( dzSysParCreate, dzSysParLevelNum(&par) >= DEPTH+1 && dzSysParLevelSize(&par,0) >= WIDTH );
+  for( i=0; i<STEP; i++ ){
+    dzSysPlanUpdate( &plan, DT );
+    dzSysParUpdate( &par, DT );
+    for( j=0; j<zArraySize(&arr); j++ )
+      if( dzSysOutputVal(zArrayElemNC(&arr,j),0) != dzSysOutputVal(zArrayElemNC(&arr2,j),0) ) result = false;
+  }
+  zAssert( dzSysParUpdate, result );
+  /* levels are made again for a pruned plan */
+  zNameSet( sys_at(&arr,DEPTH+1,0), "out" );
+  zNameSet( sys_at(&arr2,DEPTH+1,0), "out" );
+  dzSysPlanPrune( &plan, 1, req );
+  dzSysPlanPrune( &plan2, 1, req );
+  for( i=0; i<STEP; i++ ){
+    dzSysPlanUpdate( &plan, DT );
+    dzSysParUpdate( &par, DT );
+    for( j=0; j<zArraySize(&arr); j++ )
+      if( dzSysOutputVal(zArrayElemNC(&arr,j),0) != dzSysOutputVal(zArrayElemNC(&arr2,j),0) ) result = false;
+  }
+  if( par.head[dzSysParLevelNum(&par)] != dzSysPlanNum(&plan2) ) result = false;
+  zAssert( dzSysParUpdate (pruned plan), result );
+  dzSysParDestroy( &par );
+  dzSysPlanDestroy( &plan );
+  dzSysPlanDestroy( &plan2 );
+  dzSysArrayDestroy( &arr );
+  dzSysArrayDestroy( &arr2 );
+  return EXIT_SUCCESS;
+}
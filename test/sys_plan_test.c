@@ -0,0 +1,314 @@
+#include <dzco/dz_sys.h>
+
+#define DT 0.01
+
+bool assert_plan_order(void)
+{
+  dzSysArray arr;
+  dzSysPlan plan;
+  bool result;
+
+  /* systems declared in the reverse order of signal flow */
+  dzSysArrayAlloc( &arr, 3 );
+  dzSysPCreate( zArrayElemNC(&arr,0), 3 );
+  dzSysPCreate( zArrayElemNC(&arr,1), 2 );
+  dzSysStepCreate( zArrayElemNC(&arr,2), 1, 0, HUGE_VAL );
+  dzSysConnect( zArrayElemNC(&arr,2), 0, zArrayElemNC(&arr,1), 0 );
+  dzSysConnect( zArrayElemNC(&arr,1), 0, zArrayElemNC(&arr,0), 0 );
+  dzSysPlanCreate( &plan, &arr );
+  dzSysPlanUpdate( &plan, DT );
+  result = dzSysPlanSys(&plan,0) == zArrayElemNC(&arr,2) &&
+           dzSysPlanSys(&plan,1) == zArrayElemNC(&arr,1) &&
+           dzSysPlanSys(&plan,2) == zArrayElemNC(&arr,0) &&
+           dzSysPlanLoopNum(&plan) == 0 &&
+           zIsTiny( dzSysOutputVal(zArrayElemNC(&arr,0),0) - 6 ) ? true : false;
+  dzSysPlanDestroy( &plan );
+  dzSysArrayDestroy( &arr );
+  return result;
+}
+
+bool assert_plan_loop(void)
+{
+  dzSysArray arr;
+  dzSysPlan plan;
+  bool result = true;
+
+  dzSysArrayAlloc( &arr, 3 );
+  dzSysStepCreate( zArrayElemNC(&arr,0), 1, 0, HUGE_VAL );
+  dzSysSubtrCreate( zArrayElemNC(&arr,1), 2 );
+  dzSysICreate( zArrayElemNC(&arr,2), 1, 0 );
+  zNameSet( zArrayElemNC(&arr,1), "sub" );
+  dzSysConnect( zArrayElemNC(&arr,0), 0, zArrayElemNC(&arr,1), 0 );
+  dzSysConnect( zArrayElemNC(&arr,1), 0, zArrayElemNC(&arr,2), 0 );
+  dzSysConnect( zArrayElemNC(&arr,2), 0, zArrayElemNC(&arr,1), 1 );
+  /* a loop through an integrator is not algebraic */
+  dzSysPlanCreate( &plan, &arr );
+  if( dzSysPlanLoopNum(&plan) != 0 || dzSysPlanSys(&plan,1) != zArrayElemNC(&arr,2) ) result = false;
+  dzSysPlanDestroy( &plan );
+  dzSysDestroy( zArrayElemNC(&arr,2) );
+  /* a loop through a proportional amplifier is algebraic */
+  dzSysPCreate( zArrayElemNC(&arr,2), 0.5 );
+  dzSysConnect( zArrayElemNC(&arr,1), 0, zArrayElemNC(&arr,2), 0 );
+  dzSysConnect( zArrayElemNC(&arr,2), 0, zArrayElemNC(&arr,1), 1 );
+  dzSysPlanCreate( &plan, &arr );
+  if( dzSysPlanLoopNum(&plan) != 1 || dzSysPlanNum(&plan) != 3 ) result = false;
+  dzSysPlanDestroy( &plan );
+  dzSysArrayDestroy( &arr );
+  return result;
+}
+
+/* a loop of a subtractor and an integrator, read by another integrator */
+void create_loop_sys(dzSysArray *arr, int step, int sub, int intg, int out)
+{
+  dzSysArrayAlloc( arr, 4 );
+  dzSysStepCreate( zArrayElemNC(arr,step), 1, 0, HUGE_VAL );
+  dzSysSubtrCreate( zArrayElemNC(arr,sub), 2 );
+  dzSysICreate( zArrayElemNC(arr,intg), 10, 0 );
+  dzSysICreate( zArrayElemNC(arr,out), 1, 0 );
+  dzSysConnect( zArrayElemNC(arr,step), 0, zArrayElemNC(arr,sub), 0 );
+  dzSysConnect( zArrayElemNC(arr,sub), 0, zArrayElemNC(arr,intg), 0 );
+  dzSysConnect( zArrayElemNC(arr,intg), 0, zArrayElemNC(arr,sub), 1 );
+  dzSysConnect( zArrayElemNC(arr,sub), 0, zArrayElemNC(arr,out), 0 );
+}
+
+bool assert_plan_loop_update(void)
+{
+  dzSysArray arr, ref;
+  dzSysPlan plan;
+  int i;
+  bool result = true;
+
+  /* the integrator out of the loop is declared first */
+  create_loop_sys( &arr, 1, 3, 2, 0 );
+  /* the reference is declared in the order to be updated */
+  create_loop_sys( &ref, 0, 2, 1, 3 );
+  dzSysPlanCreate( &plan, &arr );
+  if( dzSysPlanSys(&plan,1) != zArrayElemNC(&arr,2) ||
+      dzSysPlanSys(&plan,3) != zArrayElemNC(&arr,0) ) result = false;
+  for( i=0; i<100; i++ ){
+    dzSysPlanUpdate( &plan, DT );
+    dzSysArrayUpdate( &ref, DT );
+    if( dzSysOutputVal(zArrayElemNC(&arr,3),0) != dzSysOutputVal(zArrayElemNC(&ref,2),0) ||
+        dzSysOutputVal(zArrayElemNC(&arr,2),0) != dzSysOutputVal(zArrayElemNC(&ref,1),0) ||
+        dzSysOutputVal(zArrayElemNC(&arr,0),0) != dzSysOutputVal(zArrayElemNC(&ref,3),0) ) result = false;
+  }
+  dzSysPlanDestroy( &plan );
+  dzSysArrayDestroy( &arr );
+  dzSysArrayDestroy( &ref );
+  return result;
+}
+
+/* a loop of a subtractor and a multi-input multi-output integrator */
+void create_mimo_loop_sys(dzSysArray *arr, int step, int sub, int intg)
+{
+  dzLinMIMO *lin;
+
+  lin = zAlloc( dzLinMIMO, 1 );
+  dzLinMIMOAlloc( lin, 1, 1, 1 );
+  zMatSetElemNC( lin->b, 0, 0, 1 );
+  zMatSetElemNC( lin->c, 0, 0, 10 );
+  dzSysArrayAlloc( arr, 3 );
+  dzSysStepCreate( zArrayElemNC(arr,step), 1, 0, HUGE_VAL );
+  dzSysSubtrCreate( zArrayElemNC(arr,sub), 2 );
+  dzSysLinMIMOCreate( zArrayElemNC(arr,intg), lin );
+  dzSysConnect( zArrayElemNC(arr,step), 0, zArrayElemNC(arr,sub), 0 );
+  dzSysConnect( zArrayElemNC(arr,sub), 0, zArrayElemNC(arr,intg), 0 );
+  dzSysConnect( zArrayElemNC(arr,intg), 0, zArrayElemNC(arr,sub), 1 );
+}
+
+bool assert_plan_mimo_loop_update(void)
+{
+  dzSysArray arr, ref;
+  dzSysPlan plan;
+  int i;
+  bool result = true;
+
+  /* the subtractor is declared before the integrator */
+  create_mimo_loop_sys( &arr, 2, 0, 1 );
+  create_mimo_loop_sys( &ref, 0, 2, 1 );
+  dzSysPlanCreate( &plan, &arr );
+  if( dzSysPlanLoopNum(&plan) != 0 ||
+      dzSysPlanSys(&plan,1) != zArrayElemNC(&arr,1) ||
+      dzSysPlanSys(&plan,2) != zArrayElemNC(&arr,0) ) result = false;
+  for( i=0; i<100; i++ ){
+    dzSysPlanUpdate( &plan, DT );
+    dzSysArrayUpdate( &ref, DT );
+    /* the output at the first step is that of the initial state */
+    if( i == 0 && dzSysOutputVal(zArrayElemNC(&arr,1),0) != 0 ) result = false;
+    if( dzSysOutputVal(zArrayElemNC(&arr,0),0) != dzSysOutputVal(zArrayElemNC(&ref,2),0) ||
+        dzSysOutputVal(zArrayElemNC(&arr,1),0) != dzSysOutputVal(zArrayElemNC(&ref,1),0) ) result = false;
+  }
+  dzSysPlanDestroy( &plan );
+  dzSysArrayDestroy( &arr );
+  dzSysArrayDestroy( &ref );
+  return result;
+}
+
+bool assert_plan_multirate(dzSysRateTransition transition)
+{
+  dzSysArray arr;
+  dzSysPlan plan;
+  dzSys ref;
+  double prev = 0, cur = 0;
+  int i;
+  bool result = true;
+
+  dzSysArrayAlloc( &arr, 3 );
+  dzSysStepCreate( zArrayElemNC(&arr,0), 1, 0, HUGE_VAL );
+  dzSysFOLCreate( zArrayElemNC(&arr,1), 0.1, 1 );
+  dzSysPCreate( zArrayElemNC(&arr,2), 2 );
+  dzSysChain( 3, zArrayElemNC(&arr,0), zArrayElemNC(&arr,1), zArrayElemNC(&arr,2) );
+  dzSysSetPeriod( zArrayElemNC(&arr,1), 10*DT );
+  dzSysFOLCreate( &ref, 0.1, 1 );
+  dzSysInputPtr(&ref,0) = &dzSysOutputVal(zArrayElemNC(&arr,0),0);
+  dzSysPlanCreate( &plan, &arr );
+  dzSysPlanSetTransition( &plan, transition );
+  for( i=0; i<100; i++ ){
+    dzSysPlanUpdate( &plan, DT );
+    if( i % 10 == 0 ){
+      prev = cur;
+      cur = zVecElemNC(dzSysUpdate(&ref,10*DT),0);
+    }
+    if( transition == DZ_SYS_RATE_HOLD ){
+      if( dzSysOutputVal(zArrayElemNC(&arr,1),0) != cur ) result = false;
+    } else{
+      if( !zIsTiny( dzSysOutputVal(zArrayElemNC(&arr,1),0) - ( prev + 0.1*(i%10)*( cur - prev ) ) ) ) result = false;
+    }
+    if( !zIsTiny( dzSysOutputVal(zArrayElemNC(&arr,2),0) - 2*dzSysOutputVal(zArrayElemNC(&arr,1),0) ) ) result = false;
+  }
+  dzSysDestroy( &ref );
+  dzSysPlanDestroy( &plan );
+  dzSysArrayDestroy( &arr );
+  return result;
+}
+
+bool assert_plan_prune(void)
+{
+  dzSysArray arr;
+  dzSysPlan plan;
+  char *req[] = { "out" };
+  int i;
+  bool result = true;
+
+  dzSysArrayAlloc( &arr, 5 );
+  dzSysStepCreate( zArrayElemNC(&arr,0), 1, 0, HUGE_VAL );
+  dzSysPCreate( zArrayElemNC(&arr,1), 2 );
+  dzSysICreate( zArrayElemNC(&arr,2), 1, 0 );
+  dzSysPCreate( zArrayElemNC(&arr,3), 3 );
+  dzSysFOLCreate( zArrayElemNC(&arr,4), 0.1, 1 );
+  zNameSet( zArrayElemNC(&arr,1), "out" );
+  dzSysSetPersistent( zArrayElemNC(&arr,2), true );
+  dzSysConnect( zArrayElemNC(&arr,0), 0, zArrayElemNC(&arr,1), 0 );
+  dzSysConnect( zArrayElemNC(&arr,0), 0, zArrayElemNC(&arr,2), 0 );
+  dzSysConnect( zArrayElemNC(&arr,2), 0, zArrayElemNC(&arr,3), 0 );
+  dzSysConnect( zArrayElemNC(&arr,0), 0, zArrayElemNC(&arr,4), 0 );
+  dzSysPlanCreate( &plan, &arr );
+  /* the persistent integrator is kept, the systems after it are not */
+  if( dzSysPlanPrune( &plan, 1, req ) != 2 || dzSysPlanNum(&plan) != 3 ) result = false;
+  for( i=0; i<10; i++ )
+    dzSysPlanUpdate( &plan, DT );
+  if( !zIsTiny( dzSysOutputVal(zArrayElemNC(&arr,1),0) - 2 ) ||
+      dzSysOutputVal(zArrayElemNC(&arr,2),0) <= 0 ||
+      dzSysOutputVal(zArrayElemNC(&arr,3),0) != 0 ||
+      dzSysOutputVal(zArrayElemNC(&arr,4),0) != 0 ) result = false;
+  dzSysPlanDestroy( &plan );
+  dzSysArrayDestroy( &arr );
+  return result;
+}
+
+void create_lazy_sys(dzSysArray *arr)
+{
+  dzSysArrayAlloc( arr, 4 );
+  dzSysStepCreate( zArrayElemNC(arr,0), 1, 0, HUGE_VAL );
+  dzSysPCreate( zArrayElemNC(arr,1), 2 );
+  dzSysICreate( zArrayElemNC(arr,2), 1, 0 );
+  dzSysSetPersistent( zArrayElemNC(arr,2), true );
+  dzSysFOLCreate( zArrayElemNC(arr,3), 0.1, 1 );
+  dzSysConnect( zArrayElemNC(arr,0), 0, zArrayElemNC(arr,1), 0 );
+  dzSysConnect( zArrayElemNC(arr,0), 0, zArrayElemNC(arr,2), 0 );
+  dzSysConnect( zArrayElemNC(arr,0), 0, zArrayElemNC(arr,3), 0 );
+}
+
+bool assert_plan_lazy(void)
+{
+  dzSysArray arr, ref;
+  dzSysPlan plan, refplan;
+  int i;
+  bool result = true;
+
+  create_lazy_sys( &arr );
+  create_lazy_sys( &ref );
+  dzSysPlanCreate( &plan, &arr );
+  dzSysPlanCreate( &refplan, &ref );
+  dzSysPlanSetLazy( &plan, true );
+  for( i=0; i<10; i++ ){
+    dzSysPlanUpdate( &plan, DT );
+    dzSysPlanUpdate( &refplan, DT );
+  }
+  /* the persistent integrator keeps integrating, so does the stateful
+   * first-order lag, and the static amplifier waits for a demand */
+  if( dzSysOutputVal(zArrayElemNC(&arr,2),0) != dzSysOutputVal(zArrayElemNC(&ref,2),0) ||
+      dzSysOutputVal(zArrayElemNC(&arr,3),0) != dzSysOutputVal(zArrayElemNC(&ref,3),0) ||
+      dzSysOutputVal(zArrayElemNC(&arr,1),0) != 0 ) result = false;
+  if( !zIsTiny( zVecElemNC(dzSysPlanDemand(&plan,zArrayElemNC(&arr,1)),0) - 2 ) ) result = false;
+  dzSysPlanDestroy( &plan );
+  dzSysPlanDestroy( &refplan );
+  dzSysArrayDestroy( &arr );
+  dzSysArrayDestroy( &ref );
+  return result;
+}
+
+bool assert_plan_lazy_exec(void)
+{
+  dzSysArray arr, arr2, ref;
+  dzSysPlan plan, plan2, refplan;
+  dzSysPar par;
+  dzSysProf prof;
+  int i;
+  bool result = true;
+
+  create_lazy_sys( &arr );
+  create_lazy_sys( &arr2 );
+  create_lazy_sys( &ref );
+  dzSysPlanCreate( &plan, &arr );
+  dzSysPlanCreate( &plan2, &arr2 );
+  dzSysPlanCreate( &refplan, &ref );
+  dzSysPlanSetLazy( &plan, true );
+  dzSysPlanSetLazy( &plan2, true );
+  dzSysParCreate( &par, &plan, 2 );
+  dzSysProfCreate( &prof, &arr2, 0 );
+  for( i=0; i<10; i++ ){
+    dzSysParUpdate( &par, DT );
+    dzSysProfPlanUpdate( &prof, &plan2, DT );
+    dzSysPlanUpdate( &refplan, DT );
+  }
+  /* executors and profilers also leave the amplifier for a demand */
+  if( dzSysOutputVal(zArrayElemNC(&arr,2),0) != dzSysOutputVal(zArrayElemNC(&ref,2),0) ||
+      dzSysOutputVal(zArrayElemNC(&arr2,2),0) != dzSysOutputVal(zArrayElemNC(&ref,2),0) ||
+      dzSysOutputVal(zArrayElemNC(&arr,1),0) != 0 ||
+      dzSysOutputVal(zArrayElemNC(&arr2,1),0) != 0 ) result = false;
+  if( dzSysHistCount(dzSysProfTick(&prof)) != 10 ) result = false;
+  dzSysProfDestroy( &prof );
+  dzSysParDestroy( &par );
+  dzSysPlanDestroy( &plan );
+  dzSysPlanDestroy( &plan2 );
+  dzSysPlanDestroy( &refplan );
+  dzSysArrayDestroy( &arr );
+  dzSysArrayDestroy( &arr2 );
+  dzSysArrayDestroy( &ref );
+  return result;
+}
+
+int main(void)
+{
+  zAssert( dzSysPlanCreate (order), assert_plan_order() );
+  zAssert( dzSysPlanCreate (loop), assert_plan_loop() );
+  zAssert( dzSysPlanUpdate (loop), assert_plan_loop_update() );
+  zAssert( dzSysPlanUpdate (loop of MIMO system), assert_plan_mimo_loop_update() );
+  zAssert( dzSysPlanUpdate (multirate, hold), assert_plan_multirate( DZ_SYS_RATE_HOLD ) );
+  zAssert( dzSysPlanUpdate (multirate, interpolation), assert_plan_multirate( DZ_SYS_RATE_INTERP ) );
+  zAssert( dzSysPlanPrune, assert_plan_prune() );
+  zAssert( dzSysPlanDemand, assert_plan_lazy() );
+  zAssert( dzSysParUpdate and dzSysProfPlanUpdate (lazy), assert_plan_lazy_exec() );
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+#include <dzco/dz_sys.h>
+
+#define N    1000
+#define STEP 100
+#define DT   0.001
+
+void assert_hist(void)
+{
+  dzSysHist hist;
+  double p;
+  int i;
+  bool result = true;
+
+  dzSysHistInit( &hist );
+  for( i=1; i<=N; i++ ) dzSysHistAdd( &hist, i );
+  if( dzSysHistCount(&hist) != N ||
+      !zIsTiny( dzSysHistMean(&hist) - 0.5*(N+1) ) ||
+      dzSysHistMin(&hist) != 1 || dzSysHistMax(&hist) != N ) result = false;
+  for( i=1; i<100; i++ ){
+    p = dzSysHistPercentile( &hist, i );
+    if( p < i*N/100 || p > i*N/100*(1+1.0/16)+1 ) result = false;
+  }
+  if( dzSysHistPercentile( &hist, 100 ) != N ) result = false;
+  zAssert( dzSysHistPercentile, result );
+}
+
+void assert_prof(void)
+{
+  dzSysArray arr;
+  dzSysPlan plan;
+  dzSysProf prof;
+  FILE *fp;
+  char buf[BUFSIZ];
+  unsigned long blame = 0;
+  int i;
+  bool result = true;
+
+  dzSysArrayAlloc( &arr, 3 );
+  dzSysStepCreate( zArrayElemNC(&arr,0), 1, 0, HUGE_VAL );
+  dzSysBWCreate( zArrayElemNC(&arr,1), 10, 5 );
+  dzSysFOLCreate( zArrayElemNC(&arr,2), 0.1, 1 );
+  dzSysChain( 3, zArrayElemNC(&arr,0), zArrayElemNC(&arr,1), zArrayElemNC(&arr,2) );
+  dzSysPlanCreate( &plan, &arr );
+  dzSysProfCreate( &prof, &arr, 10 );
+  dzSysProfSetBudget( &prof, 1.0e-3 ); /* every tick overruns */
+  for( i=0; i<STEP; i++ )
+    dzSysProfPlanUpdate( &prof, &plan, DT );
+  if( dzSysHistCount(dzSysProfTick(&prof)) != STEP || dzSysProfOverrunNum(&prof) != STEP ) result = false;
+  for( i=0; i<zArraySize(&arr); i++ ){
+    if( dzSysHistCount(dzSysProfBlock(&prof,i)) != STEP ) result = false;
+    blame += dzSysProfBlame(&prof,i);
+  }
+  if( blame != STEP ) result = false;
+  zAssert( dzSysProfPlanUpdate, result );
+  fp = tmpfile();
+  dzSysProfFPrintTrace( fp, &prof );
+  rewind( fp );
+  zAssert( dzSysProfFPrintTrace, fgets( buf, BUFSIZ, fp ) && strncmp( buf, "{\"traceEvents\":[", 16 ) == 0 );
+  fclose( fp );
+  dzSysProfDestroy( &prof );
+  dzSysPlanDestroy( &plan );
+  dzSysArrayDestroy( &arr );
+}
+
+/* a step input and a slow first-order lag */
+void create_multirate_sys(dzSysArray *arr)
+{
+  dzSysArrayAlloc( arr, 2 );
+  dzSysStepCreate( zArrayElemNC(arr,0), 1, 0, HUGE_VAL );
+  dzSysFOLCreate( zArrayElemNC(arr,1), 0.1, 1 );
+  dzSysConnect( zArrayElemNC(arr,0), 0, zArrayElemNC(arr,1), 0 );
+  dzSysSetPeriod( zArrayElemNC(arr,1), 10*DT );
+}
+
+void assert_prof_multirate(void)
+{
+  dzSysArray arr, ref;
+  dzSysPlan plan, refplan;
+  dzSysProf prof;
+  int i;
+  bool result = true;
+
+  create_multirate_sys( &arr );
+  create_multirate_sys( &ref );
+  dzSysPlanCreate( &plan, &arr );
+  dzSysPlanCreate( &refplan, &ref );
+  dzSysProfCreate( &prof, &arr, 0 );
+  for( i=0; i<STEP; i++ ){
+    dzSysProfPlanUpdate( &prof, &plan, DT );
+    dzSysPlanUpdate( &refplan, DT );
+    if( dzSysOutputVal(zArrayElemNC(&arr,1),0) != dzSysOutputVal(zArrayElemNC(&ref,1),0) ) result = false;
+  }
+  /* the slow system is timed only when it is due */
+  if( dzSysHistCount(dzSysProfBlock(&prof,0)) != STEP ||
+      dzSysHistCount(dzSysProfBlock(&prof,1)) != STEP/10 ) result = false;
+  zAssert( dzSysProfPlanUpdate (multirate), result );
+  dzSysProfDestroy( &prof );
+  dzSysPlanDestroy( &plan );
+  dzSysPlanDestroy( &refplan );
+  dzSysArrayDestroy( &arr );
+  dzSysArrayDestroy( &ref );
+}
+
+int main(void)
+{
+  assert_hist();
+  assert_prof();
+  assert_prof_multirate();
+  return EXIT_SUCCESS;
+}
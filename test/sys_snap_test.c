@@ -0,0 +1,89 @@
+#include <dzco/dz_sys.h>
+
+#define DT   0.001
+#define STEP 300
+
+void create_sys(dzSysArray *arr)
+{
+  dzLin *lin;
+  dzTF *tf;
+
+  dzSysArrayAlloc( arr, 7 );
+  dzSysSineCreate( zArrayElemNC(arr,0), 1, 0, 0.1 );
+  dzSysPIDCreate( zArrayElemNC(arr,1), 2, 1, 0.1, 0.01, 1 );
+  lin = zAlloc( dzLin, 1 );
+  dzLinAlloc( lin, 2 );
+  zMatSetElemNC( lin->a, 0, 1, 1 );
+  zMatSetElemNC( lin->a, 1, 0, -100 ); zMatSetElemNC( lin->a, 1, 1, -10 );
+  zVecSetElemNC( lin->b, 1, 100 );
+  zVecSetElemNC( lin->c, 0, 1 );
+  dzSysLinCreate( zArrayElemNC(arr,2), lin );
+  tf = zAlloc( dzTF, 1 );
+  dzTFAlloc( tf, 0, 2 );
+  dzTFSetNumElem( tf, 0, 1 );
+  dzTFSetDenElem( tf, 0, 1 ); dzTFSetDenElem( tf, 1, 0.4 ); dzTFSetDenElem( tf, 2, 0.02 );
+  dzSysTFCreate( zArrayElemNC(arr,3), tf );
+  dzSysBWCreate( zArrayElemNC(arr,4), 10, 3 );
+  dzSysBWMultiCreate( zArrayElemNC(arr,5), 20, 3, 2 );
+  dzSysBatchCreate( zArrayElemNC(arr,6), DZ_SYS_BATCH_SOL, 2 );
+  dzSysBatchSetSOL( zArrayElemNC(arr,6), 0, 0.1, 0, 0.5, 1 );
+  dzSysBatchSetSOL( zArrayElemNC(arr,6), 1, 0.2, 0.01, 0.7, 2 );
+  dzSysChain( 5, zArrayElemNC(arr,0), zArrayElemNC(arr,1), zArrayElemNC(arr,2), zArrayElemNC(arr,3), zArrayElemNC(arr,4) );
+  dzSysConnect( zArrayElemNC(arr,0), 0, zArrayElemNC(arr,5), 0 );
+  dzSysConnect( zArrayElemNC(arr,4), 0, zArrayElemNC(arr,5), 1 );
+  dzSysConnect( zArrayElemNC(arr,5), 0, zArrayElemNC(arr,6), 0 );
+  dzSysConnect( zArrayElemNC(arr,5), 1, zArrayElemNC(arr,6), 1 );
+}
+
+/* replay a simulation and compare outputs with the record. */
+bool replay(dzSysPlan *plan, dzSysArray *arr, double *record, bool save)
+{
+  int i, j, k, n = 0;
+  bool result = true;
+
+  for( i=0; i<STEP; i++ ){
+    dzSysPlanUpdate( plan, DT );
+    for( j=0; j<zArraySize(arr); j++ )
+      for( k=0; k<dzSysOutputNum(zArrayElemNC(arr,j)); k++, n++ ){
+        if( save )
+          record[n] = dzSysOutputVal(zArrayElemNC(arr,j),k);
+        else if( record[n] != dzSysOutputVal(zArrayElemNC(arr,j),k) ) result = false;
+      }
+  }
+  return result;
+}
+
+int main(void)
+{
+  dzSysArray arr, arr2;
+  dzSysPlan plan;
+  dzSysState state;
+  double *record;
+  int i;
+  bool result = true;
+
+  create_sys( &arr );
+  dzSysPlanCreate( &plan, &arr );
+  for( i=0; i<STEP; i++ )
+    dzSysPlanUpdate( &plan, DT );
+  dzSysStateAlloc( &state, &arr );
+  record = zAlloc( double, STEP*state.size );
+  dzSysArraySnapshot( &arr, &state );
+  replay( &plan, &arr, record, true );
+  /* rewind and replay several times */
+  for( i=0; i<3; i++ ){
+    if( !dzSysArrayRestore( &arr, &state ) ||
+        !replay( &plan, &arr, record, false ) ) result = false;
+  }
+  zAssert( dzSysArrayRestore, result );
+  /* mismatch of the size */
+  dzSysArrayAlloc( &arr2, 1 );
+  dzSysFOLCreate( zArrayElemNC(&arr2,0), 0.1, 1 );
+  zAssert( dzSysArrayRestore (size mismatch), !dzSysArrayRestore( &arr2, &state ) );
+  dzSysArrayDestroy( &arr2 );
+  zFree( record );
+  dzSysStateFree( &state );
+  dzSysPlanDestroy( &plan );
+  dzSysArrayDestroy( &arr );
+  return EXIT_SUCCESS;
+}
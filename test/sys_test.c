@@ -0,0 +1,138 @@
+#include <dzco/dz_sys.h>
+
+#define N 200
+
+void assert_com_register(void)
+{
+  static char typestr[N][32];
+  static dzSysCom com[N];
+  dzSysCom dup;
+  int i;
+  bool result = true;
+
+  for( i=0; i<N; i++ ){
+    sprintf( typestr[i], "user_type_%d", i );
+    com[i] = dz_sys_p_com;
+    com[i].typestr = typestr[i];
+    if( !dzSysComRegister( &com[i] ) ) result = false;
+  }
+  for( i=0; i<N; i++ )
+    if( dzSysComFind( typestr[i] ) != &com[i] ) result = false;
+  /* built-in classes are still found after the registry grows */
+  if( dzSysComFind( "tf" ) != &dz_sys_tf_com ||
+      dzSysComFind( "butterworth" ) != &dz_sys_bw_com ||
+      dzSysComFind( "unknown" ) != NULL ) result = false;
+  zAssert( dzSysComRegister, result );
+  dup = dz_sys_p_com;
+  dup.typestr = "tf";
+  zAssert( dzSysComRegister (duplicate), !dzSysComRegister( &dup ) && dzSysComRegister( &dz_sys_tf_com ) );
+}
+
+void assert_name_index(void)
+{
+  dzSysArray arr;
+  dzSysNameIndex idx;
+  char name[BUFSIZ];
+  int i;
+  bool result = true;
+
+  dzSysArrayAlloc( &arr, N );
+  for( i=0; i<N; i++ ){
+    dzSysPCreate( zArrayElemNC(&arr,i), i );
+    sprintf( name, "p%d", i/2 ); /* duplicate names */
+    zNameSet( zArrayElemNC(&arr,i), name );
+  }
+  dzSysNameIndexCreate( &idx, &arr );
+  for( i=0; i<N; i++ ){
+    sprintf( name, "p%d", i/2 );
+    if( dzSysNameIndexFind( &idx, name ) != dzSysArrayNameFind( &arr, name ) ) result = false;
+  }
+  zAssert( dzSysNameIndexFind, result );
+  dzSysNameIndexDestroy( &idx );
+  dzSysArrayDestroy( &arr );
+}
+
+#define DT   0.001
+#define STEP 300
+
+void create_clone_sys(dzSysArray *arr)
+{
+  dzLin *lin;
+  dzTF *tf;
+
+  dzSysArrayAlloc( arr, 7 );
+  dzSysSineCreate( zArrayElemNC(arr,0), 1, 0, 0.1 );
+  dzSysPIDCreate( zArrayElemNC(arr,1), 2, 1, 0.1, 0.01, 1 );
+  lin = zAlloc( dzLin, 1 );
+  dzLinAlloc( lin, 2 );
+  zMatSetElemNC( lin->a, 0, 1, 1 );
+  zMatSetElemNC( lin->a, 1, 0, -100 ); zMatSetElemNC( lin->a, 1, 1, -10 );
+  zVecSetElemNC( lin->b, 1, 100 );
+  zVecSetElemNC( lin->c, 0, 1 );
+  dzLinSetZOH( lin );
+  dzSysLinCreate( zArrayElemNC(arr,2), lin );
+  tf = zAlloc( dzTF, 1 );
+  dzTFAlloc( tf, 0, 2 );
+  dzTFSetNumElem( tf, 0, 1 );
+  dzTFSetDenElem( tf, 0, 1 ); dzTFSetDenElem( tf, 1, 0.4 ); dzTFSetDenElem( tf, 2, 0.02 );
+  dzSysTFCreate( zArrayElemNC(arr,3), tf );
+  dzSysBWCreate( zArrayElemNC(arr,4), 10, 3 );
+  dzSysBWMultiCreate( zArrayElemNC(arr,5), 20, 3, 2 );
+  dzSysBatchCreate( zArrayElemNC(arr,6), DZ_SYS_BATCH_SOL, 2 );
+  dzSysBatchSetSOL( zArrayElemNC(arr,6), 0, 0.1, 0, 0.5, 1 );
+  dzSysBatchSetSOL( zArrayElemNC(arr,6), 1, 0.2, 0.01, 0.7, 2 );
+  zNameSet( zArrayElemNC(arr,6), "output" );
+  dzSysChain( 5, zArrayElemNC(arr,0), zArrayElemNC(arr,1), zArrayElemNC(arr,2), zArrayElemNC(arr,3), zArrayElemNC(arr,4) );
+  dzSysConnect( zArrayElemNC(arr,0), 0, zArrayElemNC(arr,5), 0 );
+  dzSysConnect( zArrayElemNC(arr,4), 0, zArrayElemNC(arr,5), 1 );
+  dzSysConnect( zArrayElemNC(arr,5), 0, zArrayElemNC(arr,6), 0 );
+  dzSysConnect( zArrayElemNC(arr,5), 1, zArrayElemNC(arr,6), 1 );
+}
+
+void assert_clone(void)
+{
+  dzSysArray arr1, arr2;
+  dzSysPlan plan1, plan2;
+  dzSysPort *port;
+  int i, j, k;
+  bool result = true;
+
+  create_clone_sys( &arr1 );
+  dzSysPlanCreate( &plan1, &arr1 );
+  for( i=0; i<STEP; i++ )
+    dzSysPlanUpdate( &plan1, DT );
+  if( !dzSysArrayClone( &arr1, &arr2 ) ){
+    zAssert( dzSysArrayClone, false );
+    return;
+  }
+  /* inputs of the copy are bound to the copy */
+  for( i=0; i<zArraySize(&arr2); i++ )
+    for( j=0; j<dzSysInputNum(zArrayElemNC(&arr2,i)); j++ ){
+      port = dzSysInputElem(zArrayElemNC(&arr2,i),j);
+      if( port->sp && ( port->sp < zArrayElemNC(&arr2,0) || port->sp >= zArrayElemNC(&arr2,0) + zArraySize(&arr2) ||
+          port->vp != &dzSysOutputVal(port->sp,port->port) ) ) result = false;
+    }
+  if( strcmp( zName(zArrayElemNC(&arr2,6)), "output" ) != 0 ) result = false;
+  /* the copy continues from the same state */
+  dzSysPlanCreate( &plan2, &arr2 );
+  for( i=0; i<STEP; i++ ){
+    dzSysPlanUpdate( &plan1, DT );
+    dzSysPlanUpdate( &plan2, DT );
+    for( j=0; j<zArraySize(&arr1); j++ )
+      for( k=0; k<dzSysOutputNum(zArrayElemNC(&arr1,j)); k++ )
+        if( dzSysOutputVal(zArrayElemNC(&arr1,j),k) != dzSysOutputVal(zArrayElemNC(&arr2,j),k) ) result = false;
+  }
+  dzSysPlanDestroy( &plan1 );
+  dzSysPlanDestroy( &plan2 );
+  zAssert( dzSysArrayClone, result );
+  dzSysArrayDestroy( &arr1 );
+  dzSysArrayDestroy( &arr2 );
+}
+
+int main(void)
+{
+  assert_com_register();
+  assert_name_index();
+  assert_clone();
+  return EXIT_SUCCESS;
+}
@@ -85,10 +85,124 @@ void assert_connect(void)
     zPexEqual(dzTFDen(&tf),dzTFDen(&tf1),zTOL) );
 }
 
+#define NUM_FREQ 1000
+
+void assert_freqres_grid(void)
+{
+  zCVec zero, pole;
+  dzTF tf;
+  dzFreqRes fr;
+  double af[NUM_FREQ], g[NUM_FREQ], p[NUM_FREQ];
+  int i;
+  bool result = true;
+
+  zero = zCVecAlloc( NUM_ZEROS );
+  pole = zCVecAlloc( NUM_POLES );
+  zComplexCreate( zCVecElemNC(zero,0), zRandF(-10,-0.1), 0 );
+  zComplexCreate( zCVecElemNC(zero,1), zRandF(0.1,10), 0 );
+  zComplexCreate( zCVecElemNC(pole,0), zRandF(-10,-0.1), 0 );
+  zComplexCreate( zCVecElemNC(pole,1), zRandF(-10,-0.1), zRandF(0.1,10) );
+  zComplexConj( zCVecElemNC(pole,1), zCVecElemNC(pole,2) );
+  zComplexCreate( zCVecElemNC(pole,3), zRandF(-10,-0.1), zRandF(0.1,10) );
+  zComplexConj( zCVecElemNC(pole,3), zCVecElemNC(pole,4) );
+  dzTFCreateZeroPole( &tf, zero, pole, zRandF(0.1,5) );
+  dzTFZeroPole( &tf );
+  for( i=0; i<NUM_FREQ; i++ )
+    af[i] = pow( 10, -3 + 6.0*i/NUM_FREQ );
+  if( !dzFreqResGridFromTF( &tf, af, NUM_FREQ, g, p ) ) result = false;
+  for( i=0; i<NUM_FREQ; i++ ){
+    dzFreqResFromTF( &fr, &tf, af[i] );
+    if( !zIsTol( fr.g - g[i], zTOL*100 ) || !zIsTol( fr.p - p[i], zTOL*100 ) ) result = false;
+  }
+  zAssert( dzFreqResGridFromTF, result );
+  dzTFDestroy( &tf );
+  zCVecFree( zero );
+  zCVecFree( pole );
+}
+
+void assert_freqres_array(void)
+{
+  dzFreqResArray arr, slice;
+  dzFreqResList list, list_closed;
+  dzFreqResListCell *cp;
+  dzFreqRes fr;
+  int i;
+  bool result = true;
+
+  dzFreqResArrayInit( &arr );
+  for( i=0; i<NUM_FREQ; i++ )
+    if( !dzFreqResArrayAdd( &arr, pow( 10, -3 + 6.0*i/NUM_FREQ ), zRandF(-20,20), zRandF(-180,0) ) ) result = false;
+  if( dzFreqResArraySize(&arr) != NUM_FREQ ) result = false;
+  dzFreqResArraySliceFreq( &arr, 0.1, 10, &slice );
+  for( i=0; i<dzFreqResArraySize(&slice); i++ )
+    if( slice.f[i] < 0.1 || slice.f[i] > 10 ) result = false;
+  if( slice.f > arr.f && slice.f[-1] >= 0.1 ) result = false;
+  if( slice.f + slice.size < arr.f + arr.size && slice.f[slice.size] <= 10 ) result = false;
+  if( dzFreqResArrayAdd( &slice, 1, 0, 0 ) ) result = false;
+  zAssert( dzFreqResArrayAdd + dzFreqResArraySliceFreq, result );
+
+  dzFreqResArrayToList( &arr, &list );
+  dzFreqResList2Closed( &list, &list_closed );
+  dzFreqResArray2Closed( &arr );
+  result = zListSize(&list_closed) == NUM_FREQ;
+  i = 0;
+  zListForEach( &list_closed, cp ){
+    if( !zIsTol( cp->data.f - arr.f[i], zTOL ) || !zIsTol( cp->data.g - arr.g[i], zTOL ) || !zIsTol( cp->data.p - arr.p[i], zTOL ) ) result = false;
+    i++;
+  }
+  i = 0;
+  zListForEach( &list, cp ){
+    dzFreqRes2Closed( &cp->data, &fr );
+    if( !zIsTol( fr.g - arr.g[i], zTOL ) || !zIsTol( fr.p - arr.p[i], zTOL ) ) result = false;
+    i++;
+  }
+  dzFreqResArray2Open( &arr );
+  i = 0;
+  zListForEach( &list, cp ){
+    if( !zIsTol( cp->data.g - arr.g[i], zTOL*100 ) || !zIsTol( cp->data.p - arr.p[i], zTOL*100 ) ) result = false;
+    i++;
+  }
+  zAssert( dzFreqResArray2Closed + dzFreqResArray2Open, result );
+  dzFreqResListDestroy( &list );
+  dzFreqResListDestroy( &list_closed );
+  dzFreqResArrayDestroy( &arr );
+}
+
+#define NUM_SCAN 10000
+
+void assert_freqres_scan(void)
+{
+  dzFreqResArray arr, arr_scan;
+  FILE *fp;
+  int i;
+  bool result = true;
+
+  dzFreqResArrayInit( &arr );
+  dzFreqResArrayInit( &arr_scan );
+  for( i=0; i<NUM_SCAN; i++ )
+    dzFreqResArrayAdd( &arr, 0.01*i, zRandF(-100,100), zRandF(-360,0) );
+  if( !( fp = tmpfile() ) ) return;
+  dzFreqResArrayFPrint( fp, &arr, 0, HUGE_VAL );
+  rewind( fp );
+  dzFreqResArrayFScan( fp, &arr_scan, 10, 50 );
+  fclose( fp );
+  if( dzFreqResArraySize(&arr_scan) != 4001 ) result = false;
+  for( i=0; i<dzFreqResArraySize(&arr_scan); i++ )
+    if( !zIsTol( arr_scan.f[i] - arr.f[i+1000], zTOL ) ||
+        !zIsTol( arr_scan.g[i] - arr.g[i+1000], 1.0e-8 ) ||
+        !zIsTol( arr_scan.p[i] - arr.p[i+1000], 1.0e-8 ) ) result = false;
+  zAssert( dzFreqResFScanStream, result );
+  dzFreqResArrayDestroy( &arr );
+  dzFreqResArrayDestroy( &arr_scan );
+}
+
 int main(int argc, char *argv[])
 {
   zRandInit();
   assert_zeropole();
   assert_connect();
+  assert_freqres_grid();
+  assert_freqres_array();
+  assert_freqres_scan();
   return 0;
 }